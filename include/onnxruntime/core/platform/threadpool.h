@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <functional>
@@ -51,6 +54,32 @@ class ThreadPool {
   */
   void ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn);
 
+  /*
+  Run fn(first, last) on blocks of the interval [0, total) in parallel, for loops where an iteration is too cheap to
+  be scheduled on its own. cost_per_unit is an estimate of the cost of an iteration in nanoseconds. It's used to pick
+  the number of threads and the block size, so a cheap loop runs on fewer threads or on the calling thread alone.
+  The calling thread runs blocks too, and the threads take the next block that hasn't been run once they finish a
+  block, so uneven blocks are balanced. Nothing is allocated per block or per iteration.
+  Runs on the calling thread if called from a thread of this pool.
+  */
+  template <typename F>
+  void ParallelFor(std::ptrdiff_t total, double cost_per_unit, const F& fn);
+
+  /*
+  ParallelFor with a cost per iteration that runs fn(0, total) on the calling thread if tp is nullptr.
+  */
+  template <typename F>
+  static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit, const F& fn) {
+    if (tp == nullptr) {
+      if (total > 0) {
+        fn(0, total);
+      }
+      return;
+    }
+
+    tp->ParallelFor(total, cost_per_unit, fn);
+  }
+
   // This is not supported until the latest Eigen
   // void SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions);
 
@@ -61,8 +90,49 @@ class ThreadPool {
   Eigen::ThreadPool& GetHandler() { return impl_; }
 
  private:
+  // Number of iterations per block for ParallelFor. Returns total if the loop should run on the calling thread.
+  std::ptrdiff_t ComputeBlockSize(std::ptrdiff_t total, double cost_per_unit) const;
+
+  // Run fn(context) on num_workers threads of the pool and on the calling thread, and wait for all of them.
+  void RunOnWorkers(int num_workers, void (*fn)(void*), void* context);
+
   Eigen::ThreadPool impl_;
 };
 
+template <typename F>
+void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit, const F& fn) {
+  if (total <= 0) {
+    return;
+  }
+
+  const std::ptrdiff_t block_size = ComputeBlockSize(total, cost_per_unit);
+  if (block_size >= total) {
+    fn(0, total);
+    return;
+  }
+
+  struct BlockState {
+    const F& fn;
+    std::ptrdiff_t total;
+    std::ptrdiff_t block_size;
+    std::ptrdiff_t num_blocks;
+    std::atomic<std::ptrdiff_t> next_block;
+  };
+
+  const std::ptrdiff_t num_blocks = (total + block_size - 1) / block_size;
+  BlockState state{fn, total, block_size, num_blocks, {0}};
+
+  const auto run_blocks = [](void* context) {
+    auto& s = *static_cast<BlockState*>(context);
+    for (std::ptrdiff_t block = s.next_block++; block < s.num_blocks; block = s.next_block++) {
+      const std::ptrdiff_t first = block * s.block_size;
+      s.fn(first, std::min(s.total, first + s.block_size));
+    }
+  };
+
+  const auto num_workers = static_cast<int>(std::min<std::ptrdiff_t>(num_blocks - 1, NumThreads()));
+  RunOnWorkers(num_workers, run_blocks, &state);
+}
+
 }  // namespace concurrency
 }  // namespace onnxruntime
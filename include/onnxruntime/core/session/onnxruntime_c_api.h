@@ -219,6 +219,18 @@ typedef struct OrtApiBase OrtApiBase;
 
 ORT_EXPORT const OrtApiBase* ORT_API_CALL OrtGetApiBase() NO_EXCEPTION;
 
+/**
+ * Callback of RunAsync that is invoked when the run completes.
+ * \param user_data The user_data that was passed to RunAsync.
+ * \param outputs The output values in the order of the output names, or nullptr if the run failed.
+ *   The array is only valid for the duration of the call. The values are owned by the callback and must be freed
+ *   with OrtReleaseValue.
+ * \param status nullptr if the run succeeded. Otherwise it's owned by the callback and must be freed with
+ *   OrtReleaseStatus.
+ */
+typedef void(ORT_API_CALL* OrtRunAsyncCallbackFn)(_In_opt_ void* user_data, _In_opt_ OrtValue** outputs,
+                                                  size_t num_outputs, _In_opt_ OrtStatus* status);
+
 struct OrtApi {
   /**
 * \param msg A null-terminated string. Its content will be copied into the newly created OrtStatus
@@ -645,6 +657,53 @@ struct OrtApi {
   ORT_CLASS_RELEASE(TensorTypeAndShapeInfo);
   ORT_CLASS_RELEASE(SessionOptions);
   ORT_CLASS_RELEASE(CustomOpDomain);
+
+  /**
+   * Run the model asynchronously on a thread pool owned by the session, and invoke callback on a thread of the pool
+   * when the run completes. Returns an error if the run couldn't be scheduled, in which case callback isn't invoked.
+   * The input values and run_options must stay valid until callback is invoked.
+   * Releasing the session waits for the pending runs to complete, so don't release it from the callback.
+   */
+  OrtStatus*(ORT_API_CALL* RunAsync)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                     _In_ const char* const* input_names, _In_ const OrtValue* const* input,
+                                     size_t input_len, _In_ const char* const* output_names, size_t output_names_len,
+                                     _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data)NO_EXCEPTION;
+
+  // Pack the constant weights of the CPU Gemm and MatMul kernels once when the session is initialized.
+  // The packed copy is kept next to the initializer, so disable this if memory is tight.
+  // Set this before OrtSessionOptionsAppendExecutionProvider_CPU for it to apply to that provider.
+  OrtStatus*(ORT_API_CALL* EnableCpuWeightPrepacking)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableCpuWeightPrepacking)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  /**
+   * Coalesce the concurrent RunBatched calls of a session into batches along axis 0 of the inputs.
+   * \param max_batch_size maximum number of rows in a batch. A call with more rows is run on its own.
+   * \param max_delay_us maximum time in microseconds a call waits for other calls to be batched with.
+   * \param num_threads number of batches that can run at the same time.
+   */
+  OrtStatus*(ORT_API_CALL* EnableRequestBatching)(_Inout_ OrtSessionOptions* options, int max_batch_size,
+                                                  int64_t max_delay_us, int num_threads)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableRequestBatching)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  /**
+   * Run the model as part of a batch of the concurrent RunBatched calls of the session, and block until the batch has
+   * run. Requires EnableRequestBatching. The inputs must be CPU tensors with the batch on axis 0. The outputs are
+   * always allocated by the session, so the elements of output must be null, and contain the rows of this call only.
+   */
+  OrtStatus*(ORT_API_CALL* RunBatched)(_Inout_ OrtSession* sess,
+                                       _In_ const char* const* input_names, _In_ const OrtValue* const* input,
+                                       size_t input_len, _In_ const char* const* output_names,
+                                       size_t output_names_len, _Outptr_ OrtValue** output)NO_EXCEPTION;
+
+  // Constant folding doesn't fold a node whose outputs take more than max_output_bytes, or whose output shapes
+  // aren't known statically, so the model doesn't grow by the size of the folded outputs. 0 means there is no limit.
+  OrtStatus*(ORT_API_CALL* SetMaxConstantFoldingOutputBytes)(_Inout_ OrtSessionOptions* options,
+                                                             size_t max_output_bytes)NO_EXCEPTION;
+
+  // Execute the nodes in an order that reduces the peak size of the intermediate values, instead of the default
+  // topological order. Only used with sequential execution.
+  OrtStatus*(ORT_API_CALL* EnableMemoryAwareNodeOrder)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableMemoryAwareNodeOrder)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
 };
 
 /*
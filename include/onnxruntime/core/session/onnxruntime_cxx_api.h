@@ -16,6 +16,7 @@
 #include "onnxruntime_c_api.h"
 #include <cstddef>
 #include <array>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -160,10 +161,17 @@ struct SessionOptions : Base<OrtSessionOptions> {
   SessionOptions& SetIntraOpNumThreads(int intra_op_num_threads);
   SessionOptions& SetInterOpNumThreads(int inter_op_num_threads);
   SessionOptions& SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level);
+  SessionOptions& SetMaxConstantFoldingOutputBytes(size_t max_output_bytes);
 
   SessionOptions& EnableCpuMemArena();
   SessionOptions& DisableCpuMemArena();
 
+  SessionOptions& EnableCpuWeightPrepacking();
+  SessionOptions& DisableCpuWeightPrepacking();
+
+  SessionOptions& EnableRequestBatching(int max_batch_size, int64_t max_delay_us, int num_threads);
+  SessionOptions& DisableRequestBatching();
+
   SessionOptions& SetOptimizedModelFilePath(const ORTCHAR_T* optimized_model_file);
 
   SessionOptions& EnableProfiling(const ORTCHAR_T* profile_file_prefix);
@@ -172,6 +180,9 @@ struct SessionOptions : Base<OrtSessionOptions> {
   SessionOptions& EnableMemPattern();
   SessionOptions& DisableMemPattern();
 
+  SessionOptions& EnableMemoryAwareNodeOrder();
+  SessionOptions& DisableMemoryAwareNodeOrder();
+
   SessionOptions& SetExecutionMode(ExecutionMode execution_mode);
 
   SessionOptions& SetLogId(const char* logid);
@@ -191,6 +202,18 @@ struct Session : Base<OrtSession> {
   void Run(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
            const char* const* output_names, Value* output_values, size_t output_count);
 
+  // Callback of RunAsync. error is nullptr if the run succeeded. Must not throw.
+  using RunAsyncCallback = std::function<void(std::vector<Value>&& output_values, const Exception* error)>;
+  // Run asynchronously on a thread pool owned by the session. callback is invoked on a thread of the pool when the
+  // run completes. run_options and the input values must stay valid until then.
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, size_t output_count, RunAsyncCallback callback);
+
+  // Run as part of a batch of the concurrent RunBatched calls of the session. Requires
+  // SessionOptions::EnableRequestBatching. The output values hold the rows of this call only.
+  std::vector<Value> RunBatched(const char* const* input_names, const Value* input_values, size_t input_count,
+                                const char* const* output_names, size_t output_count);
+
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
   size_t GetOverridableInitializerCount() const;
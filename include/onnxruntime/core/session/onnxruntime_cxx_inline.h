@@ -168,6 +168,11 @@ inline SessionOptions& SessionOptions::SetGraphOptimizationLevel(GraphOptimizati
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetMaxConstantFoldingOutputBytes(size_t max_output_bytes) {
+  ThrowOnError(Global<void>::api_.SetMaxConstantFoldingOutputBytes(p_, max_output_bytes));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetOptimizedModelFilePath(const ORTCHAR_T* optimized_model_filepath) {
   ThrowOnError(Global<void>::api_.SetOptimizedModelFilePath(p_, optimized_model_filepath));
   return *this;
@@ -193,6 +198,16 @@ inline SessionOptions& SessionOptions::DisableMemPattern() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableMemoryAwareNodeOrder() {
+  ThrowOnError(Global<void>::api_.EnableMemoryAwareNodeOrder(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableMemoryAwareNodeOrder() {
+  ThrowOnError(Global<void>::api_.DisableMemoryAwareNodeOrder(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableCpuMemArena() {
   ThrowOnError(Global<void>::api_.EnableCpuMemArena(p_));
   return *this;
@@ -203,6 +218,26 @@ inline SessionOptions& SessionOptions::DisableCpuMemArena() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::EnableCpuWeightPrepacking() {
+  ThrowOnError(Global<void>::api_.EnableCpuWeightPrepacking(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableCpuWeightPrepacking() {
+  ThrowOnError(Global<void>::api_.DisableCpuWeightPrepacking(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableRequestBatching(int max_batch_size, int64_t max_delay_us, int num_threads) {
+  ThrowOnError(Global<void>::api_.EnableRequestBatching(p_, max_batch_size, max_delay_us, num_threads));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableRequestBatching() {
+  ThrowOnError(Global<void>::api_.DisableRequestBatching(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetExecutionMode(ExecutionMode execution_mode) {
   ThrowOnError(Global<void>::api_.SetSessionExecutionMode(p_, execution_mode));
   return *this;
@@ -242,6 +277,49 @@ inline void Session::Run(const RunOptions& run_options, const char* const* input
   ThrowOnError(Global<void>::api_.Run(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
 }
 
+inline std::vector<Value> Session::RunBatched(const char* const* input_names, const Value* input_values, size_t input_count,
+                                              const char* const* output_names, size_t output_count) {
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < output_count; i++)
+    output_values.emplace_back(nullptr);
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values.data());
+  ThrowOnError(Global<void>::api_.RunBatched(p_, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
+  return output_values;
+}
+
+namespace detail {
+inline void ORT_API_CALL RunAsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatus* status) {
+  std::unique_ptr<Session::RunAsyncCallback> callback{static_cast<Session::RunAsyncCallback*>(user_data)};
+
+  std::vector<Value> output_values;
+  output_values.reserve(num_outputs);
+  for (size_t i = 0; i < num_outputs; i++)
+    output_values.emplace_back(outputs[i]);
+
+  if (status) {
+    Exception error{Global<void>::api_.GetErrorMessage(status), Global<void>::api_.GetErrorCode(status)};
+    Global<void>::api_.ReleaseStatus(status);
+    (*callback)(std::move(output_values), &error);
+  } else {
+    (*callback)(std::move(output_values), nullptr);
+  }
+}
+}  // namespace detail
+
+inline void Session::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                              const char* const* output_names, size_t output_count, RunAsyncCallback callback) {
+  auto ort_input_values = reinterpret_cast<const OrtValue**>(const_cast<Value*>(input_values));
+  // owned by detail::RunAsyncCallback once the run is scheduled
+  auto user_data = new RunAsyncCallback(std::move(callback));
+  OrtStatus* status = Global<void>::api_.RunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count,
+                                                  &detail::RunAsyncCallback, user_data);
+  if (status) {
+    delete user_data;
+    ThrowOnError(status);
+  }
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ThrowOnError(Global<void>::api_.SessionGetInputCount(p_, &out));
@@ -0,0 +1,223 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "attention.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      Attention,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCpuExecutionProvider,                                      \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      Attention<T>);
+
+REGISTER_KERNEL_TYPED(float)
+
+// value added to the scores of the tokens masked out by a raw mask, as done by BERT models
+constexpr float kMaskFilterValue = -10000.f;
+
+// Softmax of each row of the SxS scores of a head in place, masked by either mask_index, where only the first
+// mask_index scores of each row take part and the others get a probability of 0, or by a row of a raw mask,
+// where (1 - mask) * -10000 is added to the scores first.
+static void ComputeMaskedSoftmax(float* scores, int sequence_length, const int32_t* mask_index,
+                                 const float* mask_filter) {
+  const size_t row_count = static_cast<size_t>(sequence_length);
+  if (mask_filter != nullptr) {
+    for (size_t s = 0; s < row_count; ++s) {
+      float* row = scores + s * row_count;
+      for (size_t i = 0; i < row_count; ++i) {
+        row[i] += mask_filter[i];
+      }
+    }
+    MlasComputeSoftmax(scores, scores, row_count, row_count, nullptr);
+    return;
+  }
+
+  const int num_valid = std::max(0, std::min(sequence_length, static_cast<int>(*mask_index)));
+  if (num_valid == sequence_length) {
+    MlasComputeSoftmax(scores, scores, row_count, row_count, nullptr);
+    return;
+  }
+
+  for (size_t s = 0; s < row_count; ++s) {
+    float* row = scores + s * row_count;
+    if (num_valid > 0) {
+      MlasComputeSoftmax(row, row, 1, static_cast<size_t>(num_valid), nullptr);
+    }
+    std::fill(row + num_valid, row + row_count, 0.f);
+  }
+}
+
+template <typename T>
+Attention<T>::Attention(const OpKernelInfo& info) : OpKernel(info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+  num_heads_ = static_cast<int>(num_heads);
+}
+
+template <typename T>
+Status Attention<T>::Compute(OpKernelContext* context) const {
+  // Input and output shapes:
+  //   Input 0 - input       : (batch_size, sequence_length, hidden_size)
+  //   Input 1 - weights     : (hidden_size, 3 * hidden_size)
+  //   Input 2 - bias        : (3 * hidden_size)
+  //   Input 3 - mask_index  : (batch_size) or (batch_size, sequence_length)
+  //   Output                : (batch_size, sequence_length, hidden_size)
+
+  const Tensor* input = context->Input<Tensor>(0);
+  const auto dims = input->Shape().GetDims();
+  if (dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 is expected to have 3 dimensions, got ", dims.size());
+  }
+  const int batch_size = static_cast<int>(dims[0]);
+  const int sequence_length = static_cast<int>(dims[1]);
+  const int hidden_size = static_cast<int>(dims[2]);
+  if (hidden_size % num_heads_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 dimension 2 should be divisiable by value of the num_heads attribute.");
+  }
+  const int head_size = hidden_size / num_heads_;
+
+  const Tensor* weights = context->Input<Tensor>(1);
+  const auto weights_dims = weights->Shape().GetDims();
+  if (weights_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 is expected to have 2 dimensions, got ", weights_dims.size());
+  }
+  if (weights_dims[0] != dims[2]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 dimension 0 should have same length as dimension 2 of input 0");
+  }
+  if (weights_dims[1] != 3 * weights_dims[0]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 dimension 1 should be 3 times of dimension 0");
+  }
+
+  const Tensor* bias = context->Input<Tensor>(2);
+  const auto bias_dims = bias->Shape().GetDims();
+  if (bias_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 2 is expected to have 1 dimension, got ", bias_dims.size());
+  }
+  if (bias_dims[0] != weights_dims[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 2 dimension 0 should have same length as dimension 1 of input 1");
+  }
+
+  const Tensor* mask_index = context->Input<Tensor>(3);
+  const auto mask_dims = mask_index->Shape().GetDims();
+  if (mask_dims.size() != 1 && mask_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 3 is expected to have 1 or 2 dimensions, got ", mask_dims.size());
+  }
+  if (static_cast<int>(mask_dims[0]) != batch_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 3 and 0 shall have same length at dimension 0");
+  }
+  const bool is_raw_mask = mask_dims.size() == 2;
+  if (is_raw_mask && static_cast<int>(mask_dims[1]) != sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 3 and 0 shall have same length at dimension 1");
+  }
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (input->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+
+  // Compute the packed Q, K and V of each token with a single GEMM. Each row of qkv holds Q, K and V of a token,
+  // each of which holds the head_size values of each head, i.e. the layout is BxSx3xNxH.
+  const size_t m = static_cast<size_t>(batch_size) * sequence_length;
+  const size_t n = 3 * static_cast<size_t>(hidden_size);
+  const size_t k = static_cast<size_t>(hidden_size);
+  auto qkv_data = allocator->Alloc(sizeof(T) * m * n);
+  BufferUniquePtr qkv_buffer(qkv_data, BufferDeleter(allocator));
+  T* qkv = static_cast<T*>(qkv_data);
+
+  const T* bias_data = bias->template Data<T>();
+  for (size_t i = 0; i < m; ++i) {
+    std::copy(bias_data, bias_data + n, qkv + i * n);
+  }
+
+  MlasGemm(CblasNoTrans, CblasNoTrans, m, n, k, 1.f, input->template Data<T>(), k,
+           weights->template Data<T>(), n, 1.f, qkv, n, tp);
+
+  // Compute the context of each head of each batch: softmax(Q x K' / sqrt(head_size), masked) x V.
+  // The heads are independent so run them in parallel.
+  const int32_t* mask_index_data = mask_index->template Data<int32_t>();
+  T* output_data = output->template MutableData<T>();
+  const float scale = 1.f / std::sqrt(static_cast<float>(head_size));
+  const size_t qkv_stride = n;
+  const size_t output_stride = static_cast<size_t>(hidden_size);
+  const double cost_per_head = 2.0 * sequence_length * sequence_length * head_size;
+
+  // scores of each head: BxNxSxS. allocated up front as the allocator may throw.
+  const size_t scores_size = static_cast<size_t>(sequence_length) * sequence_length;
+  auto scores_data = allocator->Alloc(sizeof(T) * batch_size * num_heads_ * scores_size);
+  BufferUniquePtr scores_buffer(scores_data, BufferDeleter(allocator));
+
+  // the values a raw mask adds to the scores of each batch, shared by the heads
+  BufferUniquePtr mask_filter_buffer;
+  float* mask_filter = nullptr;
+  if (is_raw_mask) {
+    const size_t mask_size = static_cast<size_t>(batch_size) * sequence_length;
+    mask_filter = static_cast<float*>(allocator->Alloc(sizeof(float) * mask_size));
+    mask_filter_buffer = BufferUniquePtr(mask_filter, BufferDeleter(allocator));
+    for (size_t i = 0; i < mask_size; ++i) {
+      mask_filter[i] = (1.f - static_cast<float>(mask_index_data[i])) * kMaskFilterValue;
+    }
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size) * num_heads_, cost_per_head,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          T* scores = static_cast<T*>(scores_data) + i * scores_size;
+          const int batch = static_cast<int>(i / num_heads_);
+          const int head = static_cast<int>(i % num_heads_);
+          const T* q = qkv + static_cast<size_t>(batch) * sequence_length * qkv_stride +
+                       static_cast<size_t>(head) * head_size;
+          const T* k_data = q + hidden_size;
+          const T* v = q + 2 * hidden_size;
+
+          MlasGemm(CblasNoTrans, CblasTrans, sequence_length, sequence_length, head_size, scale,
+                   q, qkv_stride, k_data, qkv_stride, 0.f, scores, sequence_length, nullptr);
+
+          if (is_raw_mask) {
+            ComputeMaskedSoftmax(scores, sequence_length, nullptr,
+                                 mask_filter + static_cast<size_t>(batch) * sequence_length);
+          } else {
+            ComputeMaskedSoftmax(scores, sequence_length, mask_index_data + batch, nullptr);
+          }
+
+          // the context of the head is written to its columns of the output, so the output is BxSxNxH
+          T* context_data = output_data + static_cast<size_t>(batch) * sequence_length * output_stride +
+                            static_cast<size_t>(head) * head_size;
+          MlasGemm(CblasNoTrans, CblasNoTrans, sequence_length, head_size, sequence_length, 1.f,
+                   scores, sequence_length, v, qkv_stride, 0.f, context_data, output_stride, nullptr);
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
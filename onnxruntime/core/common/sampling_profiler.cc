@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/sampling_profiler.h"
+
+#include <algorithm>
+#include <map>
+
+namespace onnxruntime {
+namespace profiling {
+
+// nearest-rank percentile of sorted values
+static int64_t Percentile(const std::vector<int64_t>& sorted_values, size_t percent) {
+  size_t rank = (sorted_values.size() * percent + 99) / 100;
+  return sorted_values[rank == 0 ? 0 : rank - 1];
+}
+
+SamplingProfiler::SamplingProfiler(uint64_t sample_interval, size_t buffer_size)
+    : sample_interval_(sample_interval) {
+  ORT_ENFORCE(sample_interval > 0, "Sample interval must be greater than 0.");
+  ORT_ENFORCE(buffer_size > 0, "Buffer size must be greater than 0.");
+
+  size_t capacity = 1;
+  while (capacity < buffer_size) {
+    capacity <<= 1;
+  }
+
+  mask_ = capacity - 1;
+  slots_.reset(new Slot[capacity]);
+}
+
+void SamplingProfiler::EndTimeAndRecordOp(const std::string& op_type, const TimePoint& start_time) {
+  auto duration = std::chrono::high_resolution_clock::now() - start_time;
+  RecordOp(op_type, std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+void SamplingProfiler::RecordOp(const std::string& op_type, int64_t duration_us) {
+  const uint64_t index = next_slot_.fetch_add(1);
+  Slot& slot = slots_[index & mask_];
+
+  // if the buffer wraps around while a slot is being written, two writers may race on it. each value is still
+  // valid on its own so a reader sees at worst a sample with the op type of one writer and the time of the other.
+  slot.sequence.store(kWriting);
+  slot.op_type.store(&op_type);
+  slot.duration_us.store(duration_us);
+  slot.sequence.store(index + 1);
+}
+
+std::vector<OpLatencyStats> SamplingProfiler::GetOpLatencyStats() const {
+  std::map<std::string, std::vector<int64_t>> samples_by_op;
+  for (size_t i = 0; i <= mask_; ++i) {
+    const Slot& slot = slots_[i];
+    const uint64_t sequence = slot.sequence.load();
+    if (sequence == 0 || sequence == kWriting) {
+      continue;
+    }
+
+    const std::string* op_type = slot.op_type.load();
+    const int64_t duration_us = slot.duration_us.load();
+    if (slot.sequence.load() != sequence) {
+      continue;
+    }
+
+    samples_by_op[*op_type].push_back(duration_us);
+  }
+
+  std::vector<OpLatencyStats> stats;
+  stats.reserve(samples_by_op.size());
+  for (auto& entry : samples_by_op) {
+    auto& durations = entry.second;
+    std::sort(durations.begin(), durations.end());
+
+    OpLatencyStats op_stats;
+    op_stats.op_type = entry.first;
+    op_stats.num_samples = durations.size();
+    op_stats.p50_us = Percentile(durations, 50);
+    op_stats.p99_us = Percentile(durations, 99);
+    op_stats.max_us = durations.back();
+    stats.push_back(std::move(op_stats));
+  }
+
+  return stats;
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
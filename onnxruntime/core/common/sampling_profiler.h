@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+namespace profiling {
+
+// latency of an op type over the samples in the buffer of a SamplingProfiler.
+struct OpLatencyStats {
+  std::string op_type;
+  size_t num_samples{0};
+  int64_t p50_us{0};
+  int64_t p99_us{0};
+  int64_t max_us{0};
+};
+
+/**
+ * Low overhead profiler that can be left enabled in production. Only 1 in sample_interval runs of a graph are
+ * profiled, and the kernel times of their nodes are written to a fixed size ring buffer without taking a lock, so
+ * the memory used doesn't grow and the latency statistics cover the most recent samples.
+ * The statistics can be queried while the session is running.
+ */
+class SamplingProfiler {
+ public:
+  /**
+   * \param sample_interval Profile 1 in sample_interval runs. Must be > 0.
+   * \param buffer_size Number of samples kept. Rounded up to a power of 2.
+   */
+  SamplingProfiler(uint64_t sample_interval, size_t buffer_size);
+
+  // Returns true if the run with the given index should be profiled.
+  bool ShouldSample(uint64_t run_index) const {
+    return run_index % sample_interval_ == 0;
+  }
+
+  /*
+  Record the kernel time of a node, measured from start_time till the call of this function.
+  op_type must remain valid for the lifetime of the profiler, e.g. Node::OpType() of a node in the session's graph.
+  */
+  void EndTimeAndRecordOp(const std::string& op_type, const TimePoint& start_time);
+
+  /*
+  Record a kernel time in microseconds.
+  */
+  void RecordOp(const std::string& op_type, int64_t duration_us);
+
+  /*
+  Compute the latency statistics of each op type from the samples currently in the buffer, ordered by op type.
+  Samples that are being overwritten while the statistics are computed are skipped.
+  */
+  std::vector<OpLatencyStats> GetOpLatencyStats() const;
+
+  // Total number of samples recorded, including the ones that were overwritten.
+  uint64_t NumSamplesRecorded() const { return next_slot_.load(); }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SamplingProfiler);
+
+  // sequence is 0 until the slot is first written, kWriting while it's being written, and the index of the sample + 1
+  // once written. a reader checks that it's unchanged after reading the slot.
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<const std::string*> op_type{nullptr};
+    std::atomic<int64_t> duration_us{0};
+  };
+
+  static constexpr uint64_t kWriting = ~uint64_t{0};
+
+  const uint64_t sample_interval_;
+  size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> next_slot_{0};
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
 
+#include <algorithm>
 #include <cassert>
 
 #if defined(__GNUC__)
@@ -80,6 +81,62 @@ void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<voi
   barrier.Wait();
 }
 
+namespace {
+// minimum cost in nanoseconds of the iterations run by a thread to make scheduling it worthwhile
+constexpr double kMinCostPerThread = 10000;
+// minimum cost in nanoseconds of a block, so threads don't contend on taking the next block
+constexpr double kMinCostPerBlock = 2000;
+// blocks per thread, so threads that finish early can take blocks from slower ones
+constexpr std::ptrdiff_t kBlocksPerThread = 4;
+}  // namespace
+
+std::ptrdiff_t ThreadPool::ComputeBlockSize(std::ptrdiff_t total, double cost_per_unit) const {
+  // nested calls from the threads of this pool run on the calling thread, as waiting for the other threads could
+  // deadlock if they are all waiting too
+  if (CurrentThreadId() != -1) {
+    return total;
+  }
+
+  const double total_cost = static_cast<double>(total) * std::max(cost_per_unit, 0.0);
+  const std::ptrdiff_t max_threads = NumThreads() + 1;
+  const auto num_threads = static_cast<std::ptrdiff_t>(
+      std::min(static_cast<double>(max_threads), total_cost / kMinCostPerThread));
+  if (num_threads <= 1) {
+    return total;
+  }
+
+  const std::ptrdiff_t num_blocks = num_threads * kBlocksPerThread;
+  std::ptrdiff_t block_size = (total + num_blocks - 1) / num_blocks;
+  if (cost_per_unit > 0) {
+    block_size = std::max(block_size, static_cast<std::ptrdiff_t>(kMinCostPerBlock / cost_per_unit));
+  }
+
+  return std::max<std::ptrdiff_t>(block_size, 1);
+}
+
+void ThreadPool::RunOnWorkers(int num_workers, void (*fn)(void*), void* context) {
+  struct WorkerState {
+    void (*fn)(void*);
+    void* context;
+    Barrier* barrier;
+  };
+
+  Barrier barrier(static_cast<unsigned int>(num_workers));
+  WorkerState state{fn, context, &barrier};
+  WorkerState* state_ptr = &state;
+
+  // the task only captures a pointer so the std::function doesn't allocate
+  for (int i = 0; i < num_workers; ++i) {
+    impl_.Schedule([state_ptr]() {
+      state_ptr->fn(state_ptr->context);
+      state_ptr->barrier->Notify();
+    });
+  }
+
+  fn(context);
+  barrier.Wait();
+}
+
 // void ThreadPool::SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions) {
 //   impl_->SetStealPartitions(partitions);
 // }
@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/framework/allocation_planner.h"
+#include <functional>
+#include <limits>
 #include <list>
+#include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <sstream>
 #include "core/common/exceptions.h"
@@ -100,6 +104,57 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
   return out;
 }
 
+// Rough relative cost of running a node, used to find the critical path for parallel execution.
+static int64_t EstimateNodeCost(const Node& node) {
+  static const std::unordered_map<std::string, int64_t> op_costs = {
+      // control flow and recurrent ops run a subgraph or a sequence of GEMMs
+      {"If", 50},
+      {"Loop", 50},
+      {"Scan", 50},
+      {"LSTM", 50},
+      {"GRU", 50},
+      {"RNN", 30},
+      // GEMM based ops
+      {"Conv", 20},
+      {"ConvTranspose", 20},
+      {"ConvInteger", 20},
+      {"QLinearConv", 20},
+      {"FusedConv", 20},
+      {"NchwcConv", 20},
+      {"MatMul", 15},
+      {"MatMulInteger", 15},
+      {"QLinearMatMul", 15},
+      {"Gemm", 15},
+      {"FusedGemm", 15},
+      // ops that read the whole input more than once
+      {"AveragePool", 4},
+      {"MaxPool", 4},
+      {"GlobalAveragePool", 3},
+      {"GlobalMaxPool", 3},
+      {"LRN", 4},
+      {"BatchNormalization", 3},
+      {"InstanceNormalization", 3},
+      {"LayerNormalization", 3},
+      {"Softmax", 3},
+      {"LogSoftmax", 3},
+      {"TopK", 3},
+      // ops that only update metadata or copy a small amount of data
+      {"Shape", 1},
+      {"Size", 1},
+      {"Reshape", 1},
+      {"Flatten", 1},
+      {"Squeeze", 1},
+      {"Unsqueeze", 1},
+      {"Identity", 1},
+      {"Constant", 1},
+      {"ConstantOfShape", 1},
+  };
+
+  auto entry = op_costs.find(node.OpType());
+  // default to the cost of an element-wise op
+  return entry != op_costs.cend() ? entry->second : 2;
+}
+
 class PlannerImpl {
  public:
   PlannerImpl(const Node* parent_node, const onnxruntime::GraphViewer& graph_viewer,
@@ -674,6 +729,213 @@ class PlannerImpl {
       plan_.execution_plan[prev_dealloc_point].free_to_index = current - 1;
   }
 
+  // Compute the cost of the longest path from each node to the end of the graph.
+  void ComputeCriticalPathCosts() {
+    plan_.node_critical_path_cost.assign(graph_viewer_.MaxNodeIndex(), 0);
+
+    // visit the nodes in reverse topological order so all the consumers of a node are done before it
+    for (auto it = plan_.execution_plan.rbegin(), end = plan_.execution_plan.rend(); it != end; ++it) {
+      const auto* pnode = graph_viewer_.GetNode(it->node_index);
+      if (pnode == nullptr) continue;
+
+      int64_t max_consumer_cost = 0;
+      for (auto consumer = pnode->OutputNodesBegin(), consumer_end = pnode->OutputNodesEnd();
+           consumer != consumer_end; ++consumer) {
+        max_consumer_cost = std::max(max_consumer_cost, plan_.node_critical_path_cost[consumer->Index()]);
+      }
+
+      plan_.node_critical_path_cost[it->node_index] = EstimateNodeCost(*pnode) + max_consumer_cost;
+    }
+  }
+
+  // Estimate the size of the buffer of a value to compare the memory used by different execution orders.
+  // Symbolic dimensions are counted as 1, and values with an unknown shape as 0.
+  size_t EstimateBufferSize(const onnxruntime::NodeArg& arg) const {
+    const auto* shape = arg.Exists() && !IsNonTensor(arg) ? context_.GetShape(arg) : nullptr;
+    if (shape == nullptr) return 0;
+
+    size_t size = GetElementSize(arg.Type());
+    for (const auto& dim : shape->dim()) {
+      if (utils::HasDimValue(dim) && dim.dim_value() > 0) {
+        size *= static_cast<size_t>(dim.dim_value());
+      }
+    }
+    return size;
+  }
+
+  // Choose an execution order that keeps the peak size of the values produced by the nodes low.
+  // The order is exact for graphs with up to kMaxNodesForExactOrder nodes. Larger graphs greedily run the ready node
+  // that increases the size of the live values the least, breaking ties with the default topological order.
+  std::vector<NodeIndex> ComputeMemoryAwareOrder(const std::vector<NodeIndex>& topological_order) const {
+    static constexpr size_t kMaxNodesForExactOrder = 16;
+
+    struct ValueInfo {
+      size_t size;
+      bool is_graph_output;
+      std::vector<size_t> consumers;  // positions of the consuming nodes in topological_order
+    };
+
+    const size_t num_nodes = topological_order.size();
+    std::unordered_map<NodeIndex, size_t> position;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      position[topological_order[i]] = i;
+    }
+
+    std::unordered_set<const NodeArg*> graph_outputs(graph_viewer_.GetOutputs().cbegin(),
+                                                     graph_viewer_.GetOutputs().cend());
+    std::vector<ValueInfo> values;
+    std::unordered_map<std::string, size_t> value_ids;
+    std::vector<std::vector<size_t>> node_outputs(num_nodes);
+    std::vector<std::vector<size_t>> node_inputs(num_nodes);
+    std::vector<std::vector<size_t>> node_consumers(num_nodes);
+    std::vector<size_t> num_producers(num_nodes, 0);
+
+    for (size_t i = 0; i < num_nodes; ++i) {
+      const Node& node = *graph_viewer_.GetNode(topological_order[i]);
+      for (const auto* output : node.OutputDefs()) {
+        if (!output->Exists()) continue;
+        value_ids[output->Name()] = values.size();
+        node_outputs[i].push_back(values.size());
+        values.push_back({EstimateBufferSize(*output), graph_outputs.count(output) != 0, {}});
+      }
+
+      auto add_input = [&](const NodeArg* input) {
+        auto entry = value_ids.find(input->Name());
+        if (entry != value_ids.end() && (values[entry->second].consumers.empty() ||
+                                         values[entry->second].consumers.back() != i)) {
+          values[entry->second].consumers.push_back(i);
+          node_inputs[i].push_back(entry->second);
+        }
+      };
+      std::for_each(node.InputDefs().cbegin(), node.InputDefs().cend(), add_input);
+      std::for_each(node.ImplicitInputDefs().cbegin(), node.ImplicitInputDefs().cend(), add_input);
+
+      for (auto input_node = node.InputNodesBegin(), end = node.InputNodesEnd(); input_node != end; ++input_node) {
+        auto producer = position.find(input_node->Index());
+        if (producer != position.end()) {
+          node_consumers[producer->second].push_back(i);
+          ++num_producers[i];
+        }
+      }
+    }
+
+    // a value is freed after its last consumer runs unless it is a graph output
+    auto is_freed_by = [&values](size_t value_id, const std::function<bool(size_t)>& is_done) {
+      const ValueInfo& value = values[value_id];
+      return !value.is_graph_output &&
+             std::all_of(value.consumers.cbegin(), value.consumers.cend(), is_done);
+    };
+
+    std::vector<NodeIndex> order;
+    order.reserve(num_nodes);
+
+    if (num_nodes <= kMaxNodesForExactOrder) {
+      // dynamic programming over the sets of executed nodes. the live values only depend on the set.
+      const uint32_t num_sets = 1u << num_nodes;
+      std::vector<size_t> producers_mask(num_nodes, 0);
+      for (size_t i = 0; i < num_nodes; ++i) {
+        for (size_t consumer : node_consumers[i]) {
+          producers_mask[consumer] |= 1u << i;
+        }
+      }
+
+      std::vector<size_t> live_size(num_sets, 0);
+      for (uint32_t set = 0; set < num_sets; ++set) {
+        auto is_done = [set](size_t i) { return (set & (1u << i)) != 0; };
+        for (size_t i = 0; i < num_nodes; ++i) {
+          if (!is_done(i)) continue;
+          for (size_t value_id : node_outputs[i]) {
+            if (!is_freed_by(value_id, is_done)) live_size[set] += values[value_id].size;
+          }
+        }
+      }
+
+      const size_t unreachable = std::numeric_limits<size_t>::max();
+      std::vector<size_t> peak(num_sets, unreachable);
+      std::vector<uint8_t> last_node(num_sets, 0);
+      peak[0] = 0;
+      for (uint32_t set = 1; set < num_sets; ++set) {
+        for (size_t i = 0; i < num_nodes; ++i) {
+          uint32_t previous = set & ~(1u << i);
+          if (previous == set || peak[previous] == unreachable || (producers_mask[i] & ~previous) != 0) continue;
+
+          // the inputs of the node are live while it allocates its outputs
+          size_t running_size = live_size[previous];
+          for (size_t value_id : node_outputs[i]) running_size += values[value_id].size;
+
+          size_t set_peak = std::max(peak[previous], running_size);
+          if (set_peak < peak[set]) {
+            peak[set] = set_peak;
+            last_node[set] = static_cast<uint8_t>(i);
+          }
+        }
+      }
+
+      for (uint32_t set = num_sets - 1; set != 0; set &= ~(1u << last_node[set])) {
+        order.push_back(topological_order[last_node[set]]);
+      }
+      std::reverse(order.begin(), order.end());
+      return order;
+    }
+
+    std::vector<bool> done(num_nodes, false);
+    auto is_done = [&done](size_t i) { return static_cast<bool>(done[i]); };
+
+    // the change in the size of the live values after running a node
+    auto size_delta = [&](size_t i) {
+      int64_t delta = 0;
+      for (size_t value_id : node_outputs[i]) {
+        if (values[value_id].is_graph_output || !values[value_id].consumers.empty()) {
+          delta += static_cast<int64_t>(values[value_id].size);
+        }
+      }
+      for (size_t value_id : node_inputs[i]) {
+        const ValueInfo& value = values[value_id];
+        if (!value.is_graph_output && std::all_of(value.consumers.cbegin(), value.consumers.cend(),
+                                                  [&](size_t consumer) { return consumer == i || done[consumer]; })) {
+          delta -= static_cast<int64_t>(value.size);
+        }
+      }
+      return delta;
+    };
+
+    std::set<std::pair<int64_t, size_t>> ready;
+    std::vector<int64_t> ready_delta(num_nodes, 0);
+    auto add_ready = [&](size_t i) {
+      ready_delta[i] = size_delta(i);
+      ready.emplace(ready_delta[i], i);
+    };
+
+    for (size_t i = 0; i < num_nodes; ++i) {
+      if (num_producers[i] == 0) add_ready(i);
+    }
+
+    while (!ready.empty()) {
+      size_t i = ready.begin()->second;
+      ready.erase(ready.begin());
+      done[i] = true;
+      order.push_back(topological_order[i]);
+
+      // running the node may leave a single consumer of its inputs, which would free them
+      for (size_t value_id : node_inputs[i]) {
+        if (is_freed_by(value_id, is_done)) continue;
+        for (size_t consumer : values[value_id].consumers) {
+          auto entry = ready.find({ready_delta[consumer], consumer});
+          if (!done[consumer] && entry != ready.end()) {
+            ready.erase(entry);
+            add_ready(consumer);
+          }
+        }
+      }
+
+      for (size_t consumer : node_consumers[i]) {
+        if (--num_producers[consumer] == 0) add_ready(consumer);
+      }
+    }
+
+    return order;
+  }
+
   static bool IsNonTensor(const onnxruntime::NodeArg& nodearg) {
     // TODO: unclear why we should go through a string-representation of type
     auto ptype = nodearg.Type();
@@ -689,10 +951,16 @@ Status PlannerImpl::CreatePlan() {
 
   Initialize(p_graph_nodes.size(), static_cast<size_t>(num_ml_values));
 
-  // Determine execution order: we use the default topological sort order for now. We can later
-  // explore more efficient orderings (from a memory usage perspective).
-  for (auto n : p_graph_nodes) {
-    plan_.execution_plan.emplace_back(n);
+  // Determine execution order: we use the default topological sort order unless the memory aware order is enabled.
+  // the parallel executor doesn't follow the execution order, so it isn't reordered.
+  if (context_.IsMemoryAwareNodeOrderEnabled() && !context_.IsParallelExecutionEnabled()) {
+    for (auto n : ComputeMemoryAwareOrder(p_graph_nodes)) {
+      plan_.execution_plan.emplace_back(n);
+    }
+  } else {
+    for (auto n : p_graph_nodes) {
+      plan_.execution_plan.emplace_back(n);
+    }
   }
 
   // compute use counts for all ml-values
@@ -707,6 +975,11 @@ Status PlannerImpl::CreatePlan() {
   // convert information in the freelist_ into a deallocation plan in required format
   GenerateDeallocationPlan();
 
+  // nodes on the longest remaining path are prioritized when multiple nodes can run in parallel
+  if (context_.IsParallelExecutionEnabled()) {
+    ComputeCriticalPathCosts();
+  }
+
   return Status::OK();
 }
 
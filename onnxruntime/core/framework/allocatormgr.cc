@@ -22,8 +22,14 @@ using namespace ::onnxruntime::common;
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id) {
   auto device_allocator = std::unique_ptr<IDeviceAllocator>(info.factory(device_id));
   if (device_allocator->AllowsArena()) {
+#ifdef USE_MIMALLOC
     return std::shared_ptr<IArenaAllocator>(
           onnxruntime::make_unique<TArenaAllocator>(std::move(device_allocator), info.max_mem));
+#else
+    return std::shared_ptr<IArenaAllocator>(
+          onnxruntime::make_unique<TArenaAllocator>(std::move(device_allocator), info.max_mem,
+                                                    info.arena_thread_cache_config));
+#endif
   }
 
   return AllocatorPtr(std::move(device_allocator));
@@ -14,6 +14,8 @@ struct DeviceAllocatorRegistrationInfo {
   OrtMemType mem_type;
   DeviceAllocatorFactory factory;
   size_t max_mem;
+  // Thread cache configuration for the arena created for the device allocator, if any.
+  ArenaThreadCacheConfig arena_thread_cache_config{};
 };
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0);
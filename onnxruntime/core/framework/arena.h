@@ -4,6 +4,7 @@
 #pragma once
 
 #include <string>
+#include <thread>
 
 #include "core/common/common.h"
 #include "core/framework/allocator.h"
@@ -87,6 +88,11 @@ struct AllocatorStats {
                                   // unknown.
   int64_t bytes_limit;
 
+  // Per-thread cache statistics, summed over all threads. Only set by an arena with a thread cache enabled.
+  int64_t num_thread_cache_hits;    // Allocations served from a free chunk in a thread cache.
+  int64_t num_thread_cache_misses;  // Allocations that had to refill a thread cache from the arena.
+  int64_t thread_cache_bytes;       // Bytes of free chunks held by thread caches. Not included in bytes_in_use.
+
   AllocatorStats() { Clear(); }
 
   void Clear() {
@@ -96,6 +102,9 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_thread_cache_hits = 0;
+    this->num_thread_cache_misses = 0;
+    this->thread_cache_bytes = 0;
   }
 
   std::string DebugString() const {
@@ -105,8 +114,37 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "CacheHits:      " << this->num_thread_cache_hits << "\n"
+       << "CacheMisses:    " << this->num_thread_cache_misses << "\n"
+       << "CacheBytes:     " << this->thread_cache_bytes << "\n";
     return ss.str();
   }
 };
+
+// Statistics of the cache of a single thread in an arena with a thread cache enabled.
+struct ThreadCacheStats {
+  std::thread::id thread_id;  // The thread that last used the cache.
+  int64_t num_allocs = 0;
+  int64_t num_hits = 0;
+  int64_t num_misses = 0;
+  int64_t num_flushes = 0;  // Number of times a batch of free chunks was returned to the arena.
+  int64_t cached_bytes = 0;
+};
+
+// Configuration of an optional per-thread cache of small free chunks in front of an arena.
+// Allocations and frees of small buffers on the same thread are served from the cache without taking the
+// arena lock. The cache refills from, and returns to, the arena in batches.
+struct ArenaThreadCacheConfig {
+  bool enable = false;
+
+  // Allocations larger than this always go to the arena.
+  size_t max_cached_size = 64 * 1024;
+
+  // Maximum bytes of free chunks a thread keeps before returning some to the arena.
+  size_t max_bytes_per_thread = 4 * 1024 * 1024;
+
+  // Number of chunks moved between a thread cache and the arena at a time.
+  size_t batch_size = 8;
+};
 }  // namespace onnxruntime
@@ -4,12 +4,51 @@
 #include "core/framework/bfc_arena.h"
 
 namespace onnxruntime {
+
+// Free chunks of a single thread, grouped by size class.
+// The mutex is only contended when another thread frees a chunk that was allocated from this cache, when the
+// statistics are read, or when the cache is adopted by a new thread.
+struct BFCArena::ThreadCache {
+  explicit ThreadCache(BFCArena* owner) : arena(owner), free_lists(owner->size_classes_.size()) {}
+
+  OrtMutex mutex;
+
+  // set to nullptr when the arena is destroyed
+  BFCArena* arena;
+  std::thread::id thread_id;
+
+  struct CachedChunk {
+    void* ptr;
+    // the chunk can be larger than its size class as the arena doesn't always split a chunk
+    size_t size;
+  };
+
+  // free chunks by size class. the most recently freed chunk is at the back.
+  std::vector<std::vector<CachedChunk>> free_lists;
+  // chunks handed out from the cache and their size class
+  std::unordered_map<const void*, std::pair<size_t, CachedChunk>> in_use;
+  size_t cached_bytes = 0;
+
+  int64_t num_allocs = 0;
+  int64_t num_hits = 0;
+  int64_t num_misses = 0;
+  int64_t num_flushes = 0;
+};
+
+static uint64_t NextArenaId() {
+  static std::atomic<uint64_t> next_id{0};
+  return next_id++;
+}
+
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
+                   size_t total_memory,
+                   const ArenaThreadCacheConfig& thread_cache_config)
     : device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
-      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
+      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type),
+      thread_cache_config_(thread_cache_config),
+      arena_id_(NextArenaId()) {
   curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
 
   // Allocate the requested amount of memory.
@@ -32,9 +71,39 @@ BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_config_.enable) {
+    ORT_ENFORCE(thread_cache_config_.batch_size > 0, "Thread cache batch size must be positive");
+
+    // like tcmalloc, use 4 size classes for each power of 2 so a chunk is at most 25% larger than needed
+    size_t size = kMinAllocationSize;
+    while (true) {
+      size_classes_.push_back(size);
+      if (size >= thread_cache_config_.max_cached_size) {
+        break;
+      }
+
+      size_t step = kMinAllocationSize;
+      if (size > 4 * kMinAllocationSize) {
+        step = size_t{1} << Log2FloorNonZero(size);
+        step /= 4;
+      }
+
+      size += step;
+    }
+  }
 }
 
 BFCArena::~BFCArena() {
+  // the chunks held by thread caches are released with the regions. threads may still have a reference to their
+  // cache so let them know the arena is gone.
+  for (auto& cache : thread_caches_) {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    cache->arena = nullptr;
+    cache->free_lists.clear();
+    cache->in_use.clear();
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -172,9 +241,201 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_config_.enable && size > 0 && size <= thread_cache_config_.max_cached_size) {
+    return AllocateFromThreadCache(size);
+  }
+
   return AllocateRawInternal(size, false);
 }
 
+size_t BFCArena::SizeClassIndex(size_t num_bytes) const {
+  auto it = std::lower_bound(size_classes_.cbegin(), size_classes_.cend(), num_bytes);
+  ORT_ENFORCE(it != size_classes_.cend(), "No size class for ", num_bytes, " bytes");
+  return static_cast<size_t>(it - size_classes_.cbegin());
+}
+
+BFCArena::ThreadCache* BFCArena::GetThreadCache(bool create) {
+  // caches of the current thread keyed by arena id. an entry is left behind when an arena is destroyed, so
+  // entries for destroyed arenas are removed when a new entry is added.
+  thread_local std::unordered_map<uint64_t, std::shared_ptr<ThreadCache>> thread_caches;
+
+  auto entry = thread_caches.find(arena_id_);
+  if (entry != thread_caches.end()) {
+    return entry->second.get();
+  }
+
+  if (!create) {
+    return nullptr;
+  }
+
+  for (auto it = thread_caches.begin(); it != thread_caches.end();) {
+    bool arena_destroyed;
+    {
+      std::lock_guard<OrtMutex> cache_lock(it->second->mutex);
+      arena_destroyed = it->second->arena == nullptr;
+    }
+
+    it = arena_destroyed ? thread_caches.erase(it) : std::next(it);
+  }
+
+  std::shared_ptr<ThreadCache> cache;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    // adopt the cache of a thread that has exited. only the arena holds a reference to such a cache, and no other
+    // thread can take a new reference without holding lock_.
+    auto orphan = std::find_if(thread_caches_.cbegin(), thread_caches_.cend(),
+                               [](const std::shared_ptr<ThreadCache>& c) { return c.use_count() == 1; });
+    if (orphan != thread_caches_.cend()) {
+      cache = *orphan;
+    } else {
+      cache = std::make_shared<ThreadCache>(this);
+      thread_caches_.push_back(cache);
+    }
+  }
+
+  {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    cache->thread_id = std::this_thread::get_id();
+  }
+
+  thread_caches.emplace(arena_id_, cache);
+  return cache.get();
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t num_bytes) {
+  ThreadCache* cache = GetThreadCache(true);
+  const size_t size_class = SizeClassIndex(num_bytes);
+  const size_t class_bytes = size_classes_[size_class];
+
+  {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    auto& free_list = cache->free_lists[size_class];
+    if (!free_list.empty()) {
+      auto chunk = free_list.back();
+      free_list.pop_back();
+      cache->cached_bytes -= chunk.size;
+      cache->in_use.emplace(chunk.ptr, std::make_pair(size_class, chunk));
+      ++cache->num_allocs;
+      ++cache->num_hits;
+      return chunk.ptr;
+    }
+  }
+
+  // refill the cache with a batch of chunks of the size class. the cache can hold up to max_bytes_per_thread
+  // of free chunks, so don't take more than that.
+  size_t num_chunks = std::min(thread_cache_config_.batch_size,
+                               std::max<size_t>(1, thread_cache_config_.max_bytes_per_thread / class_bytes));
+  std::vector<ThreadCache::CachedChunk> chunks;
+  chunks.reserve(num_chunks);
+  {
+    BinNum bin_num = BinNumForSize(class_bytes);
+
+    std::lock_guard<OrtMutex> lock(lock_);
+    for (size_t i = 0; i < num_chunks; ++i) {
+      void* ptr = FindChunkPtr(bin_num, class_bytes, class_bytes);
+      if (ptr == nullptr && Extend(class_bytes)) {
+        ptr = FindChunkPtr(bin_num, class_bytes, class_bytes);
+      }
+
+      if (ptr == nullptr) {
+        break;
+      }
+
+      Chunk* c = ChunkFromHandle(region_manager_.get_handle(ptr));
+      c->thread_cache = cache;
+      // num_allocs counts the allocations made by the caller, which are added from the cache stats
+      --stats_.num_allocs;
+      chunks.push_back({ptr, c->size});
+    }
+  }
+
+  if (chunks.empty()) {
+    return nullptr;
+  }
+
+  auto chunk = chunks.back();
+  chunks.pop_back();
+
+  std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+  auto& free_list = cache->free_lists[size_class];
+  for (const auto& cached_chunk : chunks) {
+    free_list.push_back(cached_chunk);
+    cache->cached_bytes += cached_chunk.size;
+  }
+
+  cache->in_use.emplace(chunk.ptr, std::make_pair(size_class, chunk));
+  ++cache->num_allocs;
+  ++cache->num_misses;
+
+  return chunk.ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* ptr) {
+  ThreadCache* cache = GetThreadCache(false);
+  if (cache == nullptr) {
+    return false;
+  }
+
+  std::vector<void*> chunks_to_return;
+  {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    auto entry = cache->in_use.find(ptr);
+    if (entry == cache->in_use.end()) {
+      return false;
+    }
+
+    const size_t size_class = entry->second.first;
+    const auto chunk = entry->second.second;
+    cache->in_use.erase(entry);
+    cache->free_lists[size_class].push_back(chunk);
+    cache->cached_bytes += chunk.size;
+
+    if (cache->cached_bytes > thread_cache_config_.max_bytes_per_thread) {
+      // return at least a batch of the least recently freed chunks and get back under the limit, starting with
+      // the size class that was just freed and moving on to the largest classes.
+      auto need_more = [&]() {
+        return chunks_to_return.size() < thread_cache_config_.batch_size ||
+               cache->cached_bytes > thread_cache_config_.max_bytes_per_thread;
+      };
+
+      auto take_chunks = [&](size_t idx) {
+        auto& free_list = cache->free_lists[idx];
+        size_t count = 0;
+        while (count < free_list.size() && need_more()) {
+          const auto& chunk = free_list[count++];
+          chunks_to_return.push_back(chunk.ptr);
+          cache->cached_bytes -= chunk.size;
+        }
+
+        free_list.erase(free_list.begin(), free_list.begin() + count);
+      };
+
+      take_chunks(size_class);
+      for (size_t idx = size_classes_.size(); idx > 0 && need_more(); --idx) {
+        take_chunks(idx - 1);
+      }
+
+      ++cache->num_flushes;
+    }
+  }
+
+  if (!chunks_to_return.empty()) {
+    ReturnThreadCacheChunks(chunks_to_return);
+  }
+
+  return true;
+}
+
+void BFCArena::ReturnThreadCacheChunks(const std::vector<void*>& ptrs) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* ptr : ptrs) {
+    BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
+    ORT_ENFORCE(h != kInvalidChunkHandle);
+    ChunkFromHandle(h)->thread_cache = nullptr;
+    FreeAndMaybeCoalesce(h);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -248,8 +509,43 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 }
 
 void BFCArena::GetStats(AllocatorStats* stats) {
-  std::lock_guard<OrtMutex> lock(lock_);
-  *stats = stats_;
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    *stats = stats_;
+    thread_caches = thread_caches_;
+  }
+
+  for (const auto& cache : thread_caches) {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    stats->num_allocs += cache->num_allocs;
+    stats->num_thread_cache_hits += cache->num_hits;
+    stats->num_thread_cache_misses += cache->num_misses;
+    stats->thread_cache_bytes += cache->cached_bytes;
+  }
+
+  stats->bytes_in_use -= stats->thread_cache_bytes;
+}
+
+void BFCArena::GetThreadCacheStats(std::vector<ThreadCacheStats>* stats) {
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    thread_caches = thread_caches_;
+  }
+
+  stats->clear();
+  for (const auto& cache : thread_caches) {
+    std::lock_guard<OrtMutex> cache_lock(cache->mutex);
+    ThreadCacheStats cache_stats;
+    cache_stats.thread_id = cache->thread_id;
+    cache_stats.num_allocs = cache->num_allocs;
+    cache_stats.num_hits = cache->num_hits;
+    cache_stats.num_misses = cache->num_misses;
+    cache_stats.num_flushes = cache->num_flushes;
+    cache_stats.cached_bytes = static_cast<int64_t>(cache->cached_bytes);
+    stats->push_back(cache_stats);
+  }
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -340,16 +636,41 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
-  std::lock_guard<OrtMutex> lock(lock_);
-  auto it = reserved_chunks_.find(p);
-  if (it != reserved_chunks_.end()) {
-    device_allocator_->Free(it->first);
-    stats_.bytes_in_use -= it->second;
-    stats_.total_allocated_bytes -= it->second;
-    reserved_chunks_.erase(it);
-  } else {
-    DeallocateRawInternal(p);
+
+  if (thread_cache_config_.enable && FreeToThreadCache(p)) {
+    return;
+  }
+
+  ThreadCache* owner = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = reserved_chunks_.find(p);
+    if (it != reserved_chunks_.end()) {
+      device_allocator_->Free(it->first);
+      stats_.bytes_in_use -= it->second;
+      stats_.total_allocated_bytes -= it->second;
+      reserved_chunks_.erase(it);
+      return;
+    }
+
+    BFCArena::ChunkHandle h = region_manager_.get_handle(p);
+    ORT_ENFORCE(h != kInvalidChunkHandle);
+    owner = ChunkFromHandle(h)->thread_cache;
+    if (owner == nullptr) {
+      DeallocateRawInternal(p);
+      return;
+    }
   }
+
+  // the chunk was allocated from the cache of another thread. the cache can't give the chunk back to the arena
+  // while it's in use so it's safe to update the cache after releasing lock_, which must not be held when
+  // locking a cache.
+  {
+    std::lock_guard<OrtMutex> cache_lock(owner->mutex);
+    ORT_ENFORCE(owner->in_use.erase(p) == 1, "Chunk was not allocated from the thread cache that holds it");
+  }
+
+  ReturnThreadCacheChunks({p});
 }
 
 void BFCArena::DeallocateRawInternal(void* ptr) {
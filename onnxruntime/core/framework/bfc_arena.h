@@ -16,9 +16,12 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -46,9 +49,13 @@ namespace onnxruntime {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// Optionally each thread can keep a cache of small free chunks, grouped
+// into size classes, in front of the arena. See ArenaThreadCacheConfig.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory,
+           const ArenaThreadCacheConfig& thread_cache_config = {});
 
   ~BFCArena() override;
 
@@ -81,6 +88,10 @@ class BFCArena : public IArenaAllocator {
 
   void GetStats(AllocatorStats* stats);
 
+  // Get the statistics of each thread cache. Empty if the thread cache is not enabled.
+  void GetThreadCacheStats(std::vector<ThreadCacheStats>* stats);
+
+  // For a chunk allocated from a thread cache this is the size of its size class.
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
@@ -89,6 +100,22 @@ class BFCArena : public IArenaAllocator {
   void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
   void DeallocateRawInternal(void* ptr);
 
+  struct ThreadCache;
+
+  // Get the cache of the calling thread, creating it if it doesn't exist and 'create' is true.
+  ThreadCache* GetThreadCache(bool create);
+
+  void* AllocateFromThreadCache(size_t num_bytes);
+
+  // Returns false if ptr wasn't allocated from the cache of the calling thread.
+  bool FreeToThreadCache(void* ptr);
+
+  // Return chunks owned by a thread cache to the arena.
+  void ReturnThreadCacheChunks(const std::vector<void*>& ptrs);
+
+  // Index of the smallest size class that fits num_bytes.
+  size_t SizeClassIndex(size_t num_bytes) const;
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -132,6 +159,10 @@ class BFCArena : public IArenaAllocator {
     // What bin are we in?
     BinNum bin_num = kInvalidBinNum;
 
+    // The thread cache holding the chunk, if any. The chunk is in use from
+    // the point of view of the arena while it's held by a thread cache.
+    ThreadCache* thread_cache = nullptr;
+
     bool in_use() const { return allocation_id != -1; }
 
     std::string DebugString(BFCArena* a, bool recurse) {
@@ -441,6 +472,15 @@ class BFCArena : public IArenaAllocator {
 
   std::unordered_map<void*, size_t> reserved_chunks_;
 
+  const ArenaThreadCacheConfig thread_cache_config_;
+  // Sizes of the size classes of the thread caches in increasing order.
+  std::vector<size_t> size_classes_;
+  // Unique id of the arena, used to find the cache of a thread for the arena.
+  const uint64_t arena_id_;
+  // All thread caches, including those whose threads have exited. Protected by lock_.
+  // A cache whose thread has exited is adopted by the next thread that needs a cache.
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
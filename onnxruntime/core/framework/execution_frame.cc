@@ -165,6 +165,23 @@ bool IExecutionFrame::IsOutput(int ort_value_idx) const {
   return std::find(fetch_mlvalue_idxs_.begin(), fetch_mlvalue_idxs_.end(), ort_value_idx) != fetch_mlvalue_idxs_.end();
 }
 
+void IExecutionFrame::ResetValues(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                                  const std::unordered_map<int, OrtValue>& initializers,
+                                  const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches) {
+  ORT_ENFORCE(feeds.size() == feed_mlvalue_idxs.size());
+  ORT_ENFORCE(fetches.empty() || fetches.size() == fetch_mlvalue_idxs.size());
+
+  // assignment re-uses the existing capacity
+  fetch_mlvalue_idxs_ = fetch_mlvalue_idxs;
+  Init(feed_mlvalue_idxs, feeds, initializers, fetches);
+}
+
+void IExecutionFrame::ClearValues() {
+  for (auto& value : all_values_) {
+    value = OrtValue();
+  }
+}
+
 ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
                                const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
@@ -172,8 +189,30 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
     : IExecutionFrame(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetch_mlvalue_idxs, fetches,
                       session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo()),
       session_state_(session_state),
-      mem_patterns_(nullptr),
       planner_(nullptr) {
+  InitCustomAllocators(fetch_mlvalue_idxs, fetch_allocators);
+
+  bool trace_patterns = false;
+  auto mem_patterns = FindMemoryPatterns(feeds, session_state, trace_patterns);
+  InitMemoryPatterns(std::move(mem_patterns), trace_patterns);
+}
+
+ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                               const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                               const SessionState& session_state,
+                               std::shared_ptr<const MemoryPatternGroup> mem_patterns, bool trace_patterns)
+    : IExecutionFrame(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetch_mlvalue_idxs, fetches,
+                      session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo()),
+      session_state_(session_state),
+      planner_(nullptr) {
+  InitCustomAllocators(fetch_mlvalue_idxs, fetch_allocators);
+  InitMemoryPatterns(std::move(mem_patterns), trace_patterns);
+}
+
+void ExecutionFrame::InitCustomAllocators(
+    const std::vector<int>& fetch_mlvalue_idxs,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
   // map the custom allocators to ort_value_idx entries
   if (!fetch_allocators.empty()) {
     for (size_t idx = 0, end = fetch_mlvalue_idxs.size(); idx < end; ++idx) {
@@ -185,48 +224,76 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
       }
     }
   }
+}
+
+std::shared_ptr<const MemoryPatternGroup> ExecutionFrame::FindMemoryPatterns(const std::vector<OrtValue>& feeds,
+                                                                             const SessionState& session_state,
+                                                                             bool& trace_patterns) {
+  trace_patterns = false;
 
   // If the session enable memory pattern optimization
   // and we have execution plan generated, try to setup
   // memory pattern optimization.
-  if (session_state.GetEnableMemoryPattern() && session_state.GetExecutionPlan()) {
-    std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
-    bool all_tensors = true;
-    // Reserve mem to avoid re-allocation.
-    input_shapes.reserve(feeds.size());
-    for (const auto& feed : feeds) {
-      if (!(feed.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-      auto& tensor = feed.Get<Tensor>();
-      input_shapes.push_back(std::cref(tensor.Shape()));
-    }
+  if (!session_state.GetEnableMemoryPattern() || !session_state.GetExecutionPlan()) {
+    return nullptr;
+  }
 
+  std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
+  // Reserve mem to avoid re-allocation.
+  input_shapes.reserve(feeds.size());
+  for (const auto& feed : feeds) {
     //if there are some traditional ml value type in inputs disable the memory pattern optimization.
-    if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
-      // if no existing patterns, generate one in this executionframe
-      if (!mem_patterns_) {
-        planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
-      } else {
-        // pre-allocate the big chunk requested in memory pattern.
-        // all the internal kernel's input/output tensors will be allocated on these buffer.
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
-          AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
-          void* buffer = mem_patterns_->patterns[i].PeakSize() > 0
-                             ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize())
-                             : nullptr;
-          buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
-        }
-      }
+    if (!(feed.IsTensor())) {
+      return nullptr;
+    }
+    auto& tensor = feed.Get<Tensor>();
+    input_shapes.push_back(std::cref(tensor.Shape()));
+  }
+
+  auto mem_patterns = session_state.GetMemoryPatternGroup(input_shapes);
+  // if no existing patterns, generate one in this executionframe
+  trace_patterns = mem_patterns == nullptr;
+  return mem_patterns;
+}
+
+void ExecutionFrame::InitMemoryPatterns(std::shared_ptr<const MemoryPatternGroup> mem_patterns, bool trace_patterns) {
+  mem_patterns_ = std::move(mem_patterns);
+  const auto& cache_options = session_state_.GetMemoryPatternCacheOptions();
+  mem_patterns_bucketed_ = cache_options.enable_shape_bucketing;
+
+  if (trace_patterns) {
+    planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state_.GetExecutionPlan(),
+                                                                cache_options.enable_offset_packing);
+  } else if (mem_patterns_) {
+    // pre-allocate the big chunk requested in memory pattern.
+    // all the internal kernel's input/output tensors will be allocated on these buffer.
+    for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+      ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
+      AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
+      void* buffer = mem_patterns_->patterns[i].PeakSize() > 0
+                         ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize())
+                         : nullptr;
+      buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
     }
   }
 }
 
 ExecutionFrame::~ExecutionFrame() = default;
 
+void ExecutionFrame::Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                           const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  ORT_ENFORCE(IsReusable(), "Frame that traced or invalidated a memory pattern cannot be reused.");
+
+  ResetValues(feed_mlvalue_idxs, feeds, session_state_.GetInitializedTensors(), fetch_mlvalue_idxs, fetches);
+  InitCustomAllocators(fetch_mlvalue_idxs, fetch_allocators);
+}
+
+void ExecutionFrame::Clear() {
+  ClearValues();
+  custom_allocators_.clear();
+}
+
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(OrtValue& ort_value, int ort_value_index,
                                                           MLDataType element_type, const OrtMemoryInfo& location,
                                                           const TensorShape& shape, bool create_fence) {
@@ -273,14 +340,21 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        bool block_fits = mem_patterns_bucketed_ ? block->size_ >= size : block->size_ == size;
+        if (it != buffers_.end() && block_fits) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
               shape);
           return status;
         }
-        if (block->size_ != size) {
+        if (!block_fits) {
+          if (mem_patterns_bucketed_ && !mem_patterns_invalidated_) {
+            // this run is larger than the one the bucket's pattern was generated from
+            session_state_.InvalidateMemoryPatternGroup(mem_patterns_.get());
+            mem_patterns_invalidated_ = true;
+          }
+
           // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
           // fed in, so use VERBOSE as the log level as it's expected.
           // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "core/common/common.h"
@@ -69,6 +70,14 @@ class IExecutionFrame {
   // returns true if the ort_value_idx is an output from the graph
   bool IsOutput(int ort_value_idx) const;
 
+  // re-initialize the values for another execution. the values must have been cleared with ClearValues first.
+  void ResetValues(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                   const std::unordered_map<int, OrtValue>& initializers, const std::vector<int>& fetch_mlvalue_idxs,
+                   const std::vector<OrtValue>& fetches);
+
+  // release all values without shrinking the storage for them
+  void ClearValues();
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
 
@@ -94,7 +103,7 @@ class IExecutionFrame {
   // perf optimization to avoid calling all_values_.size() repeatedly as the size is fixed once constructed
   const size_t all_values_size_;
 
-  const std::vector<int> fetch_mlvalue_idxs_;
+  std::vector<int> fetch_mlvalue_idxs_;
 };
 
 class ExecutionFrame final : public IExecutionFrame {
@@ -105,8 +114,40 @@ class ExecutionFrame final : public IExecutionFrame {
                  const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                  const SessionState& session_state);
 
+  // Create a frame using the memory pattern returned by FindMemoryPatterns.
+  ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                 const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                 const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                 const SessionState& session_state,
+                 std::shared_ptr<const MemoryPatternGroup> mem_patterns, bool trace_patterns);
+
   ~ExecutionFrame() override;
 
+  // Look up the cached memory pattern for the feeds.
+  // trace_patterns is set if the memory pattern optimization applies to the feeds but there is no pattern for them
+  // yet, in which case the frame should trace the allocations to generate one.
+  static std::shared_ptr<const MemoryPatternGroup> FindMemoryPatterns(const std::vector<OrtValue>& feeds,
+                                                                      const SessionState& session_state,
+                                                                      bool& trace_patterns);
+
+  // Prepare a frame that was cleared with Clear for another execution using the same memory pattern.
+  // The storage for the values and the memory pattern buffers are reused, so the frame state isn't reallocated.
+  void Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+             const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  // Release all values held by the frame after an execution.
+  void Clear();
+
+  // The frame can be reset and used again if it didn't trace a new memory pattern and its memory pattern is current.
+  bool IsReusable() const {
+    return planner_ == nullptr && !mem_patterns_invalidated_;
+  }
+
+  const MemoryPatternGroup* GetMemoryPatterns() const {
+    return mem_patterns_.get();
+  }
+
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
   // Fix the unit tests so they set an execution plan that results in these methods being called by
   // GetOrCreateNodeOutputMLValue instead
@@ -147,6 +188,11 @@ class ExecutionFrame final : public IExecutionFrame {
 
   const AllocPlanPerValue& GetAllocationPlan(int ort_value_idx);
 
+  void InitCustomAllocators(const std::vector<int>& fetch_mlvalue_idxs,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  void InitMemoryPatterns(std::shared_ptr<const MemoryPatternGroup> mem_patterns, bool trace_patterns);
+
   const SessionState& session_state_;
 
   // map of index to custom allocator
@@ -155,7 +201,12 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
+
+  // The memory pattern was looked up using bucketed input shapes, so a block can be larger than the tensor
+  // placed in it. If a block is too small the pattern is invalidated so the next run in the bucket regenerates it.
+  bool mem_patterns_bucketed_{false};
+  bool mem_patterns_invalidated_{false};
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
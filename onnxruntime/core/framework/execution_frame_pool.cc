@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/execution_frame_pool.h"
+
+#include <algorithm>
+
+#include "core/framework/execution_frame.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+void ExecutionFramePool::FrameReleaser::operator()(ExecutionFrame* frame) const {
+  if (pool) {
+    pool->Release(std::unique_ptr<ExecutionFrame>(frame));
+  } else {
+    delete frame;
+  }
+}
+
+ExecutionFramePool::ExecutionFramePool(size_t max_idle_frames) : max_idle_frames_(max_idle_frames) {}
+
+ExecutionFramePool::~ExecutionFramePool() = default;
+
+ExecutionFramePool::FramePtr ExecutionFramePool::Acquire(
+    const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+    const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+    const SessionState& session_state) {
+  bool trace_patterns = false;
+  auto mem_patterns = ExecutionFrame::FindMemoryPatterns(feeds, session_state, trace_patterns);
+
+  if (!IsEnabled()) {
+    return FramePtr(new ExecutionFrame(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators,
+                                       session_state, std::move(mem_patterns), trace_patterns),
+                    FrameReleaser{nullptr});
+  }
+
+  // a frame that traces a new memory pattern has no buffers to re-use so always create a new one
+  if (!trace_patterns) {
+    std::unique_ptr<ExecutionFrame> frame;
+    {
+      std::lock_guard<OrtMutex> lock(lock_);
+      // search from the back to prefer the most recently released frame
+      auto it = std::find_if(idle_frames_.rbegin(), idle_frames_.rend(),
+                             [&mem_patterns](const std::unique_ptr<ExecutionFrame>& idle_frame) {
+                               return idle_frame->GetMemoryPatterns() == mem_patterns.get();
+                             });
+      if (it != idle_frames_.rend()) {
+        frame = std::move(*it);
+        idle_frames_.erase(std::next(it).base());
+      }
+    }
+
+    if (frame) {
+      frame->Reset(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators);
+      return FramePtr(frame.release(), FrameReleaser{this});
+    }
+  }
+
+  return FramePtr(new ExecutionFrame(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators,
+                                     session_state, std::move(mem_patterns), trace_patterns),
+                  FrameReleaser{this});
+}
+
+void ExecutionFramePool::Release(std::unique_ptr<ExecutionFrame> frame) {
+  if (!frame->IsReusable()) {
+    return;
+  }
+
+  // release the values outside of the lock as that may free tensors
+  frame->Clear();
+
+  std::unique_ptr<ExecutionFrame> evicted;
+  std::lock_guard<OrtMutex> lock(lock_);
+  if (idle_frames_.size() >= max_idle_frames_) {
+    // drop the least recently used frame. it's likely to hold the buffers of a memory pattern that is no longer used.
+    evicted = std::move(idle_frames_.front());
+    idle_frames_.erase(idle_frames_.begin());
+  }
+
+  idle_frames_.push_back(std::move(frame));
+}
+
+size_t ExecutionFramePool::NumIdleFrames() const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  return idle_frames_.size();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/iexecutor.h"
+#include "core/framework/ml_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class ExecutionFrame;
+class SessionState;
+
+// Pool of ExecutionFrame instances that are re-used across executions of a graph.
+// Idle frames are keyed by the memory pattern they were created with, so a frame that is checked out for a run with
+// the same memory pattern already has its OrtValue storage and memory pattern buffers allocated.
+// Thread-safe.
+class ExecutionFramePool {
+ public:
+  // Returns a frame to the pool it was acquired from, or deletes it if there is no pool.
+  struct FrameReleaser {
+    ExecutionFramePool* pool{nullptr};
+    void operator()(ExecutionFrame* frame) const;
+  };
+
+  using FramePtr = std::unique_ptr<ExecutionFrame, FrameReleaser>;
+
+  // max_idle_frames is the maximum number of idle frames to keep. 0 disables pooling.
+  explicit ExecutionFramePool(size_t max_idle_frames = 0);
+
+  ~ExecutionFramePool();
+
+  bool IsEnabled() const { return max_idle_frames_ > 0; }
+
+  // Get a frame for executing the graph of session_state with the feeds and fetches.
+  FramePtr Acquire(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                   const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                   const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                   const SessionState& session_state);
+
+  size_t NumIdleFrames() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFramePool);
+
+  void Release(std::unique_ptr<ExecutionFrame> frame);
+
+  const size_t max_idle_frames_;
+
+  mutable OrtMutex lock_;
+  // least recently released frame first
+  std::vector<std::unique_ptr<ExecutionFrame>> idle_frames_;
+};
+
+}  // namespace onnxruntime
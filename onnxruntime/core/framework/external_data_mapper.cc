@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/external_data_mapper.h"
+
+#include "core/framework/data_types.h"
+#include "core/framework/endian_utils.h"
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
+
+namespace onnxruntime {
+
+bool ExternalDataMapper::CanMap(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  // the data is stored in little-endian byte order, so it can only be used in place on little-endian platforms
+  return tensor_proto.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL &&
+         tensor_proto.data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING &&
+         endian::native == endian::little;
+}
+
+std::shared_ptr<ExternalDataMapper::MappedFile> ExternalDataMapper::GetMappedFile(
+    const std::basic_string<ORTCHAR_T>& file_path) {
+  auto entry = mapped_files_.find(file_path);
+  if (entry != mapped_files_.end()) {
+    return entry->second;
+  }
+
+  std::shared_ptr<MappedFile> mapped_file;
+  size_t length = 0;
+  Env::MappedMemoryPtr data;
+  // not all platforms support mapping files, in which case the data is copied as usual
+  if (env_.GetFileLength(file_path.c_str(), length).IsOK() && length > 0 &&
+      env_.MapFileIntoMemory(file_path.c_str(), 0, length, data).IsOK()) {
+    mapped_file = std::make_shared<MappedFile>(MappedFile{std::move(data), length});
+  }
+
+  mapped_files_.emplace(file_path, mapped_file);
+  return mapped_file;
+}
+
+static void ReleaseMappedFile(void* param) noexcept {
+  delete reinterpret_cast<std::shared_ptr<const void>*>(param);
+}
+
+Status ExternalDataMapper::CreateTensor(const ORTCHAR_T* tensor_proto_path,
+                                        const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                        const OrtMemoryInfo& location, OrtValue& value, OrtCallback& deleter,
+                                        bool& mapped) {
+  mapped = false;
+  deleter.f = nullptr;
+  deleter.param = nullptr;
+
+  if (!CanMap(tensor_proto)) {
+    return Status::OK();
+  }
+
+  std::basic_string<ORTCHAR_T> file_path;
+  FileOffsetType offset;
+  size_t length;
+  ORT_RETURN_IF_ERROR(utils::GetExternalDataLocation(tensor_proto_path, tensor_proto, file_path, offset, length));
+
+  auto mapped_file = GetMappedFile(file_path);
+  if (!mapped_file || offset < 0 || static_cast<size_t>(offset) > mapped_file->length) {
+    return Status::OK();
+  }
+
+  if (length == 0) {
+    length = mapped_file->length - static_cast<size_t>(offset);
+  }
+
+  // leave any inconsistency in the size of the data to be reported by the regular loading code
+  size_t expected_length;
+  ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &expected_length));
+  if (length != expected_length || length > mapped_file->length - static_cast<size_t>(offset)) {
+    return Status::OK();
+  }
+
+  const auto* element_type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  char* data = mapped_file->data.get() + offset;
+  if (reinterpret_cast<uintptr_t>(data) % element_type->Size() != 0) {
+    return Status::OK();
+  }
+
+  TensorShape shape{std::vector<int64_t>(tensor_proto.dims().cbegin(), tensor_proto.dims().cend())};
+  auto tensor = onnxruntime::make_unique<Tensor>(element_type, shape, data, location);
+  value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+
+  // the tensor doesn't own the data, so hold a reference to the mapping until the deleter is called
+  deleter.f = ReleaseMappedFile;
+  deleter.param = new std::shared_ptr<const void>(std::move(mapped_file));
+  mapped = true;
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
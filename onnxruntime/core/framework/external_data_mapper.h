@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/callback.h"
+#include "core/framework/ml_value.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+// Creates CPU tensors that use the external data of initializers in place by memory mapping the external data files.
+// Each file is mapped once, and stays mapped until all the tensors created from it are released.
+class ExternalDataMapper {
+ public:
+  explicit ExternalDataMapper(const Env& env) : env_(env) {}
+
+  // Returns true if the data of tensor_proto is in an external file in a format that can be used in place.
+  static bool CanMap(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
+  /**
+   * Create a tensor that points to the external data of tensor_proto in the mapped file.
+   * \param tensor_proto_path See utils::TensorProtoToMLValue.
+   * \param location The memory info of the created tensor. Must be CPU accessible.
+   * \param[out] deleter Keeps the file mapped. Must be called once the tensor is released.
+   * \param[out] mapped Set to false if the data can't be used in place, in which case value isn't set. This happens
+   *                    when the file can't be mapped or the data isn't aligned to the size of the element type.
+   */
+  common::Status CreateTensor(const ORTCHAR_T* tensor_proto_path, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                              const OrtMemoryInfo& location, OrtValue& value, OrtCallback& deleter, bool& mapped);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExternalDataMapper);
+
+  struct MappedFile {
+    Env::MappedMemoryPtr data;
+    size_t length;
+  };
+
+  // Get the mapping of the file, or nullptr if it can't be mapped.
+  std::shared_ptr<MappedFile> GetMappedFile(const std::basic_string<ORTCHAR_T>& file_path);
+
+  const Env& env_;
+  // mapped files by path. nullptr if mapping the file failed.
+  std::unordered_map<std::basic_string<ORTCHAR_T>, std::shared_ptr<MappedFile>> mapped_files_;
+};
+
+}  // namespace onnxruntime
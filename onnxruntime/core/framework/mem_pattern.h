@@ -22,11 +22,13 @@ class MemoryPattern {
 
   MemoryPattern(MemoryPattern&& rhs) noexcept
       : patterns_{std::move(rhs.patterns_)},
-        peak_size_{std::move(rhs.peak_size_)} {}
+        peak_size_{std::move(rhs.peak_size_)},
+        lower_bound_size_{std::move(rhs.lower_bound_size_)} {}
 
   MemoryPattern& operator=(MemoryPattern&& rhs) noexcept {
     patterns_ = std::move(rhs.patterns_);
     peak_size_ = std::move(rhs.peak_size_);
+    lower_bound_size_ = std::move(rhs.lower_bound_size_);
     return *this;
   }
 
@@ -34,6 +36,12 @@ class MemoryPattern {
     return peak_size_;
   }
 
+  // the maximum of the bytes allocated at the same time. the peak size can't be smaller than this, so the
+  // difference is the space lost to fragmentation.
+  size_t LowerBoundSize() const {
+    return lower_bound_size_;
+  }
+
   const MemoryBlock* GetBlock(int ml_value_idx) const {
     auto it = patterns_.find(ml_value_idx);
     if (it == patterns_.end())
@@ -48,6 +56,7 @@ class MemoryPattern {
 
   std::unordered_map<int, MemoryBlock> patterns_;
   size_t peak_size_{0};
+  size_t lower_bound_size_{0};
 };
 
 struct MemoryPatternGroup {
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace onnxruntime {
+
+static size_t TotalPeakSize(const MemoryPatternGroup& mem_patterns) {
+  size_t total = 0;
+  for (const auto& pattern : mem_patterns.patterns) {
+    total += pattern.PeakSize();
+  }
+  return total;
+}
+
+static size_t TotalLowerBoundSize(const MemoryPatternGroup& mem_patterns) {
+  size_t total = 0;
+  for (const auto& pattern : mem_patterns.patterns) {
+    total += pattern.LowerBoundSize();
+  }
+  return total;
+}
+
+int64_t MemoryPatternCache::BucketDim(int64_t dim) {
+  if (dim <= 1) {
+    return dim;
+  }
+
+  int64_t bucket = 1;
+  while (bucket < dim && bucket <= std::numeric_limits<int64_t>::max() / 2) {
+    bucket <<= 1;
+  }
+
+  return std::max(bucket, dim);
+}
+
+MemoryPatternCache::Key MemoryPatternCache::CreateKey(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
+  Key key;
+  for (const auto& shape : input_shapes) {
+    const auto& dims = shape.get().GetDims();
+    const auto rank = static_cast<int64_t>(dims.size());
+
+    // include the rank so inputs with the same dims but different ranks get different keys
+    key.push_back(rank);
+    auto start = key.size();
+    key.insert(key.end(), dims.cbegin(), dims.cend());
+
+    if (options_.enable_shape_bucketing) {
+      if (options_.bucket_axes.empty()) {
+        std::transform(key.begin() + start, key.end(), key.begin() + start, BucketDim);
+      } else {
+        for (auto axis : options_.bucket_axes) {
+          if (axis < 0) {
+            axis += rank;
+          }
+
+          if (axis >= 0 && axis < rank) {
+            key[start + axis] = BucketDim(key[start + axis]);
+          }
+        }
+      }
+    }
+  }
+
+  return key;
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Get(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) {
+  auto key = CreateKey(input_shapes);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto it = index_.find(key);
+  if (it == index_.end() || it->second->stale) {
+    ++stats_.misses;
+    return nullptr;
+  }
+
+  ++stats_.hits;
+  entries_.splice(entries_.begin(), entries_, it->second);
+
+  return it->second->mem_patterns;
+}
+
+void MemoryPatternCache::Update(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
+                                std::unique_ptr<MemoryPatternGroup> mem_patterns) {
+  auto key = CreateKey(input_shapes);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // another run may have generated a pattern for the same key concurrently. keep the existing one unless it was
+    // marked stale, in which case keep the larger of the two so a bucket converges on the largest run seen.
+    auto& entry = *it->second;
+    if (entry.stale) {
+      if (TotalPeakSize(*mem_patterns) >= TotalPeakSize(*entry.mem_patterns)) {
+        entry.mem_patterns = std::move(mem_patterns);
+      }
+
+      entry.stale = false;
+    }
+
+    return;
+  }
+
+  entries_.push_front(Entry{key, std::move(mem_patterns), false});
+  index_.emplace(std::move(key), entries_.begin());
+
+  if (options_.max_entries > 0) {
+    while (entries_.size() > options_.max_entries) {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+      ++stats_.evictions;
+    }
+  }
+}
+
+void MemoryPatternCache::MarkStale(const MemoryPatternGroup* mem_patterns) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  auto it = std::find_if(entries_.begin(), entries_.end(),
+                         [mem_patterns](const Entry& entry) { return entry.mem_patterns.get() == mem_patterns; });
+  if (it != entries_.end()) {
+    it->stale = true;
+  }
+}
+
+MemoryPatternCacheStats MemoryPatternCache::GetStats() const {
+  std::lock_guard<OrtMutex> lock(lock_);
+  MemoryPatternCacheStats stats = stats_;
+  stats.num_entries = entries_.size();
+  for (const auto& entry : entries_) {
+    stats.planned_bytes += TotalPeakSize(*entry.mem_patterns);
+    stats.lower_bound_bytes += TotalLowerBoundSize(*entry.mem_patterns);
+  }
+  return stats;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/session_options.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+struct MemoryPatternCacheStats {
+  size_t num_entries{0};
+  uint64_t hits{0};
+  uint64_t misses{0};
+  uint64_t evictions{0};
+  // the total peak size of the cached patterns, and the total of their lower bounds. the difference is the space
+  // lost to fragmentation.
+  size_t planned_bytes{0};
+  size_t lower_bound_bytes{0};
+};
+
+// Cache of the memory patterns generated for a graph, keyed on the (optionally bucketed) input shapes.
+// Patterns are handed out as shared_ptr so an entry can be evicted or replaced while an ExecutionFrame
+// is still using it.
+// Thread-safe.
+class MemoryPatternCache {
+ public:
+  explicit MemoryPatternCache(const MemoryPatternCacheOptions& options = {}) : options_(options) {}
+
+  const MemoryPatternCacheOptions& Options() const { return options_; }
+
+  bool ShapeBucketingEnabled() const { return options_.enable_shape_bucketing; }
+
+  // Returns the pattern for the input shapes, or nullptr if there is none or it needs to be regenerated.
+  std::shared_ptr<const MemoryPatternGroup> Get(
+      const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes);
+
+  // Adds a pattern for the input shapes. If a stale pattern exists it is replaced when the new pattern is at
+  // least as large, otherwise an existing pattern is kept.
+  void Update(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
+              std::unique_ptr<MemoryPatternGroup> mem_patterns);
+
+  // Marks a pattern returned by Get as not covering all allocations of a run so the next run with the same key
+  // traces a new one. Used in shape bucketing mode where later runs in a bucket can be larger than the run the
+  // pattern was generated from.
+  void MarkStale(const MemoryPatternGroup* mem_patterns);
+
+  MemoryPatternCacheStats GetStats() const;
+
+  // Round dim up to the next power of two.
+  static int64_t BucketDim(int64_t dim);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  using Key = std::vector<int64_t>;
+
+  struct Entry {
+    Key key;
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+    bool stale{false};
+  };
+
+  Key CreateKey(const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
+
+  const MemoryPatternCacheOptions options_;
+
+  mutable OrtMutex lock_;
+  // most recently used entry first
+  std::list<Entry> entries_;
+  std::map<Key, std::list<Entry>::iterator> index_;
+  MemoryPatternCacheStats stats_;
+};
+
+}  // namespace onnxruntime
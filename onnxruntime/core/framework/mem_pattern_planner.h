@@ -16,7 +16,9 @@ limitations under the License.
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
 #include <list>
+#include <numeric>
 
 #include "core/framework/mem_pattern.h"
 #include "core/framework/allocation_planner.h"
@@ -26,16 +28,23 @@ namespace onnxruntime {
 // MemPatternPlanner is used to trace allocation/free steps
 // in a single iteration, record the pattern and cached for
 // future request if they have the same input shape.
+// By default the blocks are placed with a best-fit search as the allocations are traced. With offset packing the
+// traced allocations are treated as intervals and placed once the trace is complete, largest first, each in the
+// best fitting gap between the blocks whose lifetimes overlap it. This fragments less, as the small blocks fill
+// the gaps between the large ones.
 // Thread-safe.
 class MemPatternPlanner {
  public:
-  MemPatternPlanner() = default;
+  explicit MemPatternPlanner(bool use_offset_packing = false) : use_offset_packing_(use_offset_packing) {}
 
   void TraceAllocation(int ml_value_idx, size_t size) {
     std::lock_guard<OrtMutex> lock(lock_);
 
-    if (size == 0) {
-      allocs_.emplace_back(ml_value_idx, MemoryBlock(0, 0));
+    live_bytes_ += size;
+    lower_bound_size_ = std::max(lower_bound_size_, live_bytes_);
+
+    if (size == 0 || use_offset_packing_) {
+      allocs_.emplace_back(ml_value_idx, MemoryBlock(0, size), step_++);
       return;
     }
 
@@ -60,7 +69,7 @@ class MemPatternPlanner {
       current = allocs_[*it].block_.offset_ + allocs_[*it].block_.size_;
     }
 
-    allocs_.emplace_back(ml_value_idx, MemoryBlock(best_offset, size));
+    allocs_.emplace_back(ml_value_idx, MemoryBlock(best_offset, size), step_++);
     buffer_size = std::max(buffer_size, best_offset + size);
     blocks_.insert(best_fit_it, (static_cast<int>(allocs_.size()) - 1));
   }
@@ -68,6 +77,14 @@ class MemPatternPlanner {
   void TraceFree(int ml_value_index) {
     std::lock_guard<OrtMutex> lock(lock_);
 
+    for (auto it = allocs_.rbegin(); it != allocs_.rend(); it++) {
+      if (it->index_ == ml_value_index && it->free_step_ == kNotFreed) {
+        it->free_step_ = step_++;
+        live_bytes_ -= it->block_.size_;
+        break;
+      }
+    }
+
     for (auto it = blocks_.begin(); it != blocks_.end(); it++) {
       if (allocs_[*it].index_ == ml_value_index) {
         blocks_.erase(it);
@@ -80,6 +97,12 @@ class MemPatternPlanner {
     std::lock_guard<OrtMutex> lock(lock_);
 
     MemoryPattern pattern;
+    pattern.lower_bound_size_ = lower_bound_size_;
+    if (use_offset_packing_) {
+      pattern.peak_size_ = PackBlocks(pattern);
+      return pattern;
+    }
+
     pattern.peak_size_ = buffer_size;
     for (auto& alloc : allocs_) {
       pattern.patterns_[alloc.index_] = alloc.block_;
@@ -89,18 +112,86 @@ class MemPatternPlanner {
   }
 
  protected:
+  static constexpr size_t kNotFreed = std::numeric_limits<size_t>::max();
+
   struct OrtValueAllocationBlock {
     int index_{-1};
     MemoryBlock block_;
+    // the lifetime of the block in trace steps, [alloc_step_, free_step_)
+    size_t alloc_step_{0};
+    size_t free_step_{kNotFreed};
 
     OrtValueAllocationBlock() = default;
-    OrtValueAllocationBlock(int index, const MemoryBlock& block) : index_(index), block_(block) {}
+    OrtValueAllocationBlock(int index, const MemoryBlock& block, size_t alloc_step)
+        : index_(index), block_(block), alloc_step_(alloc_step) {}
   };
 
+  // place the traced blocks largest first, each in the smallest gap that fits it between the placed blocks whose
+  // lifetimes overlap it, or after them. returns the peak size.
+  size_t PackBlocks(MemoryPattern& pattern) const {
+    std::vector<size_t> order(allocs_.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+      return allocs_[a].block_.size_ > allocs_[b].block_.size_;
+    });
+
+    size_t peak_size = 0;
+    std::vector<MemoryBlock> placed(allocs_.size());
+    std::vector<size_t> placed_order;  // the placed non-empty blocks, sorted by offset
+    for (size_t i : order) {
+      const auto& alloc = allocs_[i];
+      size_t size = alloc.block_.size_;
+      if (size == 0) {
+        pattern.patterns_[alloc.index_] = MemoryBlock(0, 0);
+        continue;
+      }
+
+      size_t current = 0;
+      size_t waste_bytes = std::numeric_limits<size_t>::max();
+      size_t best_offset = std::numeric_limits<size_t>::max();
+      for (size_t j : placed_order) {
+        const auto& other = allocs_[j];
+        if (other.alloc_step_ >= alloc.free_step_ || alloc.alloc_step_ >= other.free_step_) {
+          continue;  // the lifetimes don't overlap
+        }
+
+        const auto& block = placed[j];
+        if (block.offset_ >= current) {
+          auto gap = block.offset_ - current;
+          if (gap >= size && (gap - size) < waste_bytes) {
+            waste_bytes = gap - size;
+            best_offset = current;
+          }
+        }
+        // blocks that don't overlap in time may overlap in the buffer, so the end isn't increasing
+        current = std::max(current, block.offset_ + block.size_);
+      }
+
+      if (best_offset == std::numeric_limits<size_t>::max()) {
+        best_offset = current;
+      }
+
+      placed[i] = MemoryBlock(best_offset, size);
+      pattern.patterns_[alloc.index_] = placed[i];
+      peak_size = std::max(peak_size, best_offset + size);
+      placed_order.insert(std::upper_bound(placed_order.begin(), placed_order.end(), best_offset,
+                                           [&placed](size_t offset, size_t j) { return offset < placed[j].offset_; }),
+                          i);
+    }
+
+    return peak_size;
+  }
+
   std::vector<OrtValueAllocationBlock> allocs_;
   // blocks_ the list of currently allocated memory blocks, sorted in order of their offset
   std::list<int> blocks_;
   size_t buffer_size{0};
+  // the trace step of the next allocation or free
+  size_t step_{0};
+  // the bytes currently allocated and their maximum, which no placement can go below
+  size_t live_bytes_{0};
+  size_t lower_bound_size_{0};
+  const bool use_offset_packing_;
   mutable OrtMutex lock_;
 };
 
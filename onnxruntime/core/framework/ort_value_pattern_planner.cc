@@ -6,10 +6,10 @@
 #include "core/framework/execution_plan_base.h"
 
 namespace onnxruntime {
-OrtValuePatternPlanner::OrtValuePatternPlanner(const ExecutionPlanBase& execution_plan)
+OrtValuePatternPlanner::OrtValuePatternPlanner(const ExecutionPlanBase& execution_plan, bool use_offset_packing)
     : execution_planner_(execution_plan) {
   for (auto& location : execution_plan.GetAllLocations()) {
-    planner_map_.emplace(location, onnxruntime::make_unique<MemPatternPlanner>());
+    planner_map_.emplace(location, onnxruntime::make_unique<MemPatternPlanner>(use_offset_packing));
   }
 }
 
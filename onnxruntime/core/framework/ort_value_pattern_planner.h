@@ -18,7 +18,7 @@ class ExecutionPlanBase;
 // SessionOptions.enable_mem_pattern
 class OrtValuePatternPlanner {
  public:
-  explicit OrtValuePatternPlanner(const ExecutionPlanBase& execution_plan);
+  explicit OrtValuePatternPlanner(const ExecutionPlanBase& execution_plan, bool use_offset_packing = false);
   common::Status TraceAllocation(int ort_value_idx, size_t size);
   common::Status TraceFree(int ort_value_index);
   common::Status GeneratePatterns(MemoryPatternGroup* out);
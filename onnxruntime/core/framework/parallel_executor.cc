@@ -3,6 +3,7 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -38,8 +39,10 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
     tp = session_state.Profiler().StartTime();
   }
 
-  root_frame_ = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
-                                                 fetch_allocators, session_state);
+  sampling_profiler_ = session_state.GetSamplingProfilerForRun();
+
+  root_frame_ = session_state.GetExecutionFramePool().Acquire(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                              fetch_allocators, session_state);
   //std::cout << "start nodes:" << std::endl;
   for (auto node_index : session_state.GetGraphViewer()->GetRootNodes()) {
     auto p_op_kernel = session_state.GetKernel(node_index);
@@ -117,6 +120,7 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   size_t node_index = p_node_index;
   bool keep_running = true;
   auto graph_viewer = session_state.GetGraphViewer();
+  std::vector<size_t> ready_nodes;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
@@ -189,6 +193,11 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
+    TimePoint sample_begin_time;
+    if (sampling_profiler_) {
+      sample_begin_time = std::chrono::high_resolution_clock::now();
+    }
+
     // Execute the kernel.
     try {
       status = p_op_kernel->Compute(&op_kernel_context);
@@ -206,6 +215,10 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       break;
     }
 
+    if (sampling_profiler_) {
+      sampling_profiler_->EndTimeAndRecordOp(node.OpType(), sample_begin_time);
+    }
+
     if (f_profiler_enabled) {
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      node.Name() + "_kernel_time",
@@ -250,6 +263,7 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     keep_running = false;
 
     // Checking which output nodes ready for running.
+    ready_nodes.clear();
     {
       auto begin = node.OutputEdgesBegin();
       auto end = node.OutputEdgesEnd();
@@ -258,12 +272,7 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       for (auto it = begin; it != end; it++) {
         auto idx = (*it).GetNode().Index();
         if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
-          }
+          ready_nodes.push_back(idx);
         }
 
         // std::cout << "handle output, current name: " << node.Name() << ", current index: "
@@ -271,6 +280,22 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
         // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
       }
     }
+
+    if (!ready_nodes.empty()) {
+      // keep running the node on the critical path on this thread and hand the others to the thread pool
+      auto next = std::max_element(ready_nodes.cbegin(), ready_nodes.cend(), [&exec_plan](size_t a, size_t b) {
+        return exec_plan.NodeCriticalPathCost(a) < exec_plan.NodeCriticalPathCost(b);
+      });
+
+      node_index = *next;
+      keep_running = true;
+
+      for (auto idx : ready_nodes) {
+        if (idx != node_index) {
+          EnqueueNode(idx, session_state, logger);
+        }
+      }
+    }
   }
 
   return status;
@@ -286,7 +311,15 @@ void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& sess
     out_standings_++;
   }
 
-  executor_pool_->Schedule([this, p_node_index, &session_state, &logger]() {
+  {
+    std::lock_guard<OrtMutex> lock(ready_mutex_);
+    ready_nodes_.emplace(session_state.GetExecutionPlan()->NodeCriticalPathCost(p_node_index), p_node_index);
+  }
+
+  // there's one task per ready node, but a task runs whichever ready node has the highest priority when it starts
+  executor_pool_->Schedule([this, &session_state, &logger]() {
+    const size_t p_node_index = DequeueNode();
+
     auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
       const auto* node = session_state.GetGraphViewer()->GetNode(p_node_index);
 
@@ -308,4 +341,12 @@ void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& sess
     FinishNodeRun(status);
   });
 }
+
+size_t ParallelExecutor::DequeueNode() {
+  std::lock_guard<OrtMutex> lock(ready_mutex_);
+  ORT_ENFORCE(!ready_nodes_.empty(), "No ready node for the scheduled task.");
+  auto node_index = ready_nodes_.top().second;
+  ready_nodes_.pop();
+  return node_index;
+}
 }  // namespace onnxruntime
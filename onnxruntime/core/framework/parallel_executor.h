@@ -4,6 +4,8 @@
 #pragma once
 
 #include <vector>
+#include <queue>
+#include <utility>
 #include <condition_variable>
 #include "core/common/common.h"
 #include "core/common/status.h"
@@ -34,8 +36,12 @@ class ParallelExecutor : public IExecutor {
 
   Status RunNodeAsync(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  // Add a node that is ready to run and schedule a task on the thread pool to run the highest priority ready node.
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  // Remove the ready node with the longest critical path.
+  size_t DequeueNode();
+
   void FinishNodeRun(const Status& status) {
     bool finished = false;
     {
@@ -52,15 +58,20 @@ class ParallelExecutor : public IExecutor {
     }
   }
 
-  std::unique_ptr<ExecutionFrame> root_frame_;
+  ExecutionFramePool::FramePtr root_frame_;
   std::vector<size_t> node_refs_;
   OrtMutex ref_mutex_;
+  // nodes that are ready to run ordered by the cost of their critical path. protected by ready_mutex_
+  std::priority_queue<std::pair<int64_t, size_t>> ready_nodes_;
+  OrtMutex ready_mutex_;
   int out_standings_;  //protected by complete_mutex_
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
   std::vector<Status> errors_;
 
   const bool& terminate_flag_;
+  // set if the current run is recorded by the sampling profiler
+  profiling::SamplingProfiler* sampling_profiler_{nullptr};
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
   onnxruntime::concurrency::ThreadPool* const executor_pool_{};
 };
@@ -72,6 +72,10 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   std::vector<OrtValueIndex> to_be_freed;
 
+  // Estimated cost of the longest path from a node to the end of the graph, including the node itself. Key is node
+  // index. Only populated for parallel execution, where ready nodes with a higher value are run first.
+  std::vector<int64_t> node_critical_path_cost;
+
   const OrtMemoryInfo& GetLocation(size_t ort_value_index) const override {
     return allocation_plan[ort_value_index].location;
   }
@@ -92,6 +96,10 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   bool NodeHasFence(onnxruntime::NodeIndex node_index) const {
     return node_has_fence[node_index];
   }
+
+  int64_t NodeCriticalPathCost(onnxruntime::NodeIndex node_index) const {
+    return node_index < node_critical_path_cost.size() ? node_critical_path_cost[node_index] : 0;
+  }
 };
 
 // Output details of an execution plan:
@@ -46,7 +46,12 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     tp = session_state.Profiler().StartTime();
   }
 
-  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+  // nullptr unless this run is sampled
+  auto* sampling_profiler = session_state.GetSamplingProfilerForRun();
+
+  auto frame_ptr = session_state.GetExecutionFramePool().Acquire(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                                 fetch_allocators, session_state);
+  ExecutionFrame& frame = *frame_ptr;
 
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
@@ -150,6 +155,10 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       diagnostic::span span(series, "%s.%d", node.OpType().c_str(), node.Index());
 #endif
       Status compute_status;
+      TimePoint sample_begin_time;
+      if (sampling_profiler) {
+        sample_begin_time = std::chrono::high_resolution_clock::now();
+      }
 
       try {
         compute_status = p_op_kernel->Compute(&op_kernel_context);
@@ -166,6 +175,10 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
         return Status(compute_status.Category(), compute_status.Code(), msg_string);
       }
 
+      if (sampling_profiler) {
+        sampling_profiler->EndTimeAndRecordOp(node.OpType(), sample_begin_time);
+      }
+
 #ifdef CONCURRENCY_VISUALIZER
     }
 #endif
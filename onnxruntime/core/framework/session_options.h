@@ -14,6 +14,28 @@ struct FreeDimensionOverride {
   int64_t dimension_override;
 };
 
+/**
+  * Configuration of the per-graph cache of memory patterns used when enable_mem_pattern is set.
+  */
+struct MemoryPatternCacheOptions {
+  // maximum number of memory patterns to keep. the least recently used pattern is evicted when the
+  // limit is exceeded. 0 means the cache is unbounded.
+  size_t max_entries = 0;
+
+  // round the input dims up to the next power of two before looking up the cache, so that inputs with
+  // different but similar shapes (e.g. variable sequence lengths) share a single memory pattern.
+  bool enable_shape_bucketing = false;
+
+  // input axes that are bucketed when enable_shape_bucketing is set. negative values count from the back.
+  // an empty list means every axis is bucketed.
+  std::vector<int64_t> bucket_axes;
+
+  // place the blocks of a new memory pattern once the allocations of the run are traced, largest first, instead of
+  // as they are allocated. the patterns are smaller when the tensors have very different sizes and lifetimes.
+  // see MemPatternPlanner.
+  bool enable_offset_packing = false;
+};
+
 /**
   * Configuration information for a session.
   */
@@ -26,6 +48,13 @@ struct SessionOptions {
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
+  // non empty filepath enables caching of the optimized and partitioned graph. if the file holds the state of the
+  // same model created with the same execution providers and optimization settings on a CPU with the same features,
+  // the session is created from it without running the graph transformations and the partitioning. otherwise the
+  // file is (re)written once the session is initialized. the cache isn't used when graph transformers are
+  // registered with InferenceSession::RegisterGraphTransformer. see SessionStateCache.
+  std::basic_string<ORTCHAR_T> session_state_cache_filepath;
+
   // enable the memory pattern optimization.
   // The idea is if the input shapes are the same, we could trace the internal memory allocation
   // and generate a memory pattern for future request. So next time we could just do one allocation
@@ -33,11 +62,41 @@ struct SessionOptions {
   // See class 'OrtValuePatternPlanner'.
   bool enable_mem_pattern = true;
 
+  // controls the size of the memory pattern cache and how input shapes are mapped to cache entries.
+  // only used if enable_mem_pattern is set.
+  MemoryPatternCacheOptions mem_pattern_cache_options;
+
+  // maximum number of idle execution frames kept for re-use by later Run calls. a frame re-used by a run with the
+  // same memory pattern doesn't need to allocate its state again, at the cost of holding on to the memory pattern
+  // buffers while idle. 0 disables the pooling.
+  size_t max_idle_execution_frames = 0;
+
+  // execute the nodes in an order that reduces the peak size of the intermediate values, instead of the default
+  // topological order. the allocation plan and the memory patterns follow that order. only used by the sequential
+  // executor.
+  bool enable_memory_aware_node_order = false;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // pack the constant 2D float weights of Gemm and MatMul to the MLAS layout when the CPU kernels are created, so
+  // they aren't packed on every run. the packed copy is kept next to the initializer, which roughly doubles the
+  // memory used by those weights. set this option to false on memory constrained devices.
+  bool enable_cpu_weight_prepacking = true;
+
+  // use the data of CPU initializers stored in external data files in place by memory mapping the files, instead of
+  // copying it into buffers allocated by the session. processes loading the same model share the mapped pages.
+  // initializers that aren't suitably aligned in the file are copied as usual.
+  bool enable_external_data_mmap = false;
+
+  // profile 1 in sampling_profiler_interval runs with the low overhead sampling profiler, which keeps the kernel
+  // times of the last sampling_profiler_buffer_size sampled nodes in a fixed size buffer. the latency statistics
+  // per op type are available from InferenceSession::GetOpLatencyStats. 0 disables it.
+  uint64_t sampling_profiler_interval = 0;
+  size_t sampling_profiler_buffer_size = 16384;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
@@ -54,6 +113,11 @@ struct SessionOptions {
   // set graph optimization level
   TransformerLevel graph_optimization_level = TransformerLevel::Level1;
 
+  // constant folding doesn't fold a node whose outputs take more than this many bytes, e.g. a Tile or Expand of a
+  // small constant, so the model doesn't grow by the size of the folded outputs. nodes whose output shapes aren't
+  // known statically aren't folded when a limit is set. 0 means there is no limit.
+  size_t max_constant_folding_output_bytes = 0;
+
   // controls the size of the thread pool used to parallelize the execution of tasks within individual nodes (ops)
   int intra_op_num_threads = 0;
 
@@ -61,6 +125,18 @@ struct SessionOptions {
   // configuring this makes sense only when you're using parallel executor
   int inter_op_num_threads = 0;
 
+  // controls the size of the thread pool that executes InferenceSession::RunAsync calls. the pool is only created
+  // when RunAsync is used. 0 uses half the number of hardware threads.
+  int async_run_num_threads = 0;
+
+  // settings of the RequestBatcher that coalesces concurrent InferenceSession::RunBatched calls into batches along
+  // axis 0 of the feeds. the batcher is only created when RunBatched is used. a max batch size of 0 disables
+  // RunBatched.
+  int request_batching_max_batch_size = 0;
+  int64_t request_batching_max_delay_us = 1000;
+  // number of batches that can run at the same time
+  int request_batching_num_threads = 2;
+
   // For models with free input dimensions (most commonly batch size), specifies a set of values to override those
   // free dimensions with, keyed by dimension denotation.
   std::vector<FreeDimensionOverride> free_dimension_overrides;
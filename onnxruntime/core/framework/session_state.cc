@@ -148,39 +148,40 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &pro
 
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
-  for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
-  }
-  return key;
+void SessionState::SetSamplingProfiler(profiling::SamplingProfiler* sampling_profiler) {
+  sampling_profiler_ = sampling_profiler;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
-    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+profiling::SamplingProfiler* SessionState::GetSamplingProfilerForRun() const {
+  if (sampling_profiler_ == nullptr) {
+    return nullptr;
+  }
 
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
+  return sampling_profiler_->ShouldSample(num_sampling_runs_.fetch_add(1)) ? sampling_profiler_ : nullptr;
+}
 
-  return it->second.get();
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
+  return mem_patterns_.Get(input_shapes);
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
     std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+  for (size_t i = 0; i < mem_patterns->locations.size(); i++) {
+    VLOGS(Logger(), 1) << "Memory pattern for " << mem_patterns->locations[i].name << ": planned "
+                       << mem_patterns->patterns[i].PeakSize() << " bytes, lower bound "
+                       << mem_patterns->patterns[i].LowerBoundSize() << " bytes";
   }
 
+  mem_patterns_.Update(input_shapes, std::move(mem_patterns));
   return Status::OK();
 }
 
+void SessionState::InvalidateMemoryPatternGroup(const MemoryPatternGroup* mem_patterns) const {
+  mem_patterns_.MarkStale(mem_patterns);
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& input_name, const NodeInfo& node_info) {
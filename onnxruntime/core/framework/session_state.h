@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -13,12 +14,15 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
+#include "core/common/sampling_profiler.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/execution_frame_pool.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/callback.h"
 #include "core/framework/ort_value_name_idx_map.h"
@@ -52,11 +56,15 @@ class SessionState {
   SessionState(const ExecutionProviders& execution_providers,
                bool enable_mem_pattern,
                concurrency::ThreadPool* thread_pool,
-               concurrency::ThreadPool* inter_op_thread_pool)
+               concurrency::ThreadPool* inter_op_thread_pool,
+               const MemoryPatternCacheOptions& mem_pattern_cache_options = {},
+               size_t max_idle_execution_frames = 0)
       : execution_providers_(execution_providers),
         enable_mem_pattern_(enable_mem_pattern),
+        mem_patterns_(mem_pattern_cache_options),
         thread_pool_(thread_pool),
-        inter_op_thread_pool_(inter_op_thread_pool) {
+        inter_op_thread_pool_(inter_op_thread_pool),
+        execution_frame_pool_(max_idle_execution_frames) {
   }
 
   ~SessionState() {
@@ -142,9 +150,21 @@ class SessionState {
   profiling::Profiler& Profiler() const;
 
   /**
-  Get cached memory pattern based on input shapes
+  Set the sampling profiler for this session. nullptr disables sampling.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  void SetSamplingProfiler(profiling::SamplingProfiler* sampling_profiler);
+
+  /**
+  Get the sampling profiler if the current execution of this graph should be profiled, otherwise nullptr.
+  Each call counts as an execution of the graph.
+  */
+  profiling::SamplingProfiler* GetSamplingProfilerForRun() const;
+
+  /**
+  Get cached memory pattern based on input shapes.
+  The returned pattern stays valid while the caller holds it, even if it's evicted from the cache.
+  */
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
 
   /**
@@ -154,11 +174,30 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Request that a cached memory pattern that did not cover all allocations of a run is regenerated.
+  Const as it's an internal cache update only.
+  */
+  void InvalidateMemoryPatternGroup(const MemoryPatternGroup* mem_patterns) const;
+
   /**
   Get enable memory pattern flag
   */
   bool GetEnableMemoryPattern() const;
 
+  const MemoryPatternCacheOptions& GetMemoryPatternCacheOptions() const { return mem_patterns_.Options(); }
+
+  /**
+  Get the hit/miss/eviction counters of the memory pattern cache.
+  */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const { return mem_patterns_.GetStats(); }
+
+  /**
+  Get the pool of execution frames used by the executors.
+  Const as frames are checked out and returned by the executors during execution.
+  */
+  ExecutionFramePool& GetExecutionFramePool() const { return execution_frame_pool_; }
+
   struct NodeInfo {
     /**
      *
@@ -241,13 +280,14 @@ class SessionState {
 
   const logging::Logger* logger_ = nullptr;
   profiling::Profiler* profiler_ = nullptr;
+  profiling::SamplingProfiler* sampling_profiler_ = nullptr;
+  // number of executions of this graph, used to pick the ones the sampling profiler records
+  mutable std::atomic<uint64_t> num_sampling_runs_{0};
 
   // switch for enable memory pattern optimization or not.
   const bool enable_mem_pattern_;
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  mutable MemoryPatternCache mem_patterns_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -268,6 +308,9 @@ class SessionState {
 
   std::unique_ptr<NodeIndexInfo> node_index_info_;
   std::multimap<int, std::unique_ptr<FeedsFetchesManager>> cached_feeds_fetches_managers_;
+
+  // idle execution frames. declared last so the frames are released before anything they reference.
+  mutable ExecutionFramePool execution_frame_pool_;
 };
 
 }  // namespace onnxruntime
@@ -0,0 +1,343 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/session_state_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#include "core/common/cpuid_info.h"
+#include "core/platform/env.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'R', 'T', 'S', 'T', 'A', 'T', 'E'};
+
+// bits of the CPU features mask
+constexpr uint32_t kAVX = 1 << 0;
+constexpr uint32_t kAVX2 = 1 << 1;
+constexpr uint32_t kAVX512f = 1 << 2;
+constexpr uint32_t kAVX512Skylake = 1 << 3;
+constexpr uint32_t kF16C = 1 << 4;
+
+// 64-bit FNV-1a
+uint64_t Fnv1a(const char* data, size_t length, uint64_t hash = 14695981039346656037ULL) {
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// the values are written in the byte order of the platform. a cache created on a platform with a different byte
+// order is rejected as the format version won't match.
+class Writer {
+ public:
+  template <typename T>
+  void Write(T value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void Write(const std::string& str) {
+    Write<uint64_t>(str.size());
+    buffer_.append(str);
+  }
+
+  std::string& Buffer() { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+class Reader {
+ public:
+  Reader(const char* data, size_t length) : data_(data), length_(length) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    if (length_ - offset_ < sizeof(T)) {
+      return false;
+    }
+    memcpy(&value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+
+  bool Read(std::string& str) {
+    uint64_t size = 0;
+    if (!Read(size) || length_ - offset_ < size) {
+      return false;
+    }
+    str.assign(data_ + offset_, static_cast<size_t>(size));
+    offset_ += static_cast<size_t>(size);
+    return true;
+  }
+
+  // read a length prefixed block in place
+  bool Read(const char*& data, size_t& size) {
+    uint64_t block_size = 0;
+    if (!Read(block_size) || length_ - offset_ < block_size) {
+      return false;
+    }
+    data = data_ + offset_;
+    size = static_cast<size_t>(block_size);
+    offset_ += size;
+    return true;
+  }
+
+ private:
+  const char* data_;
+  size_t length_;
+  size_t offset_{0};
+};
+
+// the outputs of a node are unique within its graph, so the first one identifies the node. node indexes can't be
+// used as the nodes are re-numbered when the serialized graph is loaded.
+const std::string* GetNodeKey(const Node& node) {
+  for (const auto* output : node.OutputDefs()) {
+    if (output->Exists()) {
+      return &output->Name();
+    }
+  }
+  return nullptr;
+}
+
+void WriteAssignments(Graph& graph, const std::string& graph_path, Writer& writer, uint64_t& num_assignments) {
+  for (auto& node : graph.Nodes()) {
+    const std::string& node_key = *GetNodeKey(node);
+    writer.Write(graph_path);
+    writer.Write(node_key);
+    writer.Write(node.GetExecutionProviderType());
+    ++num_assignments;
+
+    for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+      WriteAssignments(*entry.second, graph_path + node_key + "/" + entry.first + "/", writer, num_assignments);
+    }
+  }
+}
+
+void CollectNodes(Graph& graph, const std::string& graph_path,
+                  std::unordered_map<std::string, std::unordered_map<std::string, Node*>>& nodes) {
+  auto& graph_nodes = nodes[graph_path];
+  for (auto& node : graph.Nodes()) {
+    const std::string* node_key = GetNodeKey(node);
+    if (node_key == nullptr) {
+      continue;
+    }
+
+    graph_nodes[*node_key] = &node;
+    for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+      CollectNodes(*entry.second, graph_path + *node_key + "/" + entry.first + "/", nodes);
+    }
+  }
+}
+
+size_t CountNodes(const Graph& graph) {
+  size_t num_nodes = 0;
+  for (const auto& node : graph.Nodes()) {
+    ++num_nodes;
+    if (node.ContainsSubgraph()) {
+      for (const auto& subgraph : node.GetSubgraphs()) {
+        num_nodes += CountNodes(*subgraph);
+      }
+    }
+  }
+  return num_nodes;
+}
+
+}  // namespace
+
+std::string SessionStateCache::CreateConfigKey(const std::vector<std::string>& provider_types,
+                                               const SessionOptions& session_options,
+                                               const std::vector<std::string>& custom_transformers) {
+  // the optimized graph of one release isn't necessarily valid for the kernels and transformers of another
+  std::string key = "version:" ORT_VERSION ";providers:";
+  for (const auto& provider_type : provider_types) {
+    key += provider_type + ",";
+  }
+
+  key += ";level:" + std::to_string(static_cast<int>(session_options.graph_optimization_level)) + ";transformers:";
+  for (const auto& transformer : custom_transformers) {
+    key += transformer + ",";
+  }
+
+  key += ";free_dimension_overrides:";
+  for (const auto& free_dimension_override : session_options.free_dimension_overrides) {
+    key += free_dimension_override.dimension_denotation + "=" +
+           std::to_string(free_dimension_override.dimension_override) + ",";
+  }
+
+  key += ";max_constant_folding_output_bytes:" + std::to_string(session_options.max_constant_folding_output_bytes);
+  return key;
+}
+
+uint64_t SessionStateCache::HashModel(const void* model_data, size_t model_data_len) {
+  return Fnv1a(static_cast<const char*>(model_data), model_data_len);
+}
+
+uint64_t SessionStateCache::HashModel(const ONNX_NAMESPACE::ModelProto& model_proto) {
+  std::string bytes;
+  model_proto.SerializeToString(&bytes);
+  return HashModel(bytes.data(), bytes.size());
+}
+
+common::Status SessionStateCache::HashModelFile(const std::basic_string<ORTCHAR_T>& model_path,
+                                                uint64_t& model_hash) {
+  const Env& env = Env::Default();
+  size_t length = 0;
+  int64_t modification_time = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(model_path.c_str(), length));
+  ORT_RETURN_IF_ERROR(env.GetFileModificationTime(model_path.c_str(), modification_time));
+
+  uint64_t hash = Fnv1a(reinterpret_cast<const char*>(model_path.data()), model_path.size() * sizeof(ORTCHAR_T));
+  hash = Fnv1a(reinterpret_cast<const char*>(&length), sizeof(length), hash);
+  model_hash = Fnv1a(reinterpret_cast<const char*>(&modification_time), sizeof(modification_time), hash);
+  return Status::OK();
+}
+
+uint32_t SessionStateCache::GetCpuFeatures() {
+  const auto& cpu_info = CPUIDInfo::GetCPUIDInfo();
+  uint32_t features = 0;
+  features |= cpu_info.HasAVX() ? kAVX : 0u;
+  features |= cpu_info.HasAVX2() ? kAVX2 : 0u;
+  features |= cpu_info.HasAVX512f() ? kAVX512f : 0u;
+  features |= cpu_info.HasAVX512Skylake() ? kAVX512Skylake : 0u;
+  features |= cpu_info.HasF16C() ? kF16C : 0u;
+  return features;
+}
+
+bool SessionStateCache::CanSave(const Graph& graph) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.NodeType() == Node::Type::Fused || node.GetExecutionProviderType().empty() ||
+        GetNodeKey(node) == nullptr) {
+      return false;
+    }
+
+    if (node.ContainsSubgraph()) {
+      for (const auto& subgraph : node.GetSubgraphs()) {
+        if (!CanSave(*subgraph)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+common::Status SessionStateCache::Save(const std::basic_string<ORTCHAR_T>& path, uint64_t model_hash,
+                                       const std::string& config_key, Model& model) {
+  ORT_RETURN_IF_NOT(CanSave(model.MainGraph()), "The session state contains nodes that can't be cached.");
+
+  Writer writer;
+  writer.Buffer().append(kMagic, sizeof(kMagic));
+  writer.Write<uint32_t>(kFormatVersion);
+  writer.Write<uint32_t>(GetCpuFeatures());
+  writer.Write<uint64_t>(model_hash);
+  writer.Write(config_key);
+
+  std::string model_bytes;
+  ORT_RETURN_IF_NOT(model.ToProto().SerializeToString(&model_bytes), "Failed to serialize the optimized model.");
+  writer.Write(model_bytes);
+  model_bytes = std::string();
+
+  Writer assignments;
+  uint64_t num_assignments = 0;
+  WriteAssignments(model.MainGraph(), "", assignments, num_assignments);
+  writer.Write<uint64_t>(num_assignments);
+  writer.Buffer().append(assignments.Buffer());
+
+  auto& buffer = writer.Buffer();
+  writer.Write<uint64_t>(Fnv1a(buffer.data(), buffer.size()));
+
+  std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  ORT_RETURN_IF_NOT(file.good(), "Failed to open the session state cache file for writing.");
+  file.write(buffer.data(), buffer.size());
+  ORT_RETURN_IF_NOT(file.good(), "Failed to write the session state cache file.");
+
+  return Status::OK();
+}
+
+common::Status SessionStateCache::Load(const std::basic_string<ORTCHAR_T>& path, uint64_t model_hash,
+                                       const std::string& config_key,
+                                       const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                                       std::shared_ptr<Model>& model) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.good()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Session state cache file doesn't exist.");
+  }
+
+  std::string buffer{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  ORT_RETURN_IF_NOT(!file.bad(), "Failed to read the session state cache file.");
+
+  // a file that was truncated or partially overwritten, e.g. by concurrent writers, fails the checksum
+  uint64_t checksum = 0;
+  ORT_RETURN_IF_NOT(buffer.size() >= sizeof(kMagic) + sizeof(checksum) &&
+                        memcmp(buffer.data(), kMagic, sizeof(kMagic)) == 0,
+                    "Invalid session state cache file.");
+  const size_t body_size = buffer.size() - sizeof(checksum);
+  memcpy(&checksum, buffer.data() + body_size, sizeof(checksum));
+  ORT_RETURN_IF_NOT(checksum == Fnv1a(buffer.data(), body_size), "Session state cache file is corrupt.");
+
+  Reader reader(buffer.data() + sizeof(kMagic), body_size - sizeof(kMagic));
+  uint32_t format_version = 0;
+  uint32_t cpu_features = 0;
+  uint64_t cached_model_hash = 0;
+  std::string cached_config_key;
+  ORT_RETURN_IF_NOT(reader.Read(format_version) && format_version == kFormatVersion,
+                    "Session state cache has an unsupported format version.");
+  ORT_RETURN_IF_NOT(reader.Read(cpu_features) && reader.Read(cached_model_hash) && reader.Read(cached_config_key),
+                    "Session state cache file is corrupt.");
+  ORT_RETURN_IF_NOT(cpu_features == GetCpuFeatures(), "Session state cache was created on a different CPU.");
+  ORT_RETURN_IF_NOT(cached_model_hash == model_hash, "Session state cache was created from a different model.");
+  ORT_RETURN_IF_NOT(cached_config_key == config_key,
+                    "Session state cache was created with a different session configuration. Expected:",
+                    config_key, " Cached:", cached_config_key);
+
+  const char* model_data = nullptr;
+  size_t model_size = 0;
+  ORT_RETURN_IF_NOT(reader.Read(model_data, model_size), "Session state cache file is corrupt.");
+
+  auto model_proto = onnxruntime::make_unique<ONNX_NAMESPACE::ModelProto>();
+  ORT_RETURN_IF_NOT(model_proto->ParseFromArray(model_data, static_cast<int>(model_size)),
+                    "Failed to parse the model in the session state cache.");
+  // release the copy of the serialized model before the graph is created from it
+  buffer = buffer.substr(static_cast<size_t>(model_data - buffer.data()) + model_size);
+  Reader assignment_reader(buffer.data(), buffer.size() - sizeof(checksum));
+
+  std::shared_ptr<Model> cached_model;
+  ORT_RETURN_IF_ERROR(Model::Load(std::move(model_proto), cached_model, local_registries));
+
+  std::unordered_map<std::string, std::unordered_map<std::string, Node*>> nodes;
+  CollectNodes(cached_model->MainGraph(), "", nodes);
+
+  uint64_t num_assignments = 0;
+  ORT_RETURN_IF_NOT(assignment_reader.Read(num_assignments) &&
+                        num_assignments == CountNodes(cached_model->MainGraph()),
+                    "Session state cache doesn't have an execution provider for every node.");
+
+  std::string graph_path;
+  std::string node_key;
+  std::string provider_type;
+  for (uint64_t i = 0; i < num_assignments; ++i) {
+    ORT_RETURN_IF_NOT(assignment_reader.Read(graph_path) && assignment_reader.Read(node_key) &&
+                          assignment_reader.Read(provider_type),
+                      "Session state cache file is corrupt.");
+
+    auto graph_nodes = nodes.find(graph_path);
+    ORT_RETURN_IF_NOT(graph_nodes != nodes.end(), "Session state cache has no graph ", graph_path);
+    auto node = graph_nodes->second.find(node_key);
+    ORT_RETURN_IF_NOT(node != graph_nodes->second.end(), "Session state cache has no node ", graph_path, node_key);
+    node->second->SetExecutionProviderType(provider_type);
+  }
+
+  model = std::move(cached_model);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
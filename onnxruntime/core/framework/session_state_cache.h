@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/session_options.h"
+#include "core/graph/model.h"
+#include "core/optimizer/graph_transformer_level.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+
+/**
+ * File cache of the state of a session after the graph transformations and the partitioning, i.e. the optimized graph
+ * including any weights that were pre-processed by the transformers (e.g. NCHWc filter reordering), and the execution
+ * provider assigned to each node. Creating a session from the cache skips the transformations and the partitioning.
+ *
+ * The cache is only valid for the model it was created from, the configuration of the session that affects the
+ * transformations and the partitioning, and the instruction set extensions of the CPU, as kernels and transformers
+ * may choose layouts based on them. A cache that doesn't match, or is corrupt, is rejected when loading it.
+ */
+class SessionStateCache {
+ public:
+  // Version of the file format. Increment when the format or the meaning of its contents changes.
+  static constexpr uint32_t kFormatVersion = 2;
+
+  /**
+   * Create the key of the session configuration the cache depends on.
+   * \param provider_types The registered execution providers in priority order.
+   * \param session_options The options of the session. The options that affect the transformations are included.
+   * \param custom_transformers The names of the transformers that were explicitly enabled, if any.
+   */
+  static std::string CreateConfigKey(const std::vector<std::string>& provider_types,
+                                     const SessionOptions& session_options,
+                                     const std::vector<std::string>& custom_transformers);
+
+  // Hash of the serialized model, used to check that a cache was created from the same model.
+  static uint64_t HashModel(const void* model_data, size_t model_data_len);
+  static uint64_t HashModel(const ONNX_NAMESPACE::ModelProto& model_proto);
+
+  // Hash of the path, the size and the modification time of a model file, so the model doesn't need to be read
+  // again to check that a cache was created from it.
+  static common::Status HashModelFile(const std::basic_string<ORTCHAR_T>& model_path, uint64_t& model_hash);
+
+  // Bit mask of the CPU features the cache depends on.
+  static uint32_t GetCpuFeatures();
+
+  // Returns true if the state of graph can be cached. Fused nodes created by compiling execution providers
+  // can't be restored from the serialized graph.
+  static bool CanSave(const Graph& graph);
+
+  // Write the state of the optimized and partitioned model to path.
+  static common::Status Save(const std::basic_string<ORTCHAR_T>& path, uint64_t model_hash,
+                             const std::string& config_key, Model& model);
+
+  /**
+   * Load the model from the cache at path and assign the cached execution providers to its nodes.
+   * \param local_registries The custom schema registries of the session, if any.
+   * \param[out] model The optimized and partitioned model.
+   * \returns an error if the file can't be read, is corrupt, or doesn't match model_hash, config_key or the CPU.
+   */
+  static common::Status Load(const std::basic_string<ORTCHAR_T>& path, uint64_t model_hash,
+                             const std::string& config_key, const IOnnxRuntimeOpSchemaRegistryList* local_registries,
+                             std::shared_ptr<Model>& model);
+};
+
+}  // namespace onnxruntime
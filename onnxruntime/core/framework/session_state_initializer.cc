@@ -13,6 +13,7 @@
 
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/external_data_mapper.h"
 #include "core/graph/graph_utils.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/ml_value.h"
@@ -32,9 +33,11 @@ template <typename T>
 static common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                              const onnxruntime::Graph& graph, const ExecutionProviders& exec_providers,
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                             const ExecutionPlanBase& exec_plan,
                                              ITensorAllocator* planner, const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             ExternalDataMapper* external_data_mapper);
 
 static common::Status SaveInputOutputNamesToNodeMapping(
     const onnxruntime::Graph& graph,
@@ -46,19 +49,21 @@ SessionStateInitializer::SessionStateInitializer(bool enable_mem_pattern,
                                                  const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                                  onnxruntime::Graph& graph, SessionState& session_state,
                                                  const ExecutionProviders& providers,
-                                                 KernelRegistryManager& kernel_registry_manager)
+                                                 KernelRegistryManager& kernel_registry_manager,
+                                                 bool enable_external_data_mmap)
     : graph_loc_(graph_loc),
       graph_(graph),
       session_state_(session_state),
       execution_providers_(providers),
       kernel_registry_manager_(kernel_registry_manager),
       logger_(session_state.Logger()),
-      enable_mem_pattern_(enable_mem_pattern) {}
+      enable_mem_pattern_(enable_mem_pattern),
+      enable_external_data_mmap_(enable_external_data_mmap) {}
 
 common::Status SessionStateInitializer::CreatePlan(
     const Node* parent_node,
     const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-    ExecutionMode execution_mode) {
+    ExecutionMode execution_mode, bool enable_memory_aware_node_order) {
   session_state_.SetGraph(graph_);
   const GraphViewer* graph_viewer = session_state_.GetGraphViewer();
 
@@ -78,7 +83,7 @@ common::Status SessionStateInitializer::CreatePlan(
   }
 
   std::unique_ptr<SequentialExecutionPlan> exec_plan;
-  SequentialPlannerContext context(execution_mode);
+  SequentialPlannerContext context(execution_mode, enable_memory_aware_node_order);
   ORT_RETURN_IF_ERROR(SequentialPlanner::CreatePlan(parent_node, *graph_viewer, valid_outer_scope_node_args,
                                                     execution_providers_, kernel_registry_manager_,
                                                     ort_value_name_idx_map, context, exec_plan));
@@ -92,12 +97,17 @@ common::Status SessionStateInitializer::CreatePlan(
 
   // lambda to save initialized tensors into SessionState directly
   const Env& env = Env::Default();
+  std::unique_ptr<ExternalDataMapper> external_data_mapper;
+  if (enable_external_data_mmap_) {
+    external_data_mapper = onnxruntime::make_unique<ExternalDataMapper>(env);
+  }
+
   ORT_RETURN_IF_ERROR(SaveInitializedTensors(
-      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, tensor_allocator_.get(),
+      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, *exec_plan_ptr, tensor_allocator_.get(),
       [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
         return session_state_.AddInitializedTensor(idx, value, &d, constant);
       },
-      logger_, session_state_.GetDataTransferMgr()));
+      logger_, session_state_.GetDataTransferMgr(), external_data_mapper.get()));
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
   // TODO: make it better
@@ -109,13 +119,17 @@ common::Status SessionStateInitializer::CreatePlan(
   return Status::OK();
 }
 
+static bool IsCpuLocation(const OrtMemoryInfo& alloc_info) {
+  return strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput;
+}
+
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m,
                                              const ExecutionProviders& exec_providers, OrtValue& ort_value,
                                              OrtCallback& deleter,
                                              const DataTransferManager& data_transfer_mgr) {
   const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
-  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
+  if (IsCpuLocation(alloc_info)) {
     // deserialize directly to CPU tensor
     return utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto, m, ort_value, deleter);
   }
@@ -171,9 +185,11 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                       const Graph& graph, const ExecutionProviders& exec_providers,
-                                      const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator* planner,
+                                      const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                      const ExecutionPlanBase& exec_plan, ITensorAllocator* planner,
                                       const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const DataTransferManager& data_transfer_mgr,
+                                      ExternalDataMapper* external_data_mapper) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > 0, "OrtValue indexes should have been populated.");
 
@@ -185,6 +201,37 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
+
+  // initializers using memory mapped external data in place don't need a buffer, so handle them before planning
+  if (external_data_mapper != nullptr) {
+    for (auto it = id_to_initialized_tensor.begin(); it != id_to_initialized_tensor.end();) {
+      const int ort_value_index = it->first;
+      const ONNX_NAMESPACE::TensorProto& tensor_proto = *it->second;
+      if (!ExternalDataMapper::CanMap(tensor_proto) || !IsCpuLocation(exec_plan.GetLocation(ort_value_index))) {
+        ++it;
+        continue;
+      }
+
+      OrtValue ort_value;
+      OrtCallback deleter;
+      bool mapped;
+      ORT_RETURN_IF_ERROR(external_data_mapper->CreateTensor(graph_loc.c_str(), tensor_proto,
+                                                             exec_plan.GetLocation(ort_value_index),
+                                                             ort_value, deleter, mapped));
+      if (!mapped) {
+        ++it;
+        continue;
+      }
+
+      const std::string& name = tensor_proto.name();
+      bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
+      ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+
+      VLOGS(logger, 1) << "Added memory mapped weight with name : " << name << " with index: " << ort_value_index;
+      it = id_to_initialized_tensor.erase(it);
+    }
+  }
+
   for (const auto& entry : id_to_initialized_tensor) {
     ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
   }
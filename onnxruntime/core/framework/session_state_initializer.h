@@ -31,16 +31,18 @@ class SessionStateInitializer {
   /**
    *
    * \param graph_loc The file path of where the graph was loaded. e.g. /tmp/test_squeezenet/model.onnx
+   * \param enable_external_data_mmap Use external data of CPU initializers in place. See SessionOptions.
    */
   SessionStateInitializer(bool enable_mem_pattern, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                           onnxruntime::Graph& graph, SessionState& session_state, const ExecutionProviders& providers,
-                          KernelRegistryManager& kernel_registry_manager);
+                          KernelRegistryManager& kernel_registry_manager, bool enable_external_data_mmap = false);
 
   // First perform any transformations and create the execution plan
   // Then initialize tensors, and save. save kernels and input/output node mappings
+  // enable_memory_aware_node_order: order the nodes to reduce the peak memory usage. See SessionOptions.
   common::Status CreatePlan(_In_opt_ const Node* parent_node,
                             _In_opt_ const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-                            ExecutionMode execution_mode);
+                            ExecutionMode execution_mode, bool enable_memory_aware_node_order = false);
 
  private:
   const std::basic_string<PATH_CHAR_TYPE>& graph_loc_;
@@ -51,5 +53,6 @@ class SessionStateInitializer {
   KernelRegistryManager& kernel_registry_manager_;
   const logging::Logger& logger_;
   const bool enable_mem_pattern_;
+  const bool enable_external_data_mmap_;
 };
 }  // namespace onnxruntime
@@ -369,6 +369,22 @@ static void MoveOrtCallback(OrtCallback& from, OrtCallback& to) {
   from.param = nullptr;
 }
 
+Status GetExternalDataLocation(const ORTCHAR_T* tensor_proto_path, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                               std::basic_string<ORTCHAR_T>& file_path, FileOffsetType& offset, size_t& length) {
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
+  if (tensor_proto_path != nullptr) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, file_path));
+    file_path = ConcatPathComponent<ORTCHAR_T>(file_path, external_data_info->GetRelPath());
+  } else {
+    file_path = external_data_info->GetRelPath();
+  }
+
+  offset = external_data_info->GetOffset();
+  length = external_data_info->GetLength();
+  return Status::OK();
+}
+
 Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                             const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m, OrtValue& value,
                             OrtCallback& deleter) {
@@ -386,20 +402,12 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING)
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "string tensor can not have raw data");
 
-      std::unique_ptr<ExternalDataInfo> external_data_info;
-      ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
       std::basic_string<ORTCHAR_T> full_path;
-      if (tensor_proto_path != nullptr) {
-        ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, full_path));
-        full_path = ConcatPathComponent<ORTCHAR_T>(full_path, external_data_info->GetRelPath());
-      } else {
-        full_path = external_data_info->GetRelPath();
-      }
-      raw_data_len = external_data_info->GetLength();
+      FileOffsetType offset;
+      ORT_RETURN_IF_ERROR(GetExternalDataLocation(tensor_proto_path, tensor_proto, full_path, offset, raw_data_len));
       // load the file
-      ORT_RETURN_IF_ERROR(GetFileContent(
-          env, full_path.c_str(), external_data_info->GetOffset(), raw_data_len,
-          raw_data, deleter_for_file_data.d));
+      ORT_RETURN_IF_ERROR(GetFileContent(env, full_path.c_str(), offset, raw_data_len, raw_data,
+                                         deleter_for_file_data.d));
     } else if (utils::HasRawData(tensor_proto)) {
       if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING)
         return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "string tensor can not have raw data");
@@ -34,6 +34,18 @@ TensorShape GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::TensorShape
 common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, OrtValue& value,
                                     OrtCallback& deleter);
+
+/**
+ * Get the location of the external data of a TensorProto.
+ * \param tensor_proto_path See TensorProtoToMLValue.
+ * \param[out] file_path The path of the file containing the data.
+ * \param[out] offset The offset of the data in the file.
+ * \param[out] length The length of the data. 0 means the data extends to the end of the file.
+ */
+common::Status GetExternalDataLocation(const ORTCHAR_T* tensor_proto_path,
+                                       const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                       std::basic_string<ORTCHAR_T>& file_path, FileOffsetType& offset,
+                                       size_t& length);
 // This function doesn't support string tensors
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
 
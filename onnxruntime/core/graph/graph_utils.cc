@@ -354,6 +354,20 @@ bool IsOutputUsed(const Node& node, int index) {
   return false;
 }
 
+const Node* GetInputNode(const Node& node, int index) {
+  for (auto it = node.InputEdgesBegin(), end = node.InputEdgesEnd(); it != end; ++it) {
+    if (it->GetDstArgIndex() == index) {
+      return &it->GetNode();
+    }
+  }
+  return nullptr;
+}
+
+Node* GetInputNode(Graph& graph, const Node& node, int index) {
+  const Node* input_node = GetInputNode(node, index);
+  return input_node == nullptr ? nullptr : graph.GetNode(input_node->Index());
+}
+
 bool CanRemoveNode(const Graph& graph, const Node& node) {
   const std::string* output_name = nullptr;
   if (!IsOnlyOneOutputUsed(graph, node, output_name)) {
@@ -570,6 +584,11 @@ size_t RemoveNodeOutputEdges(Graph& graph, Node& node) {
   return output_edges.size();
 }
 
+bool CanUpdateImplicitInputNameInSubgraphs(const Graph& graph, const Node& node, int output_idx,
+                                           const std::string& new_arg_name) {
+  return CanUpdateImplicitInputNameInSubgraphs(graph, GetNodeOutputEdges(node, output_idx), new_arg_name);
+}
+
 void ReplaceDownstreamNodeInput(Graph& graph, Node& node, int output_idx, Node& replacement, int replacement_output_idx) {
   // get the output edges from node for output_idx
   std::vector<GraphEdge> output_edges = GetNodeOutputEdges(node, output_idx);
@@ -641,5 +660,56 @@ void FinalizeNodeFusion(Graph& graph, const std::vector<std::reference_wrapper<N
   }
 }
 
+void BypassInputNode(Graph& graph, Node& node, int input_idx, Node& input_node) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == input_idx) {
+      graph.RemoveEdge(input_node.Index(), node.Index(), it->GetSrcArgIndex(), input_idx);
+      break;
+    }
+  }
+
+  ReplaceNodeInput(node, input_idx, *input_node.MutableInputDefs()[0]);
+  for (auto it = input_node.InputEdgesBegin(); it != input_node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == 0) {
+      graph.AddEdge(it->GetNode().Index(), node.Index(), it->GetSrcArgIndex(), input_idx);
+      break;
+    }
+  }
+}
+
+bool RemoveNodeIfUnused(Graph& graph, Node& node) {
+  if (node.GetOutputEdgesCount() != 0 || !graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+    return false;
+  }
+
+  graph.RemoveNode(node.Index());
+  return true;
+}
+
+void RemoveInverseNodes(Graph& graph, Node& input_node, Node& node) {
+  assert(CanRemoveNode(graph, node));
+
+  Node* incoming_node = nullptr;
+  int incoming_output_idx = 0;
+  for (auto it = input_node.InputEdgesBegin(); it != input_node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == 0) {
+      incoming_node = graph.GetNode(it->GetNode().Index());
+      incoming_output_idx = it->GetSrcArgIndex();
+      break;
+    }
+  }
+
+  if (incoming_node) {
+    // wire the node producing the input of input_node to the outgoing node/s
+    ReplaceDownstreamNodeInput(graph, node, 0, *incoming_node, incoming_output_idx);
+    graph.RemoveNode(node.Index());
+  } else {
+    // the input of input_node is a graph input or initializer
+    ReplaceNodeWithInitializer(graph, node, *input_node.MutableInputDefs()[0]);
+  }
+
+  RemoveNodeIfUnused(graph, input_node);
+}
+
 }  // namespace graph_utils
 }  // namespace onnxruntime
@@ -30,6 +30,11 @@ bool IsSupportedProvider(const Node& node,
 /** Checks if the output at the specified index is input to downstream Nodes. */
 bool IsOutputUsed(const Node& node, int index);
 
+/** Returns the node producing the input at the specified index, or nullptr if the input is not produced by a Node
+    (e.g. it is a graph input or an initializer). */
+const Node* GetInputNode(const Node& node, int index);
+Node* GetInputNode(Graph& graph, const Node& node, int index);
+
 /** Returns true if the graph has the given input.*/
 bool IsGraphInput(const Graph& graph, const NodeArg* input);
 
@@ -148,6 +153,12 @@ e.g. Node A produces outputs A1 and A2.
 */
 void ReplaceDownstreamNodeInput(Graph& graph, Node& node, int output_idx, Node& replacement, int replacement_output_idx);
 
+/** Checks if the output of 'node' for 'output_idx' can be renamed to 'new_arg_name' in the subgraphs that consume it
+    as an implicit input, i.e. the new name doesn't clash with a name in one of those subgraphs.
+    Call this before ReplaceDownstreamNodeInput. */
+bool CanUpdateImplicitInputNameInSubgraphs(const Graph& graph, const Node& node, int output_idx,
+                                           const std::string& new_arg_name);
+
 /** Replace the input to a node with a NodeArg.
 @remarks The replacement only updates the node's input definition and does not create any edges,
          as typically this function is used to replace an input with an initializer or graph input 
@@ -181,5 +192,23 @@ void FinalizeNodeFusion(Graph& graph, Node& first_node, Node& second_node);
 */
 void FinalizeNodeFusion(Graph& graph, const std::vector<std::reference_wrapper<Node>>& nodes, Node& replacement_node);
 
+/** Replaces the input of 'node' at 'input_idx', which is produced by 'input_node', with the first input of
+    'input_node', and moves the input edge accordingly. 'input_node' is left in the graph.
+    e.g. Reshape(Reshape(X)) becomes Reshape(X).
+*/
+void BypassInputNode(Graph& graph, Node& node, int input_idx, Node& input_node);
+
+/** Removes the node if none of its outputs are consumed by other nodes or provide a graph output.
+@returns true if the node was removed. */
+bool RemoveNodeIfUnused(Graph& graph, Node& node);
+
+/** Removes 'node', whose first input is produced by 'input_node', where the two nodes together are an identity
+    function of the first input of 'input_node' (e.g. Unsqueeze(Squeeze(X)) with the same axes). The nodes downstream
+    from 'node' consume the first input of 'input_node' instead. 'input_node' is also removed if it has no other
+    consumers.
+    See CanRemoveNode for the conditions that 'node' must satisfy.
+*/
+void RemoveInverseNodes(Graph& graph, Node& input_node, Node& node);
+
 }  // namespace graph_utils
 }  // namespace onnxruntime
@@ -108,6 +108,22 @@ MlasActivation(
 //
 // Matrix/matrix multiply routines.
 //
+// The optional epilogue of a single precision matrix/matrix multiply is
+// applied to each block of the output matrix while the block is still cache
+// resident, instead of as separate passes over the output matrix:
+//
+//     C = Activation(alpha * op(A) * op(B) + beta * C + Bias + Addend)
+//
+// where Bias is a vector of N elements added to each row of C and Addend is a
+// matrix with the same shape as C.
+//
+
+struct MLAS_SGEMM_EPILOGUE {
+    const float* Bias;
+    const float* Addend;
+    size_t ldaddend;
+    const MLAS_ACTIVATION* Activation;
+};
 
 void
 MLASCALL
@@ -128,6 +144,122 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasGemm(
@@ -306,6 +438,69 @@ MlasComputeErf(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasComputeLogSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Binary elementwise routines.
+//
+
+enum MLAS_BINARY_OPERATION_KIND {
+    MlasAddBinaryOperation,
+    MlasSubtractBinaryOperation,
+    MlasMultiplyBinaryOperation,
+    MlasDivideBinaryOperation,
+    MlasMaximumBinaryOperation,
+    MlasMinimumBinaryOperation,
+};
+
+enum MLAS_BINARY_BROADCAST_KIND {
+    MlasNoBroadcast,
+    MlasScalarBroadcast,
+    MlasChannelBroadcast,
+    MlasRowBroadcast,
+};
+
+void
+MLASCALL
+MlasComputeBinaryOperation(
+    MLAS_BINARY_OPERATION_KIND OperationKind,
+    const float* InputA,
+    MLAS_BINARY_BROADCAST_KIND BroadcastA,
+    const float* InputB,
+    MLAS_BINARY_BROADCAST_KIND BroadcastB,
+    float* Output,
+    size_t OuterCount,
+    size_t ChannelCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
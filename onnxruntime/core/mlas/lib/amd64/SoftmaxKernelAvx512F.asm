@@ -0,0 +1,329 @@
+;++
+;
+; Copyright (c) Microsoft Corporation. All rights reserved.
+;
+; Licensed under the MIT License.
+;
+; Module Name:
+;
+;   SoftmaxKernelAvx512F.asm
+;
+; Abstract:
+;
+;   This module implements the kernels for the exponential function and the
+;   single precision softmax operation.
+;
+;   This implementation uses AVX512F instructions.
+;
+;--
+
+        .xlist
+INCLUDE mlasi.inc
+        .list
+
+        EXTERN  MlasExpConstants:NEAR
+
+;
+; Structure layout for the exponential function constants block.
+;
+
+ExpConstants STRUCT
+
+        LowerRange DWORD ?
+        UpperRange DWORD ?
+        RoundingBias DWORD ?
+        Log2Reciprocal DWORD ?
+        Log2High DWORD ?
+        Log2Low DWORD ?
+        poly_0 DWORD ?
+        poly_1 DWORD ?
+        poly_2 DWORD ?
+        poly_3 DWORD ?
+        poly_4 DWORD ?
+        poly_56 DWORD ?
+        MinimumExponent DWORD ?
+        MaximumExponent DWORD ?
+
+ExpConstants ENDS
+
+;
+; Macro Description:
+;
+;   This macro loads the exponential function constants that are kept in
+;   registers across the loop iterations.
+;
+; Implicit Arguments:
+;
+;   rax - Supplies the address of the exponential function constants block.
+;
+
+LoadExpConstants MACRO
+
+        vbroadcastss zmm16,ExpConstants.LowerRange[rax]
+        vbroadcastss zmm17,ExpConstants.UpperRange[rax]
+        vbroadcastss zmm18,ExpConstants.RoundingBias[rax]
+        vbroadcastss zmm19,ExpConstants.Log2Reciprocal[rax]
+        vbroadcastss zmm20,ExpConstants.Log2High[rax]
+        vbroadcastss zmm21,ExpConstants.Log2Low[rax]
+        vbroadcastss zmm22,ExpConstants.poly_0[rax]
+        vbroadcastss zmm23,ExpConstants.poly_1[rax]
+        vbroadcastss zmm24,ExpConstants.poly_2[rax]
+        vbroadcastss zmm25,ExpConstants.poly_3[rax]
+        vbroadcastss zmm26,ExpConstants.poly_4[rax]
+        vbroadcastss zmm27,ExpConstants.poly_56[rax]
+
+        ENDM
+
+;
+; Macro Description:
+;
+;   This macro computes the exponential function for a vector of elements.
+;
+;   The polynomial is scaled by 2^m using the VSCALEFPS instruction, which
+;   directly produces results in the denormal range.
+;
+; Implicit Arguments:
+;
+;   zmm0 - Supplies the input vector.
+;
+;   zmm2 - Returns the exponential function of the input vector.
+;
+;   zmm0, zmm1 - Supplies temporary registers.
+;
+;   zmm16-zmm27 - Supplies the constants loaded by LoadExpConstants.
+;
+
+ComputeExpVector MACRO
+
+        vmaxps  zmm0,zmm16,zmm0                 ; clamp lower bound
+        vminps  zmm0,zmm17,zmm0                 ; clamp upper bound
+        vmovaps zmm1,zmm18
+        vfmadd231ps zmm1,zmm0,zmm19             ; m = x / ln2 + RoundingBias
+        vsubps  zmm1,zmm1,zmm18                 ; m = round(x / ln2)
+        vfmadd231ps zmm0,zmm1,zmm20             ; r = m * Log2High + x
+        vfmadd231ps zmm0,zmm1,zmm21             ; r = m * Log2Low + r
+        vmovaps zmm2,zmm23
+        vfmadd231ps zmm2,zmm22,zmm0             ; p = poly_0 * r + poly_1
+        vfmadd213ps zmm2,zmm0,zmm24             ; p = p * r + poly_2
+        vfmadd213ps zmm2,zmm0,zmm25             ; p = p * r + poly_3
+        vfmadd213ps zmm2,zmm0,zmm26             ; p = p * r + poly_4
+        vfmadd213ps zmm2,zmm0,zmm27             ; p = p * r + poly_56
+        vfmadd213ps zmm2,zmm0,zmm27             ; p = p * r + poly_56
+        vscalefps zmm2,zmm2,zmm1                ; scale polynomial by 2^m
+
+        ENDM
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for the exponential function.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Supplies the output buffer.
+;
+;   N (r8) - Supplies the number of elements to process.
+;
+; Return Value:
+;
+;   None.
+;
+;--
+
+        LEAF_ENTRY MlasComputeExpF32KernelAvx512F, _TEXT
+
+        lea     rax,MlasExpConstants
+        LoadExpConstants
+        sub     r8,16
+        jb      ComputeExpProcessRemainingCount
+
+ComputeExpBy16Loop:
+        vmovups zmm0,ZMMWORD PTR [rcx]
+        ComputeExpVector
+        add     rcx,16*4                        ; advance input by 16 elements
+        vmovups ZMMWORD PTR [rdx],zmm2
+        add     rdx,16*4                        ; advance output by 16 elements
+        sub     r8,16
+        jae     ComputeExpBy16Loop
+
+ComputeExpProcessRemainingCount:
+        add     r8,16                           ; correct for over-subtract above
+        jz      ComputeExpExitKernel
+        mov     r10,rcx                         ; save input buffer
+        mov     ecx,r8d
+        mov     eax,1
+        shl     eax,cl
+        dec     eax
+        kmovw   k1,eax                          ; mask for remaining elements
+        vmovups zmm0{k1}{z},ZMMWORD PTR [r10]
+        ComputeExpVector
+        vmovups ZMMWORD PTR [rdx]{k1},zmm2
+
+ComputeExpExitKernel:
+        vzeroupper
+        ret
+
+        LEAF_END MlasComputeExpF32KernelAvx512F, _TEXT
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for computing the sum of the
+;   exponential function of the biased input elements.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Optionally supplies the output buffer. When used for
+;       Softmax, the output buffer is used to store the intermediate exp()
+;       results. When used for LogSoftmax, the intermediate exp() results are
+;       not required.
+;
+;   N (r8) - Supplies the number of elements to process.
+;
+;   NegativeMaximum (r9) - Supplies the address of the negative maximum value
+;       that is added to each element before computing the exponential
+;       function.
+;
+; Return Value:
+;
+;   Returns the sum of the exponential function of the biased elements.
+;
+;--
+
+        LEAF_ENTRY MlasComputeSumExpF32KernelAvx512F, _TEXT
+
+        lea     rax,MlasExpConstants
+        LoadExpConstants
+        vbroadcastss zmm4,DWORD PTR [r9]        ; broadcast negative maximum value
+        vpxord  zmm5,zmm5,zmm5                  ; clear exp() accumulator
+        sub     r8,16
+        jb      ComputeSumExpProcessRemainingCount
+
+ComputeSumExpBy16Loop:
+        vaddps  zmm0,zmm4,ZMMWORD PTR [rcx]     ; bias by negative maximum value
+        ComputeExpVector
+        add     rcx,16*4                        ; advance input by 16 elements
+        vaddps  zmm5,zmm5,zmm2                  ; accumulate exp() results
+        test    rdx,rdx
+        jz      ComputeSumExpSkipStoreBy16
+        vmovups ZMMWORD PTR [rdx],zmm2
+        add     rdx,16*4                        ; advance output by 16 elements
+
+ComputeSumExpSkipStoreBy16:
+        sub     r8,16
+        jae     ComputeSumExpBy16Loop
+
+ComputeSumExpProcessRemainingCount:
+        add     r8,16                           ; correct for over-subtract above
+        jz      ComputeSumExpReduceAccumulator
+        mov     r10,rcx                         ; save input buffer
+        mov     ecx,r8d
+        mov     eax,1
+        shl     eax,cl
+        dec     eax
+        kmovw   k1,eax                          ; mask for remaining elements
+        vmovups zmm0{k1}{z},ZMMWORD PTR [r10]
+        vaddps  zmm0,zmm4,zmm0                  ; bias by negative maximum value
+        ComputeExpVector
+        vaddps  zmm5{k1},zmm5,zmm2              ; accumulate exp() results
+        test    rdx,rdx
+        jz      ComputeSumExpReduceAccumulator
+        vmovups ZMMWORD PTR [rdx]{k1},zmm2
+
+ComputeSumExpReduceAccumulator:
+        vextractf64x4 ymm1,zmm5,1               ; reduce to single value
+        vaddps  ymm0,ymm5,ymm1
+        vextractf128 xmm1,ymm0,1
+        vaddps  xmm0,xmm0,xmm1
+        vhaddps xmm0,xmm0,xmm0
+        vhaddps xmm0,xmm0,xmm0
+        vzeroupper
+        ret
+
+        LEAF_END MlasComputeSumExpF32KernelAvx512F, _TEXT
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel to find the maximum value of
+;   the supplied buffer.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   N (rdx) - Supplies the number of elements to process.
+;
+; Return Value:
+;
+;   Returns the maximum value of the supplied buffer.
+;
+;--
+
+        LEAF_ENTRY MlasReduceMaximumF32KernelAvx512F, _TEXT
+
+        mov     eax,0FF7FFFFFh                  ; lowest finite float value
+        vpbroadcastd zmm0,eax
+        cmp     rdx,16
+        jb      ReduceMaximumProcessRemainingCount
+        cmp     rdx,64
+        jb      ReduceMaximumBy16Loop
+        vmovaps zmm1,zmm0
+        vmovaps zmm2,zmm0
+        vmovaps zmm3,zmm0
+
+ReduceMaximumBy64Loop:
+        vmaxps  zmm0,zmm0,ZMMWORD PTR [rcx]
+        vmaxps  zmm1,zmm1,ZMMWORD PTR [rcx+16*4]
+        sub     rdx,64
+        vmaxps  zmm2,zmm2,ZMMWORD PTR [rcx+32*4]
+        vmaxps  zmm3,zmm3,ZMMWORD PTR [rcx+48*4]
+        add     rcx,64*4                        ; advance input by 64 elements
+        cmp     rdx,64
+        jae     ReduceMaximumBy64Loop
+        vmaxps  zmm0,zmm0,zmm1                  ; reduce to single vector
+        vmaxps  zmm2,zmm2,zmm3
+        vmaxps  zmm0,zmm0,zmm2
+        cmp     rdx,16
+        jb      ReduceMaximumProcessRemainingCount
+
+ReduceMaximumBy16Loop:
+        vmaxps  zmm0,zmm0,ZMMWORD PTR [rcx]
+        sub     rdx,16
+        add     rcx,16*4                        ; advance input by 16 elements
+        cmp     rdx,16
+        jae     ReduceMaximumBy16Loop
+
+ReduceMaximumProcessRemainingCount:
+        test    rdx,rdx
+        jz      ReduceMaximumReduceVector
+        mov     r10,rcx                         ; save input buffer
+        mov     ecx,edx
+        mov     eax,1
+        shl     eax,cl
+        dec     eax
+        kmovw   k1,eax                          ; mask for remaining elements
+        vmaxps  zmm0{k1},zmm0,ZMMWORD PTR [r10]
+
+ReduceMaximumReduceVector:
+        vextractf64x4 ymm1,zmm0,1               ; reduce to single value
+        vmaxps  ymm0,ymm0,ymm1
+        vextractf128 xmm1,ymm0,1
+        vmaxps  xmm0,xmm0,xmm1
+        vshufps xmm1,xmm0,xmm0,0EEh
+        vmaxps  xmm0,xmm0,xmm1
+        vshufps xmm1,xmm0,xmm0,055h
+        vmaxss  xmm0,xmm0,xmm1
+        vzeroupper
+        ret
+
+        LEAF_END MlasReduceMaximumF32KernelAvx512F, _TEXT
+
+        END
@@ -0,0 +1,341 @@
+;++
+;
+; Copyright (c) Microsoft Corporation. All rights reserved.
+;
+; Licensed under the MIT License.
+;
+; Module Name:
+;
+;   SoftmaxKernelFma3.asm
+;
+; Abstract:
+;
+;   This module implements the kernels for the exponential function and the
+;   single precision softmax operation.
+;
+;   This implementation uses AVX fused multiply/add instructions.
+;
+;--
+
+        .xlist
+INCLUDE mlasi.inc
+        .list
+
+        EXTERN  MlasMaskMoveAvx:NEAR
+        EXTERN  MlasExpConstants:NEAR
+
+;
+; Structure layout for the exponential function constants block.
+;
+
+ExpConstants STRUCT
+
+        LowerRange DWORD ?
+        UpperRange DWORD ?
+        RoundingBias DWORD ?
+        Log2Reciprocal DWORD ?
+        Log2High DWORD ?
+        Log2Low DWORD ?
+        poly_0 DWORD ?
+        poly_1 DWORD ?
+        poly_2 DWORD ?
+        poly_3 DWORD ?
+        poly_4 DWORD ?
+        poly_56 DWORD ?
+        MinimumExponent DWORD ?
+        MaximumExponent DWORD ?
+
+ExpConstants ENDS
+
+;
+; Stack frame layout for the exponential function kernels.
+;
+
+ExpKernelFrame STRUCT
+
+        SavedXmm6 OWORD ?
+        SavedXmm7 OWORD ?
+        SavedXmm8 OWORD ?
+        SavedXmm9 OWORD ?
+        SavedXmm10 OWORD ?
+        SavedXmm11 OWORD ?
+        SavedXmm12 OWORD ?
+        SavedXmm13 OWORD ?
+        SavedXmm14 OWORD ?
+        SavedXmm15 OWORD ?
+        Padding0 QWORD ?
+        Padding1 QWORD ?
+        CountN QWORD ?
+        ReturnAddress QWORD ?
+        PreviousP1Home QWORD ?
+        PreviousP2Home QWORD ?
+        PreviousP3Home QWORD ?
+        PreviousP4Home QWORD ?
+
+ExpKernelFrame ENDS
+
+;
+; Macro Description:
+;
+;   This macro generates the prologue for the exponential function kernels,
+;   which saves the non-volatile vector registers.
+;
+
+ExpKernelPrologue MACRO
+
+        alloc_stack (ExpKernelFrame.ReturnAddress)
+
+        save_xmm128_avx xmm6,ExpKernelFrame.SavedXmm6
+        save_xmm128_avx xmm7,ExpKernelFrame.SavedXmm7
+        save_xmm128_avx xmm8,ExpKernelFrame.SavedXmm8
+        save_xmm128_avx xmm9,ExpKernelFrame.SavedXmm9
+        save_xmm128_avx xmm10,ExpKernelFrame.SavedXmm10
+        save_xmm128_avx xmm11,ExpKernelFrame.SavedXmm11
+        save_xmm128_avx xmm12,ExpKernelFrame.SavedXmm12
+        save_xmm128_avx xmm13,ExpKernelFrame.SavedXmm13
+        save_xmm128_avx xmm14,ExpKernelFrame.SavedXmm14
+        save_xmm128_avx xmm15,ExpKernelFrame.SavedXmm15
+
+        END_PROLOGUE
+
+        ENDM
+
+;
+; Macro Description:
+;
+;   This macro restores the non-volatile vector registers and releases the
+;   stack frame for the exponential function kernels.
+;
+
+ExpKernelEpilogue MACRO
+
+        vzeroupper
+        vmovaps xmm6,ExpKernelFrame.SavedXmm6[rsp]
+        vmovaps xmm7,ExpKernelFrame.SavedXmm7[rsp]
+        vmovaps xmm8,ExpKernelFrame.SavedXmm8[rsp]
+        vmovaps xmm9,ExpKernelFrame.SavedXmm9[rsp]
+        vmovaps xmm10,ExpKernelFrame.SavedXmm10[rsp]
+        vmovaps xmm11,ExpKernelFrame.SavedXmm11[rsp]
+        vmovaps xmm12,ExpKernelFrame.SavedXmm12[rsp]
+        vmovaps xmm13,ExpKernelFrame.SavedXmm13[rsp]
+        vmovaps xmm14,ExpKernelFrame.SavedXmm14[rsp]
+        vmovaps xmm15,ExpKernelFrame.SavedXmm15[rsp]
+        add     rsp,(ExpKernelFrame.ReturnAddress)
+
+        BEGIN_EPILOGUE
+
+        ret
+
+        ENDM
+
+;
+; Macro Description:
+;
+;   This macro loads the exponential function constants that are kept in
+;   registers across the loop iterations.
+;
+; Implicit Arguments:
+;
+;   rax - Supplies the address of the exponential function constants block.
+;
+
+LoadExpConstants MACRO
+
+        vbroadcastss ymm6,ExpConstants.RoundingBias[rax]
+        vbroadcastss ymm7,ExpConstants.Log2Reciprocal[rax]
+        vbroadcastss ymm8,ExpConstants.Log2High[rax]
+        vbroadcastss ymm9,ExpConstants.Log2Low[rax]
+        vbroadcastss ymm10,ExpConstants.poly_0[rax]
+        vbroadcastss ymm11,ExpConstants.poly_1[rax]
+        vbroadcastss ymm12,ExpConstants.poly_2[rax]
+        vbroadcastss ymm13,ExpConstants.poly_3[rax]
+        vbroadcastss ymm14,ExpConstants.poly_4[rax]
+        vbroadcastss ymm15,ExpConstants.poly_56[rax]
+
+        ENDM
+
+;
+; Macro Description:
+;
+;   This macro computes the exponential function for a vector of elements.
+;
+; Implicit Arguments:
+;
+;   rax - Supplies the address of the exponential function constants block.
+;
+;   ymm0 - Supplies the input vector.
+;
+;   ymm2 - Returns the exponential function of the input vector.
+;
+;   ymm0, ymm1, ymm3 - Supplies temporary registers.
+;
+;   ymm6-ymm15 - Supplies the constants loaded by LoadExpConstants.
+;
+
+ComputeExpVector MACRO
+
+        vbroadcastss ymm3,ExpConstants.LowerRange[rax]
+        vmaxps  ymm0,ymm3,ymm0                  ; clamp lower bound
+        vbroadcastss ymm3,ExpConstants.UpperRange[rax]
+        vminps  ymm0,ymm3,ymm0                  ; clamp upper bound
+        vmovaps ymm1,ymm6
+        vfmadd231ps ymm1,ymm0,ymm7              ; m = x / ln2 + RoundingBias
+        vsubps  ymm1,ymm1,ymm6                  ; m = round(x / ln2)
+        vfmadd231ps ymm0,ymm1,ymm8              ; r = m * Log2High + x
+        vfmadd231ps ymm0,ymm1,ymm9              ; r = m * Log2Low + r
+        vmovaps ymm2,ymm11
+        vfmadd231ps ymm2,ymm10,ymm0             ; p = poly_0 * r + poly_1
+        vfmadd213ps ymm2,ymm0,ymm12             ; p = p * r + poly_2
+        vfmadd213ps ymm2,ymm0,ymm13             ; p = p * r + poly_3
+        vfmadd213ps ymm2,ymm0,ymm14             ; p = p * r + poly_4
+        vfmadd213ps ymm2,ymm0,ymm15             ; p = p * r + poly_56
+        vfmadd213ps ymm2,ymm0,ymm15             ; p = p * r + poly_56
+        vbroadcastss ymm3,ExpConstants.MinimumExponent[rax]
+        vmaxps  ymm0,ymm3,ymm1                  ; normal = max(m, MinimumExponent)
+        vbroadcastss ymm3,ExpConstants.MaximumExponent[rax]
+        vminps  ymm0,ymm3,ymm0                  ; normal = min(normal, MaximumExponent)
+        vsubps  ymm1,ymm1,ymm0                  ; overflow = m - normal
+        vaddps  ymm0,ymm0,ymm3                  ; add exponent bias to normal
+        vaddps  ymm1,ymm1,ymm3                  ; add exponent bias to overflow
+        vcvttps2dq ymm0,ymm0
+        vcvttps2dq ymm1,ymm1
+        vpslld  ymm0,ymm0,23                    ; build 2^normal
+        vpslld  ymm1,ymm1,23                    ; build 2^overflow
+        vmulps  ymm2,ymm2,ymm1                  ; scale polynomial by 2^overflow
+        vmulps  ymm2,ymm2,ymm0                  ; scale polynomial by 2^normal
+
+        ENDM
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for the exponential function.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Supplies the output buffer.
+;
+;   N (r8) - Supplies the number of elements to process.
+;
+; Return Value:
+;
+;   None.
+;
+;--
+
+        NESTED_ENTRY MlasComputeExpF32KernelFma3, _TEXT
+
+        ExpKernelPrologue
+
+        lea     rax,MlasExpConstants
+        LoadExpConstants
+        sub     r8,8
+        jb      ComputeExpProcessRemainingCount
+
+ComputeExpBy8Loop:
+        vmovups ymm0,YMMWORD PTR [rcx]
+        ComputeExpVector
+        add     rcx,8*4                         ; advance input by 8 elements
+        vmovups YMMWORD PTR [rdx],ymm2
+        add     rdx,8*4                         ; advance output by 8 elements
+        sub     r8,8
+        jae     ComputeExpBy8Loop
+
+ComputeExpProcessRemainingCount:
+        add     r8,8                            ; correct for over-subtract above
+        jz      ComputeExpExitKernel
+        mov     DWORD PTR ExpKernelFrame.CountN[rsp],r8d
+        vbroadcastss ymm5,DWORD PTR ExpKernelFrame.CountN[rsp]
+        vpcmpgtd ymm5,ymm5,YMMWORD PTR [MlasMaskMoveAvx]
+        vmaskmovps ymm0,ymm5,YMMWORD PTR [rcx]
+        ComputeExpVector
+        vmaskmovps YMMWORD PTR [rdx],ymm5,ymm2
+
+ComputeExpExitKernel:
+        ExpKernelEpilogue
+
+        NESTED_END MlasComputeExpF32KernelFma3, _TEXT
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for computing the sum of the
+;   exponential function of the biased input elements.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Optionally supplies the output buffer. When used for
+;       Softmax, the output buffer is used to store the intermediate exp()
+;       results. When used for LogSoftmax, the intermediate exp() results are
+;       not required.
+;
+;   N (r8) - Supplies the number of elements to process.
+;
+;   NegativeMaximum (r9) - Supplies the address of the negative maximum value
+;       that is added to each element before computing the exponential
+;       function.
+;
+; Return Value:
+;
+;   Returns the sum of the exponential function of the biased elements.
+;
+;--
+
+        NESTED_ENTRY MlasComputeSumExpF32KernelFma3, _TEXT
+
+        ExpKernelPrologue
+
+        lea     rax,MlasExpConstants
+        LoadExpConstants
+        vbroadcastss ymm4,DWORD PTR [r9]        ; broadcast negative maximum value
+        vxorps  ymm5,ymm5,ymm5                  ; clear exp() accumulator
+        sub     r8,8
+        jb      ComputeSumExpProcessRemainingCount
+
+ComputeSumExpBy8Loop:
+        vaddps  ymm0,ymm4,YMMWORD PTR [rcx]     ; bias by negative maximum value
+        ComputeExpVector
+        add     rcx,8*4                         ; advance input by 8 elements
+        vaddps  ymm5,ymm5,ymm2                  ; accumulate exp() results
+        test    rdx,rdx
+        jz      ComputeSumExpSkipStoreBy8
+        vmovups YMMWORD PTR [rdx],ymm2
+        add     rdx,8*4                         ; advance output by 8 elements
+
+ComputeSumExpSkipStoreBy8:
+        sub     r8,8
+        jae     ComputeSumExpBy8Loop
+
+ComputeSumExpProcessRemainingCount:
+        add     r8,8                            ; correct for over-subtract above
+        jz      ComputeSumExpReduceAccumulator
+        mov     DWORD PTR ExpKernelFrame.CountN[rsp],r8d
+        vbroadcastss ymm3,DWORD PTR ExpKernelFrame.CountN[rsp]
+        vpcmpgtd ymm3,ymm3,YMMWORD PTR [MlasMaskMoveAvx]
+        vmaskmovps ymm0,ymm3,YMMWORD PTR [rcx]
+        vaddps  ymm0,ymm4,ymm0                  ; bias by negative maximum value
+        ComputeExpVector
+        vbroadcastss ymm3,DWORD PTR ExpKernelFrame.CountN[rsp]
+        vpcmpgtd ymm3,ymm3,YMMWORD PTR [MlasMaskMoveAvx]
+        vandps  ymm2,ymm2,ymm3                  ; mask off unused elements
+        vaddps  ymm5,ymm5,ymm2                  ; accumulate exp() results
+        test    rdx,rdx
+        jz      ComputeSumExpReduceAccumulator
+        vmaskmovps YMMWORD PTR [rdx],ymm3,ymm2
+
+ComputeSumExpReduceAccumulator:
+        vextractf128 xmm1,ymm5,1                ; reduce to single value
+        vaddps  xmm0,xmm5,xmm1
+        vhaddps xmm0,xmm0,xmm0
+        vhaddps xmm0,xmm0,xmm0
+        ExpKernelEpilogue
+
+        NESTED_END MlasComputeSumExpF32KernelFma3, _TEXT
+
+        END
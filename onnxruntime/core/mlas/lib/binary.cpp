@@ -0,0 +1,536 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    binary.cpp
+
+Abstract:
+
+    This module implements the binary elementwise routines.
+
+    The output is treated as a three dimensional tensor of shape
+    [OuterCount, ChannelCount, InnerCount]. Each input either matches the
+    output shape or is broadcast as a scalar, as one value per channel, or as
+    one row that is repeated for each outer index.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Templates for binary operation functions.
+//
+
+template<MLAS_BINARY_OPERATION_KIND OperationKind>
+struct MLAS_BINARY_OPERATION_FUNCTION;
+
+template<>
+struct MLAS_BINARY_OPERATION_FUNCTION<MlasAddBinaryOperation>
+{
+    static MLAS_FLOAT32X4 Compute(MLAS_FLOAT32X4 ValueA, MLAS_FLOAT32X4 ValueB)
+    {
+        return MlasAddFloat32x4(ValueA, ValueB);
+    }
+};
+
+template<>
+struct MLAS_BINARY_OPERATION_FUNCTION<MlasSubtractBinaryOperation>
+{
+    static MLAS_FLOAT32X4 Compute(MLAS_FLOAT32X4 ValueA, MLAS_FLOAT32X4 ValueB)
+    {
+        return MlasSubtractFloat32x4(ValueA, ValueB);
+    }
+};
+
+template<>
+struct MLAS_BINARY_OPERATION_FUNCTION<MlasMultiplyBinaryOperation>
+{
+    static MLAS_FLOAT32X4 Compute(MLAS_FLOAT32X4 ValueA, MLAS_FLOAT32X4 ValueB)
+    {
+        return MlasMultiplyFloat32x4(ValueA, ValueB);
+    }
+};
+
+template<>
+struct MLAS_BINARY_OPERATION_FUNCTION<MlasDivideBinaryOperation>
+{
+    static MLAS_FLOAT32X4 Compute(MLAS_FLOAT32X4 ValueA, MLAS_FLOAT32X4 ValueB)
+    {
+        return MlasDivideFloat32x4(ValueA, ValueB);
+    }
+};
+
+template<>
+struct MLAS_BINARY_OPERATION_FUNCTION<MlasMaximumBinaryOperation>
+{
+    static MLAS_FLOAT32X4 Compute(MLAS_FLOAT32X4 ValueA, MLAS_FLOAT32X4 ValueB)
+    {
+        return MlasMaximumFloat32x4(ValueA, ValueB);
+    }
+};
+
+template<>
+struct MLAS_BINARY_OPERATION_FUNCTION<MlasMinimumBinaryOperation>
+{
+    static MLAS_FLOAT32X4 Compute(MLAS_FLOAT32X4 ValueA, MLAS_FLOAT32X4 ValueB)
+    {
+        return MlasMinimumFloat32x4(ValueA, ValueB);
+    }
+};
+
+//
+// Templates for loading the operands of a binary operation. A broadcast
+// operand holds a single value that is reused for every element of the span.
+//
+
+template<bool Broadcast>
+struct MLAS_BINARY_OPERAND;
+
+template<>
+struct MLAS_BINARY_OPERAND<false>
+{
+    const float* Input;
+
+    MLAS_BINARY_OPERAND(const float* Buffer) : Input(Buffer)
+    {
+    }
+
+    MLAS_FLOAT32X4 LoadVector(size_t Offset)
+    {
+        return MlasLoadFloat32x4(Input + Offset);
+    }
+
+    MLAS_FLOAT32X4 LoadScalar(size_t Offset)
+    {
+        return MlasBroadcastFloat32x4(Input + Offset);
+    }
+};
+
+template<>
+struct MLAS_BINARY_OPERAND<true>
+{
+    MLAS_FLOAT32X4 ValueBroadcast;
+
+    MLAS_BINARY_OPERAND(const float* Buffer)
+    {
+        ValueBroadcast = MlasBroadcastFloat32x4(Buffer);
+    }
+
+    MLAS_FLOAT32X4 LoadVector(size_t Offset)
+    {
+        MLAS_UNREFERENCED_PARAMETER(Offset);
+
+        return ValueBroadcast;
+    }
+
+    MLAS_FLOAT32X4 LoadScalar(size_t Offset)
+    {
+        MLAS_UNREFERENCED_PARAMETER(Offset);
+
+        return ValueBroadcast;
+    }
+};
+
+template<MLAS_BINARY_OPERATION_KIND OperationKind, bool BroadcastA, bool BroadcastB>
+void
+MlasComputeBinaryOperationSpan(
+    const float* InputA,
+    const float* InputB,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the binary operation for a span of elements.
+
+Arguments:
+
+    InputA - Supplies the first input buffer. If BroadcastA is true, then this
+        points to a single value that is used for every element of the span.
+
+    InputB - Supplies the second input buffer. If BroadcastB is true, then this
+        points to a single value that is used for every element of the span.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_BINARY_OPERAND<BroadcastA> OperandA(InputA);
+    MLAS_BINARY_OPERAND<BroadcastB> OperandB(InputB);
+
+    size_t Offset = 0;
+
+    while (Offset + 16 <= N) {
+
+        MLAS_FLOAT32X4 Value0 = MLAS_BINARY_OPERATION_FUNCTION<OperationKind>::Compute(
+            OperandA.LoadVector(Offset), OperandB.LoadVector(Offset));
+        MLAS_FLOAT32X4 Value1 = MLAS_BINARY_OPERATION_FUNCTION<OperationKind>::Compute(
+            OperandA.LoadVector(Offset + 4), OperandB.LoadVector(Offset + 4));
+        MLAS_FLOAT32X4 Value2 = MLAS_BINARY_OPERATION_FUNCTION<OperationKind>::Compute(
+            OperandA.LoadVector(Offset + 8), OperandB.LoadVector(Offset + 8));
+        MLAS_FLOAT32X4 Value3 = MLAS_BINARY_OPERATION_FUNCTION<OperationKind>::Compute(
+            OperandA.LoadVector(Offset + 12), OperandB.LoadVector(Offset + 12));
+
+        MlasStoreFloat32x4(Output + Offset, Value0);
+        MlasStoreFloat32x4(Output + Offset + 4, Value1);
+        MlasStoreFloat32x4(Output + Offset + 8, Value2);
+        MlasStoreFloat32x4(Output + Offset + 12, Value3);
+
+        Offset += 16;
+    }
+
+    while (Offset + 4 <= N) {
+
+        MLAS_FLOAT32X4 Value = MLAS_BINARY_OPERATION_FUNCTION<OperationKind>::Compute(
+            OperandA.LoadVector(Offset), OperandB.LoadVector(Offset));
+
+        MlasStoreFloat32x4(Output + Offset, Value);
+
+        Offset += 4;
+    }
+
+    //
+    // Compute the remaining elements using the vector operation so that the
+    // results match the vectorized path, including the handling of NaNs.
+    //
+
+    while (Offset < N) {
+
+        MLAS_FLOAT32X4 Value = MLAS_BINARY_OPERATION_FUNCTION<OperationKind>::Compute(
+            OperandA.LoadScalar(Offset), OperandB.LoadScalar(Offset));
+
+        Output[Offset] = MlasExtractLaneFloat32x4<0>(Value);
+
+        Offset += 1;
+    }
+}
+
+struct MLAS_BINARY_OPERATION_WORK_BLOCK {
+    const float* InputA;
+    const float* InputB;
+    float* Output;
+    MLAS_BINARY_BROADCAST_KIND BroadcastA;
+    MLAS_BINARY_BROADCAST_KIND BroadcastB;
+    size_t ChannelCount;
+    size_t InnerCount;
+    size_t TotalCount;
+    size_t CountPerThread;
+};
+
+inline
+const float*
+MlasBinaryOperationInput(
+    const float* Input,
+    MLAS_BINARY_BROADCAST_KIND Broadcast,
+    size_t OuterIndex,
+    size_t ChannelIndex,
+    size_t ChannelCount,
+    size_t InnerIndex,
+    size_t InnerCount
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the address of the input element that corresponds to
+    the supplied output position.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Broadcast - Supplies the broadcast kind of the input buffer.
+
+    OuterIndex - Supplies the outer index of the output position.
+
+    ChannelIndex - Supplies the channel index of the output position.
+
+    ChannelCount - Supplies the number of channels of the output.
+
+    InnerIndex - Supplies the inner index of the output position.
+
+    InnerCount - Supplies the number of inner elements of the output.
+
+Return Value:
+
+    Returns the address of the input element.
+
+--*/
+{
+    switch (Broadcast) {
+
+        case MlasNoBroadcast:
+            return Input + (OuterIndex * ChannelCount + ChannelIndex) * InnerCount + InnerIndex;
+
+        case MlasRowBroadcast:
+            return Input + ChannelIndex * InnerCount + InnerIndex;
+
+        case MlasChannelBroadcast:
+            return Input + ChannelIndex;
+
+        default:
+            return Input;
+    }
+}
+
+template<MLAS_BINARY_OPERATION_KIND OperationKind>
+void
+MlasComputeBinaryOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    binary operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_BINARY_OPERATION_WORK_BLOCK* WorkBlock = (MLAS_BINARY_OPERATION_WORK_BLOCK*)Context;
+
+    const MLAS_BINARY_BROADCAST_KIND BroadcastA = WorkBlock->BroadcastA;
+    const MLAS_BINARY_BROADCAST_KIND BroadcastB = WorkBlock->BroadcastB;
+    const size_t ChannelCount = WorkBlock->ChannelCount;
+    const size_t InnerCount = WorkBlock->InnerCount;
+
+    //
+    // Compute the range of output elements to use for this thread.
+    //
+
+    size_t Offset = WorkBlock->CountPerThread * size_t(Index);
+    size_t CountRemaining = WorkBlock->TotalCount - Offset;
+
+    if (CountRemaining > WorkBlock->CountPerThread) {
+        CountRemaining = WorkBlock->CountPerThread;
+    }
+
+    //
+    // A scalar or channel broadcast input supplies a single value for each
+    // span of inner elements.
+    //
+
+    const bool SpanBroadcastA = (BroadcastA == MlasScalarBroadcast || BroadcastA == MlasChannelBroadcast);
+    const bool SpanBroadcastB = (BroadcastB == MlasScalarBroadcast || BroadcastB == MlasChannelBroadcast);
+
+    size_t InnerIndex = Offset % InnerCount;
+    size_t ChannelIndex = (Offset / InnerCount) % ChannelCount;
+    size_t OuterIndex = Offset / (InnerCount * ChannelCount);
+
+    float* Output = WorkBlock->Output + Offset;
+
+    while (CountRemaining > 0) {
+
+        size_t CountThisSpan = InnerCount - InnerIndex;
+
+        if (CountThisSpan > CountRemaining) {
+            CountThisSpan = CountRemaining;
+        }
+
+        const float* InputA = MlasBinaryOperationInput(WorkBlock->InputA, BroadcastA,
+            OuterIndex, ChannelIndex, ChannelCount, InnerIndex, InnerCount);
+        const float* InputB = MlasBinaryOperationInput(WorkBlock->InputB, BroadcastB,
+            OuterIndex, ChannelIndex, ChannelCount, InnerIndex, InnerCount);
+
+        if (SpanBroadcastA) {
+            if (SpanBroadcastB) {
+                MlasComputeBinaryOperationSpan<OperationKind, true, true>(InputA, InputB, Output, CountThisSpan);
+            } else {
+                MlasComputeBinaryOperationSpan<OperationKind, true, false>(InputA, InputB, Output, CountThisSpan);
+            }
+        } else {
+            if (SpanBroadcastB) {
+                MlasComputeBinaryOperationSpan<OperationKind, false, true>(InputA, InputB, Output, CountThisSpan);
+            } else {
+                MlasComputeBinaryOperationSpan<OperationKind, false, false>(InputA, InputB, Output, CountThisSpan);
+            }
+        }
+
+        Output += CountThisSpan;
+        CountRemaining -= CountThisSpan;
+
+        InnerIndex = 0;
+
+        if (++ChannelIndex == ChannelCount) {
+            ChannelIndex = 0;
+            OuterIndex++;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasComputeBinaryOperation(
+    MLAS_BINARY_OPERATION_KIND OperationKind,
+    const float* InputA,
+    MLAS_BINARY_BROADCAST_KIND BroadcastA,
+    const float* InputB,
+    MLAS_BINARY_BROADCAST_KIND BroadcastB,
+    float* Output,
+    size_t OuterCount,
+    size_t ChannelCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a binary elementwise operation with broadcasting.
+
+    The output buffer is a tensor of shape [OuterCount, ChannelCount,
+    InnerCount]. Each input buffer is interpreted using its broadcast kind:
+
+        MlasNoBroadcast - The input has the same shape as the output.
+
+        MlasScalarBroadcast - The input is a single value.
+
+        MlasChannelBroadcast - The input has shape [ChannelCount] and each
+            value is repeated for the inner elements of the channel.
+
+        MlasRowBroadcast - The input has shape [ChannelCount, InnerCount] and is
+            repeated for each outer index.
+
+Arguments:
+
+    OperationKind - Supplies the kind of binary operation.
+
+    InputA - Supplies the first input buffer.
+
+    BroadcastA - Supplies the broadcast kind of the first input buffer.
+
+    InputB - Supplies the second input buffer.
+
+    BroadcastB - Supplies the broadcast kind of the second input buffer.
+
+    Output - Supplies the output buffer. The output buffer may alias an input
+        buffer that has the same shape as the output.
+
+    OuterCount - Supplies the outer count of the output.
+
+    ChannelCount - Supplies the channel count of the output.
+
+    InnerCount - Supplies the inner count of the output.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t TotalCount = OuterCount * ChannelCount * InnerCount;
+
+    if (TotalCount == 0) {
+        return;
+    }
+
+    PMLAS_THREADED_ROUTINE ThreadedRoutine;
+
+    switch (OperationKind) {
+
+        case MlasAddBinaryOperation:
+            ThreadedRoutine = MlasComputeBinaryOperationThreaded<MlasAddBinaryOperation>;
+            break;
+
+        case MlasSubtractBinaryOperation:
+            ThreadedRoutine = MlasComputeBinaryOperationThreaded<MlasSubtractBinaryOperation>;
+            break;
+
+        case MlasMultiplyBinaryOperation:
+            ThreadedRoutine = MlasComputeBinaryOperationThreaded<MlasMultiplyBinaryOperation>;
+            break;
+
+        case MlasDivideBinaryOperation:
+            ThreadedRoutine = MlasComputeBinaryOperationThreaded<MlasDivideBinaryOperation>;
+            break;
+
+        case MlasMaximumBinaryOperation:
+            ThreadedRoutine = MlasComputeBinaryOperationThreaded<MlasMaximumBinaryOperation>;
+            break;
+
+        case MlasMinimumBinaryOperation:
+            ThreadedRoutine = MlasComputeBinaryOperationThreaded<MlasMinimumBinaryOperation>;
+            break;
+
+        default:
+            return;
+    }
+
+    MLAS_BINARY_OPERATION_WORK_BLOCK WorkBlock;
+
+    WorkBlock.InputA = InputA;
+    WorkBlock.InputB = InputB;
+    WorkBlock.Output = Output;
+    WorkBlock.BroadcastA = BroadcastA;
+    WorkBlock.BroadcastB = BroadcastB;
+    WorkBlock.ChannelCount = ChannelCount;
+    WorkBlock.InnerCount = InnerCount;
+    WorkBlock.TotalCount = TotalCount;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation.
+    //
+
+    int32_t TargetThreadCount;
+
+    if (TotalCount < size_t(MLAS_BINARY_THREAD_COMPLEXITY) * MLAS_MAXIMUM_THREAD_COUNT) {
+        TargetThreadCount = int32_t(TotalCount / MLAS_BINARY_THREAD_COMPLEXITY) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount <= 1) {
+        WorkBlock.CountPerThread = TotalCount;
+        ThreadedRoutine(&WorkBlock, 0);
+        return;
+    }
+
+    //
+    // Partition the output into blocks that are a multiple of the cache line
+    // size so that threads do not write to the same cache lines.
+    //
+
+    constexpr size_t BlockAlignment = 64 / sizeof(float);
+
+    size_t CountPerThread = (TotalCount + TargetThreadCount - 1) / TargetThreadCount;
+    CountPerThread = (CountPerThread + BlockAlignment - 1) & ~(BlockAlignment - 1);
+
+    WorkBlock.CountPerThread = CountPerThread;
+
+    TargetThreadCount = int32_t((TotalCount + CountPerThread - 1) / CountPerThread);
+
+    MlasExecuteThreaded(ThreadedRoutine, &WorkBlock, TargetThreadCount, ThreadPool);
+}
@@ -0,0 +1,758 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements miscellaneous computation routines.
+
+    Our usage requires building platform specific versions of the algorithm to
+    target different instruction sets. The implementation below targets the
+    base instruction set (typically SSE2) while assembly implementations target
+    newer instruction sets (such as FMA3 and AVX512F).
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+//
+// Bundles the constants for use by kernels written in assembly.
+//
+// The exponential function is computed by reducing the argument to the range
+// [-ln2/2, ln2/2] as r = x - m * ln2 where m = round(x / ln2), evaluating a
+// polynomial approximation of exp(r), and then scaling the result by 2^m. The
+// scaling is split into two steps to produce results in the denormal range.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float LowerRange;
+    float UpperRange;
+    float RoundingBias;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_56;
+    float MinimumExponent;
+    float MaximumExponent;
+} MlasExpConstants = {
+    -103.9720840454f,
+    88.7762626647950f,
+    12582912.0f,
+    1.44269504088896341f,
+    -6.93145752e-1f,
+    -1.42860677e-6f,
+    1.378059387e-03f,
+    8.373124525e-03f,
+    4.166953638e-02f,
+    1.666647196e-01f,
+    4.999998510e-01f,
+    1.0f,
+    -126.0f,
+    127.0f,
+};
+
+//
+// Stores the thread info for softmax operations.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    bool LogSoftmax;
+    int32_t TargetThreadCount;
+};
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpVector(
+    MLAS_FLOAT32X4 Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of elements.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+Return Value:
+
+    Returns the exponential function of each element of the input vector.
+
+--*/
+{
+    Vector = MlasMaximumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.LowerRange), Vector);
+    Vector = MlasMinimumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.UpperRange), Vector);
+
+    //
+    // Compute m = round(x / ln2) and the reduced argument r = x - m * ln2. The
+    // natural logarithm of two is split into high and low parts to preserve
+    // the precision of the reduced argument.
+    //
+
+    const MLAS_FLOAT32X4 RoundingBias = MlasBroadcastFloat32x4(MlasExpConstants.RoundingBias);
+
+    MLAS_FLOAT32X4 Exponent = MlasMultiplyAddFloat32x4(Vector,
+        MlasBroadcastFloat32x4(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    Exponent = MlasSubtractFloat32x4(Exponent, RoundingBias);
+
+    Vector = MlasMultiplyAddFloat32x4(Exponent, MlasBroadcastFloat32x4(MlasExpConstants.Log2High), Vector);
+    Vector = MlasMultiplyAddFloat32x4(Exponent, MlasBroadcastFloat32x4(MlasExpConstants.Log2Low), Vector);
+
+    MLAS_FLOAT32X4 p;
+    p = MlasMultiplyAddFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.poly_0), Vector,
+        MlasBroadcastFloat32x4(MlasExpConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_56));
+    p = MlasMultiplyAddFloat32x4(p, Vector, MlasBroadcastFloat32x4(MlasExpConstants.poly_56));
+
+    //
+    // Scale the polynomial by 2^m. The exponent is split into a normal part
+    // and an overflow part so that 2^m is representable for each step.
+    //
+
+    MLAS_FLOAT32X4 Normal;
+    Normal = MlasMaximumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.MinimumExponent), Exponent);
+    Normal = MlasMinimumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.MaximumExponent), Normal);
+
+    MLAS_FLOAT32X4 Overflow = MlasSubtractFloat32x4(Exponent, Normal);
+
+    p = MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(Overflow));
+    p = MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(Normal));
+
+    return p;
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x4(
+    MLAS_FLOAT32X4 Vector
+    )
+{
+    MLAS_DECLSPEC_ALIGN(float Buffer[4], 16);
+
+    MlasStoreAlignedFloat32x4(Buffer, Vector);
+
+    return (Buffer[0] + Buffer[1]) + (Buffer[2] + Buffer[3]);
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceMaximumFloat32x4(
+    MLAS_FLOAT32X4 Vector
+    )
+{
+    MLAS_DECLSPEC_ALIGN(float Buffer[4], 16);
+
+    MlasStoreAlignedFloat32x4(Buffer, Vector);
+
+    return (std::max)((std::max)(Buffer[0], Buffer[1]), (std::max)(Buffer[2], Buffer[3]));
+}
+
+void
+MLASCALL
+MlasComputeExpF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasComputeExpVector(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    if (N > 0) {
+
+        MLAS_DECLSPEC_ALIGN(float Buffer[4], 16);
+
+        for (size_t n = 0; n < N; n++) {
+            Buffer[n] = Input[n];
+        }
+
+        MlasStoreAlignedFloat32x4(Buffer, MlasComputeExpVector(MlasLoadFloat32x4(Buffer)));
+
+        for (size_t n = 0; n < N; n++) {
+            Output[n] = Buffer[n];
+        }
+    }
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for computing the sum of the
+    exponential function of the biased input elements.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. When used for Softmax,
+        the output buffer is used to store the intermediate exp() results. When
+        used for LogSoftmax, the intermediate exp() results are not required.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the address of the negative maximum value that
+        is added to each element before computing the exponential function.
+
+Return Value:
+
+    Returns the sum of the exponential function of the biased elements.
+
+--*/
+{
+    const MLAS_FLOAT32X4 Bias = MlasBroadcastFloat32x4(*NegativeMaximum);
+
+    MLAS_FLOAT32X4 Accumulator = MlasZeroFloat32x4();
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasComputeExpVector(MlasAddFloat32x4(MlasLoadFloat32x4(Input), Bias));
+
+        if (Output != nullptr) {
+            MlasStoreFloat32x4(Output, Vector);
+            Output += 4;
+        }
+
+        Accumulator = MlasAddFloat32x4(Accumulator, Vector);
+
+        Input += 4;
+        N -= 4;
+    }
+
+    float Accumulation = MlasReduceAddFloat32x4(Accumulator);
+
+    if (N > 0) {
+
+        MLAS_DECLSPEC_ALIGN(float Buffer[4], 16);
+
+        for (size_t n = 0; n < N; n++) {
+            Buffer[n] = Input[n];
+        }
+
+        MLAS_FLOAT32X4 Vector = MlasComputeExpVector(MlasAddFloat32x4(MlasLoadFloat32x4(Buffer), Bias));
+
+        MlasStoreAlignedFloat32x4(Buffer, Vector);
+
+        for (size_t n = 0; n < N; n++) {
+
+            if (Output != nullptr) {
+                Output[n] = Buffer[n];
+            }
+
+            Accumulation += Buffer[n];
+        }
+    }
+
+    return Accumulation;
+}
+
+float
+MLASCALL
+MlasReduceMaximumF32Kernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to find the maximum value of
+    the supplied buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value of the supplied buffer.
+
+--*/
+{
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 MaximumVector = MlasBroadcastFloat32x4(Maximum);
+
+        while (N >= 4) {
+
+            MaximumVector = MlasMaximumFloat32x4(MaximumVector, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Maximum = MlasReduceMaximumFloat32x4(MaximumVector);
+    }
+
+    while (N > 0) {
+
+        Maximum = (std::max)(Maximum, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Maximum;
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxOutputF32Kernel(
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to produce the final output for
+    the softmax operation.
+
+Arguments:
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the scale value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float Scale = Parameters[0];
+
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output), ScaleVector));
+
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output *= Scale;
+
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeLogSoftmaxOutputF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to produce the final output for
+    the log softmax operation.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the negative maximum and
+        logarithm values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float NegativeMaximum = Parameters[0];
+    const float Logarithm = Parameters[1];
+
+    const MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(NegativeMaximum);
+    const MLAS_FLOAT32X4 LogarithmVector = MlasBroadcastFloat32x4(Logarithm);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector);
+        MlasStoreFloat32x4(Output, MlasSubtractFloat32x4(Vector, LogarithmVector));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output = (*Input + NegativeMaximum) - Logarithm;
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ComputeExpF32Kernel(Input, Output, N);
+#else
+    MlasComputeExpF32Kernel(Input, Output, N);
+#endif
+}
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_SOFTMAX_WORK_BLOCK* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    //
+    // Compute the range of rows to use for this thread.
+    //
+
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
+
+    const size_t CountPerThread = N / TargetThreadCount;
+    const size_t CountExtra = N % TargetThreadCount;
+
+    size_t n;
+    size_t CountN;
+
+    if (uint32_t(Index) < CountExtra) {
+        n = (CountPerThread + 1) * Index;
+        CountN = CountPerThread + 1;
+    } else {
+        n = CountPerThread * Index + CountExtra;
+        CountN = CountPerThread;
+    }
+
+    const float* Input = WorkBlock->Input + n * D;
+    float* Output = WorkBlock->Output + n * D;
+
+    //
+    // Compute each row with a pass to find the maximum value, a pass to
+    // accumulate the exponential function of the biased values, and a pass to
+    // produce the final output.
+    //
+
+    while (CountN > 0) {
+
+#if defined(MLAS_TARGET_AMD64)
+        float Maximum = MlasPlatform.ReduceMaximumF32Kernel(Input, D);
+#else
+        float Maximum = MlasReduceMaximumF32Kernel(Input, D);
+#endif
+        float NegativeMaximum = -Maximum;
+
+        if (WorkBlock->LogSoftmax) {
+
+#if defined(MLAS_TARGET_AMD64)
+            float Accumulation = MlasPlatform.ComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#else
+            float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#endif
+
+            float Parameters[] = { NegativeMaximum, std::log(Accumulation) };
+
+#if defined(MLAS_TARGET_AMD64)
+            MlasPlatform.ComputeLogSoftmaxOutputF32Kernel(Input, Output, D, Parameters);
+#else
+            MlasComputeLogSoftmaxOutputF32Kernel(Input, Output, D, Parameters);
+#endif
+
+        } else {
+
+#if defined(MLAS_TARGET_AMD64)
+            float Accumulation = MlasPlatform.ComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
+#else
+            float Accumulation = MlasComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
+#endif
+
+            float Parameters[] = { 1.0f / Accumulation };
+
+#if defined(MLAS_TARGET_AMD64)
+            MlasPlatform.ComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
+#else
+            MlasComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
+#endif
+        }
+
+        Input += D;
+        Output += D;
+        CountN--;
+    }
+}
+
+void
+MlasComputeSoftmaxOperation(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function of each row of
+    the input buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.LogSoftmax = LogSoftmax;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Each thread is given at least one row to process.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= N) {
+        TargetThreadCount = int32_t(N);
+    }
+
+    if (TargetThreadCount <= 1) {
+        WorkBlock.TargetThreadCount = 1;
+        MlasComputeSoftmaxThreaded(&WorkBlock, 0);
+        return;
+    }
+
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax function of each row of the input
+    buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeSoftmaxOperation(Input, Output, N, D, false, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeLogSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the log softmax function of each row of the input
+    buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeSoftmaxOperation(Input, Output, N, D, true, ThreadPool);
+}
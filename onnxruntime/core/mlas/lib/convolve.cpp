@@ -592,7 +592,7 @@ Return Value:
 
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, nullptr);
 
             beta = 1.0f;
         }
@@ -719,7 +719,7 @@ Return Value:
 
         MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
             OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
-            output, OutputSize);
+            output, OutputSize, nullptr);
 
         //
         // Apply the activation with optional bias.
@@ -432,6 +432,47 @@ void
 
 typedef MLAS_ELEMENTWISE_KERNEL_ROUTINE* PMLAS_ELEMENTWISE_KERNEL_ROUTINE;
 
+typedef
+float
+(MLASCALL MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL)(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    );
+
+typedef MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* PMLAS_COMPUTE_SUMEXP_FLOAT_KERNEL;
+
+typedef
+float
+(MLASCALL MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL)(
+    const float* Input,
+    size_t N
+    );
+
+typedef MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL* PMLAS_REDUCE_MAXIMUM_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL)(
+    float* Output,
+    size_t N,
+    const float* Parameters
+    );
+
+typedef MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL* PMLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL)(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    );
+
+typedef MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* PMLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL;
+
 extern "C" {
 
 #if defined(MLAS_TARGET_AMD64_IX86)
@@ -531,6 +572,22 @@ extern "C" {
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasErfKernelFma3;
 #endif
 
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasComputeExpF32Kernel;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32Kernel;
+    MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32Kernel;
+    MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32Kernel;
+    MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasComputeExpF32KernelFma3;
+    MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasComputeExpF32KernelAvx512F;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelFma3;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelAvx512F;
+    MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32KernelAvx;
+    MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32KernelAvx512F;
+    MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32KernelAvx;
+    MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32KernelAvx;
+#endif
+
 }
 
 //
@@ -571,6 +628,20 @@ extern "C" {
 
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (64 * 1024)
 
+//
+// Define the target number of per-thread elements before using another thread
+// to perform additional work for the softmax routines.
+//
+
+#define MLAS_SOFTMAX_THREAD_COMPLEXITY              (16 * 1024)
+
+//
+// Define the target number of per-thread elements before using another thread
+// to perform additional work for the binary elementwise routines.
+//
+
+#define MLAS_BINARY_THREAD_COMPLEXITY               (64 * 1024)
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -589,7 +660,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     );
 
 //
@@ -624,6 +696,11 @@ struct MLAS_PLATFORM {
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE LogisticKernelRoutine;
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE TanhKernelRoutine;
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE ErfKernelRoutine;
+    PMLAS_ELEMENTWISE_KERNEL_ROUTINE ComputeExpF32Kernel;
+    PMLAS_COMPUTE_SUMEXP_FLOAT_KERNEL ComputeSumExpF32Kernel;
+    PMLAS_REDUCE_MAXIMUM_FLOAT_KERNEL ReduceMaximumF32Kernel;
+    PMLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL ComputeSoftmaxOutputF32Kernel;
+    PMLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL ComputeLogSoftmaxOutputF32Kernel;
     uint32_t NchwcBlockSize;
     uint32_t PreferredBufferAlignment;
 #endif
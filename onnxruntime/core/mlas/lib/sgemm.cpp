@@ -40,15 +40,51 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const float* PackedB;
+    size_t AlignedN;
+    const MLAS_SGEMM_EPILOGUE* Epilogue;
     struct SEGMENT {
         size_t M;
         size_t N;
+        size_t RangeStartM;
+        size_t RangeStartN;
         const float* A;
         const float* B;
         float* C;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute a batch of SGEMM operations on worker
+// threads.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const float* A;
+    size_t lda;
+    size_t StrideA;
+    const float* B;
+    size_t ldb;
+    size_t StrideB;
+    const float* PackedB;
+    size_t AlignedN;
+    float beta;
+    float* C;
+    size_t ldc;
+    size_t StrideC;
+    size_t BatchSize;
+    size_t SegmentsPerGemm;
+    size_t ThreadStrideM;
+    size_t ThreadStrideN;
+    int32_t TargetThreadCount;
+};
+
 void
 MlasSgemmMultiplyBeta(
     float* C,
@@ -762,6 +798,294 @@ Return Value:
     }
 }
 
+inline
+MLAS_SGEMM_EPILOGUE
+MlasSgemmOffsetEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    size_t StartN
+    )
+/*++
+
+Routine Description:
+
+    This routine adjusts the epilogue of a SGEMM operation to apply to the
+    block of the output matrix that starts at the specified row and column.
+
+Arguments:
+
+    Epilogue - Supplies the epilogue for the whole output matrix.
+
+    StartM - Supplies the starting row of the block.
+
+    StartN - Supplies the starting column of the block.
+
+Return Value:
+
+    Returns the epilogue for the block.
+
+--*/
+{
+    MLAS_SGEMM_EPILOGUE BlockEpilogue = *Epilogue;
+
+    if (BlockEpilogue.Bias != nullptr) {
+        BlockEpilogue.Bias += StartN;
+    }
+
+    if (BlockEpilogue.Addend != nullptr) {
+        BlockEpilogue.Addend += StartM * BlockEpilogue.ldaddend + StartN;
+    }
+
+    return BlockEpilogue;
+}
+
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    size_t StartM,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the epilogue of a SGEMM operation to a block of rows
+    of the output matrix that was just produced by the kernel and is still
+    cache resident.
+
+Arguments:
+
+    Epilogue - Supplies the epilogue adjusted for the columns of the block.
+
+    StartM - Supplies the starting row of the block relative to the epilogue.
+
+    C - Supplies the address of the block of the output matrix.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* Bias = Epilogue->Bias;
+    const float* Addend = Epilogue->Addend;
+
+    if (Bias != nullptr || Addend != nullptr) {
+
+        float* c = C;
+
+        if (Addend != nullptr) {
+            Addend += StartM * Epilogue->ldaddend;
+        }
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            size_t n = 0;
+
+            for (; n + 4 <= CountN; n += 4) {
+
+                MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(&c[n]);
+
+                if (Bias != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(&Bias[n]));
+                }
+
+                if (Addend != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(&Addend[n]));
+                }
+
+                MlasStoreFloat32x4(&c[n], Vector);
+            }
+
+            for (; n < CountN; n++) {
+
+                float Value = c[n];
+
+                if (Bias != nullptr) {
+                    Value += Bias[n];
+                }
+
+                if (Addend != nullptr) {
+                    Value += Addend[n];
+                }
+
+                c[n] = Value;
+            }
+
+            c += ldc;
+
+            if (Addend != nullptr) {
+                Addend += Epilogue->ldaddend;
+            }
+        }
+    }
+
+    if (Epilogue->Activation != nullptr) {
+        MlasActivation(Epilogue->Activation, C, nullptr, CountM, CountN, ldc);
+    }
+}
+
+inline
+void
+MlasSgemmKernelLoop(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A by a packed panel of matrix B
+    and accumulates the result into matrix C.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the packed panel and matrix C.
+
+    CountK - Supplies the number of columns of the slice of matrix A and the
+        number of rows of the packed panel.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+    Epilogue - Supplies the epilogue to apply to each block of rows as it is
+        completed, else nullptr if this is not the last slice along the K
+        dimension.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+    const float* a = A;
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+    size_t RowsCompleted = 0;
+
+    if (TransA == CblasNoTrans) {
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, RowsCompleted, c, RowsHandled, CountN, ldc);
+            }
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+            RowsCompleted += RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                if (Epilogue != nullptr) {
+                    MlasSgemmApplyEpilogue(Epilogue, RowsCompleted, c, RowsHandled, CountN, ldc);
+                }
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+                RowsCompleted += RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -776,7 +1100,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -814,13 +1139,14 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the epilogue to apply to matrix C, else nullptr.
+
 Return Value:
 
     None.
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
     //
@@ -842,7 +1168,13 @@ Return Value:
         }
 
         if (SgemmKernelM1Routine != nullptr) {
+
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, 0, C, 1, N, ldc);
+            }
+
             return;
         }
 
@@ -899,6 +1231,16 @@ Return Value:
             MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
         }
 
+        //
+        // Adjust the epilogue for this slice of columns.
+        //
+
+        MLAS_SGEMM_EPILOGUE SliceEpilogue;
+
+        if (Epilogue != nullptr) {
+            SliceEpilogue = MlasSgemmOffsetEpilogue(Epilogue, 0, n);
+        }
+
         //
         // Step through each slice of matrix B along the K dimension.
         //
@@ -927,99 +1269,163 @@ Return Value:
             // Step through each slice of matrix A along the M dimension.
             //
 
-            float* c = C + n;
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+            //
+            // Apply the epilogue while computing the last slice along the K
+            // dimension.
+            //
 
-            if (TransA == CblasNoTrans) {
+            const MLAS_SGEMM_EPILOGUE* KernelEpilogue =
+                (Epilogue != nullptr && k + CountK == K) ? &SliceEpilogue : nullptr;
 
-                const float* a = A + k;
+            MlasSgemmKernelLoop(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode, KernelEpilogue);
+        }
+    }
+}
 
-                //
-                // Step through the rows of matrix A.
-                //
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
 
-                do {
+Routine Description:
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
-#else
-                    if (ZeroMode) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B that was packed by MlasGemmPackB.
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+Arguments:
 
-                    RowsRemaining -= RowsHandled;
+    TransA - Supplies the transpose operation for matrix A.
 
-                } while (RowsRemaining > 0);
+    M - Supplies the number of rows of matrix A and matrix C.
 
-            } else {
+    RangeStartN - Supplies the starting column from the packed matrix B.
 
-                const float* a = A + k * lda;
+    RangeCountN - Supplies the number of columns from the packed matrix B and
+        matrix C.
 
-                do {
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
 
-                    size_t RowsTransposed = RowsRemaining;
+    A - Supplies the address of matrix A.
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+    lda - Supplies the first dimension of matrix A.
 
-                    RowsRemaining -= RowsTransposed;
+    PackedB - Supplies the address of the packed matrix B.
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+    AlignedN - Supplies the number of columns of the packed matrix B rounded
+        up to the packed block width.
 
-                    a += RowsTransposed;
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+    C - Supplies the address of matrix C.
 
-                    const float* pa = PanelA;
+    ldc - Supplies the first dimension of matrix C.
 
-                    do {
+    Epilogue - Supplies the epilogue to apply to matrix C, else nullptr.
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
-#else
-                        if (ZeroMode) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
+Return Value:
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+    None.
 
-                        RowsTransposed -= RowsHandled;
+--*/
+{
+    //
+    // The packed matrix B was produced using the default strides, so these
+    // cannot be adjusted here based on the shape of the operation.
+    //
 
-                    } while (RowsTransposed > 0);
+    size_t CountN;
+    size_t CountK;
 
-                } while (RowsRemaining > 0);
-            }
-        }
-    }
-}
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
 
-void
-MlasSgemmOperationThreaded(
-    void* Context,
-    int32_t Index
-    )
-/*++
+        CountN = MLAS_SGEMM_STRIDEN;
 
-Routine Description:
+        if (CountN > (RangeCountN - n)) {
+            CountN = RangeCountN - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Adjust the epilogue for this slice of columns.
+        //
+
+        MLAS_SGEMM_EPILOGUE SliceEpilogue;
+
+        if (Epilogue != nullptr) {
+            SliceEpilogue = MlasSgemmOffsetEpilogue(Epilogue, 0, n);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            bool ZeroMode = (k == 0 && beta == 0.0f);
+
+            CountK = MLAS_SGEMM_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            //
+            // Each slice of matrix B along the K dimension stores AlignedN
+            // columns of CountK rows, so the panel for this slice of columns
+            // is already in place.
+            //
+
+            const float* PanelB = PackedB + AlignedN * k + CountK * (RangeStartN + n);
+
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
+
+            //
+            // Apply the epilogue while computing the last slice along the K
+            // dimension.
+            //
+
+            const MLAS_SGEMM_EPILOGUE* KernelEpilogue =
+                (Epilogue != nullptr && k + CountK == K) ? &SliceEpilogue : nullptr;
+
+            MlasSgemmKernelLoop(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode, KernelEpilogue);
+        }
+    }
+}
+
+void
+MlasSgemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
 
     This routine is invoked from a worker thread to execute a segment of a
     SGEMM operation.
@@ -1040,10 +1446,33 @@ Return Value:
 
     MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
 
-    MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
-        Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
-        Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+    //
+    // Adjust the epilogue for the block of the output matrix computed by this
+    // segment.
+    //
+
+    MLAS_SGEMM_EPILOGUE SegmentEpilogue;
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr;
+
+    if (WorkBlock->Epilogue != nullptr) {
+        SegmentEpilogue = MlasSgemmOffsetEpilogue(WorkBlock->Epilogue, Segment->RangeStartM, Segment->RangeStartN);
+        Epilogue = &SegmentEpilogue;
+    }
+
+    if (WorkBlock->PackedB != nullptr) {
+
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M,
+            Segment->RangeStartN, Segment->N, WorkBlock->K, WorkBlock->alpha,
+            Segment->A, WorkBlock->lda, WorkBlock->PackedB, WorkBlock->AlignedN,
+            WorkBlock->beta, Segment->C, WorkBlock->ldc, Epilogue);
+
+    } else {
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc, Epilogue);
+    }
 }
 
 inline
@@ -1059,9 +1488,11 @@ MlasSgemmTryMultithread(
     size_t lda,
     const float* B,
     size_t ldb,
+    const float* PackedB,
     float beta,
     float* C,
     size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1094,12 +1525,17 @@ Arguments:
 
     ldb - Supplies the first dimension of matrix B.
 
+    PackedB - Supplies the address of matrix B packed by MlasGemmPackB, else
+        nullptr if matrix B is not packed.
+
     beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
     C - Supplies the address of matrix C.
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the epilogue to apply to matrix C, else nullptr.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1148,6 +1584,9 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.PackedB = PackedB;
+    WorkBlock.Epilogue = Epilogue;
+    WorkBlock.AlignedN = (N + 15) & ~size_t(15);
 
     //
     // Segment the operation across multiple threads.
@@ -1178,8 +1617,10 @@ Return Value:
 
             WorkBlock.Segments[Index].M = M;
             WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].RangeStartM = 0;
+            WorkBlock.Segments[Index].RangeStartN = n;
             WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
+            WorkBlock.Segments[Index].B = (B != nullptr) ? B + n * pldb : nullptr;
             WorkBlock.Segments[Index].C = C + n;
 
             Index++;
@@ -1205,6 +1646,8 @@ Return Value:
 
             WorkBlock.Segments[Index].M = CountM;
             WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].RangeStartM = m;
+            WorkBlock.Segments[Index].RangeStartN = 0;
             WorkBlock.Segments[Index].A = A + m * plda;
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
@@ -1234,6 +1677,7 @@ MlasGemm(
     float beta,
     float* C,
     size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1241,7 +1685,8 @@ MlasGemm(
 Routine Description:
 
     This routine implements the single precision matrix/matrix multiply
-    operation (SGEMM).
+    operation (SGEMM) and applies the optional epilogue to each block of the
+    output matrix as it is completed.
 
 Arguments:
 
@@ -1272,6 +1717,227 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Supplies the optional bias, addend and activation to apply to
+        matrix C, else nullptr (see MLAS_SGEMM_EPILOGUE).
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, nullptr, beta, C, ldc, Epilogue, ThreadPool)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, Epilogue);
+    }
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM).
+
+Arguments:
+
+    See the overload of MlasGemm that accepts an epilogue.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack a matrix B
+    using MlasGemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes of the packed buffer.
+
+--*/
+{
+    //
+    // Columns of matrix B are packed in blocks of 16 elements with the last
+    // block zero padded. Round the buffer size up to the preferred alignment
+    // so that callers can carve the packed buffer out of a larger allocation.
+    //
+
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+
+    size_t BytesRequired = AlignedN * K * sizeof(float);
+
+    return (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the contents of matrix B to the layout consumed by the
+    SGEMM kernels, so that the packing cost is paid once for a matrix B that
+    is multiplied many times.
+
+    The packed buffer stores slices of MLAS_SGEMM_STRIDEK rows. Each slice
+    stores the columns of matrix B in blocks of 16 elements, with the last
+    block zero padded.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer. The buffer must be
+        at least MlasGemmPackBSize bytes and aligned to the value returned by
+        MlasGetPreferredBufferAlignment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    float* D = (float*)PackedB;
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += AlignedN * CountK;
+    }
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B that was packed by MlasGemmPackB, and
+    applies the optional epilogue to each block of the output matrix as it is
+    completed.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Epilogue - Supplies the optional bias, addend and activation to apply to
+        matrix C, else nullptr (see MLAS_SGEMM_EPILOGUE).
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1281,12 +1947,510 @@ Return Value:
 
 --*/
 {
+    const float* PackedBuffer = (const float*)PackedB;
+
     //
     // Try to run the operation across multiple threads or fall back to a
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, nullptr, 0, PackedBuffer, beta, C, ldc, Epilogue, ThreadPool)) {
+        const size_t AlignedN = (N + 15) & ~size_t(15);
+        MlasSgemmPackedOperation(TransA, M, 0, N, K, alpha, A, lda, PackedBuffer, AlignedN, beta, C, ldc, Epilogue);
     }
 }
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a matrix B that was packed by MlasGemmPackB.
+
+Arguments:
+
+    See the overload of MlasGemm that accepts an epilogue.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MlasSgemmBatchSegment(
+    const MLAS_SGEMM_BATCH_WORK_BLOCK* WorkBlock,
+    size_t Batch,
+    size_t RangeStartM,
+    size_t RangeStartN,
+    size_t RangeCountM,
+    size_t RangeCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of the output matrix of one operation of a
+    batched SGEMM operation.
+
+Arguments:
+
+    WorkBlock - Supplies the parameters of the batched operation.
+
+    Batch - Supplies the index of the operation in the batch.
+
+    RangeStartM - Supplies the starting row of the block.
+
+    RangeStartN - Supplies the starting column of the block.
+
+    RangeCountM - Supplies the number of rows of the block.
+
+    RangeCountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+
+    const float* A = WorkBlock->A + Batch * WorkBlock->StrideA + RangeStartM * plda;
+    float* C = WorkBlock->C + Batch * WorkBlock->StrideC + RangeStartM * WorkBlock->ldc + RangeStartN;
+
+    if (WorkBlock->PackedB != nullptr) {
+
+        MlasSgemmPackedOperation(WorkBlock->TransA, RangeCountM, RangeStartN,
+            RangeCountN, WorkBlock->K, WorkBlock->alpha, A, WorkBlock->lda,
+            WorkBlock->PackedB, WorkBlock->AlignedN, WorkBlock->beta, C,
+            WorkBlock->ldc, nullptr);
+
+    } else {
+
+        const size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : WorkBlock->ldb;
+
+        const float* B = WorkBlock->B + Batch * WorkBlock->StrideB + RangeStartN * pldb;
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, RangeCountM,
+            RangeCountN, WorkBlock->K, WorkBlock->alpha, A, WorkBlock->lda, B,
+            WorkBlock->ldb, WorkBlock->beta, C, WorkBlock->ldc, nullptr);
+    }
+}
+
+void
+MlasSgemmBatchThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute the segments of
+    a batched SGEMM operation assigned to the thread.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_BATCH_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
+
+    //
+    // Compute the range of segments to use for this thread. Each operation
+    // of the batch is split into SegmentsPerGemm segments along either the M
+    // or the N dimension.
+    //
+
+    const size_t SegmentCount = WorkBlock->BatchSize * WorkBlock->SegmentsPerGemm;
+
+    const size_t TargetThreadCount = size_t(WorkBlock->TargetThreadCount);
+
+    const size_t SegmentCountPerThread = SegmentCount / TargetThreadCount;
+    const size_t SegmentCountExtra = SegmentCount % TargetThreadCount;
+
+    size_t SegmentStart;
+    size_t SegmentEnd;
+
+    if (uint32_t(Index) < SegmentCountExtra) {
+        SegmentStart = (SegmentCountPerThread + 1) * Index;
+        SegmentEnd = SegmentStart + SegmentCountPerThread + 1;
+    } else {
+        SegmentStart = SegmentCountPerThread * Index + SegmentCountExtra;
+        SegmentEnd = SegmentStart + SegmentCountPerThread;
+    }
+
+    //
+    // Iterate over the segments allocated to this thread. The packing
+    // buffers of the SGEMM operation are reused across the segments.
+    //
+
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+
+    for (size_t segment = SegmentStart; segment < SegmentEnd; segment++) {
+
+        const size_t batch = segment / WorkBlock->SegmentsPerGemm;
+        const size_t slice = segment % WorkBlock->SegmentsPerGemm;
+
+        size_t m = slice * WorkBlock->ThreadStrideM;
+        size_t n = slice * WorkBlock->ThreadStrideN;
+
+        if (m >= M || n >= N) {
+            continue;
+        }
+
+        size_t CountM = (WorkBlock->ThreadStrideM != 0) ? WorkBlock->ThreadStrideM : M;
+        size_t CountN = (WorkBlock->ThreadStrideN != 0) ? WorkBlock->ThreadStrideN : N;
+
+        if (CountM > (M - m)) {
+            CountM = M - m;
+        }
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        MlasSgemmBatchSegment(WorkBlock, batch, m, n, CountM, CountN);
+    }
+}
+
+void
+MlasSgemmBatchSchedule(
+    MLAS_SGEMM_BATCH_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine partitions a batched SGEMM operation across threads and
+    executes it.
+
+Arguments:
+
+    WorkBlock - Supplies the parameters of the batched operation. The fields
+        that describe the partitioning are filled in by this routine.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+    const size_t BatchSize = WorkBlock->BatchSize;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // whole batch. Small requests should run using the single threaded path.
+    //
+
+    int32_t TargetThreadCount;
+
+    double Complexity = double(M) * double(N) * double(WorkBlock->K) * double(BatchSize);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        for (size_t batch = 0; batch < BatchSize; batch++) {
+            MlasSgemmBatchSegment(WorkBlock, batch, 0, 0, M, N);
+        }
+
+        return;
+    }
+
+    WorkBlock->ThreadStrideM = 0;
+    WorkBlock->ThreadStrideN = 0;
+
+    //
+    // Split each operation into segments if the batch is too small to keep
+    // the target threads busy. The segments slice the larger of the M and N
+    // dimensions (see MlasSgemmTryMultithread). The slices along the N
+    // dimension are aligned to the packed block width, as required for a
+    // packed matrix B.
+    //
+
+    size_t SegmentsPerGemm = (size_t(TargetThreadCount) + BatchSize - 1) / BatchSize;
+
+    if (SegmentsPerGemm > 1) {
+
+        if (N > M) {
+
+            size_t StrideN = (N + SegmentsPerGemm - 1) / SegmentsPerGemm;
+
+            StrideN =
+                (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+            SegmentsPerGemm = (N + StrideN - 1) / StrideN;
+            WorkBlock->ThreadStrideN = StrideN;
+
+        } else {
+
+            size_t StrideM = (M + SegmentsPerGemm - 1) / SegmentsPerGemm;
+
+            SegmentsPerGemm = (M + StrideM - 1) / StrideM;
+            WorkBlock->ThreadStrideM = StrideM;
+        }
+    }
+
+    WorkBlock->SegmentsPerGemm = SegmentsPerGemm;
+
+    size_t SegmentCount = BatchSize * SegmentsPerGemm;
+
+    if (size_t(TargetThreadCount) > SegmentCount) {
+        TargetThreadCount = int32_t(SegmentCount);
+    }
+
+    WorkBlock->TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasSgemmBatchThreaded, WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix
+    multiply operations (SGEMM) where the matrices of each operation are
+    found at a fixed stride from the matrices of the previous operation.
+
+    The batch is partitioned across threads as a whole, so that a batch of
+    small operations runs in a single parallel region instead of dispatching
+    each operation to the threads separately.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    StrideA - Supplies the number of elements between each matrix A. Zero
+        broadcasts the first matrix A to each operation.
+
+    B - Supplies the address of the first matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    StrideB - Supplies the number of elements between each matrix B. Zero
+        broadcasts the first matrix B to each operation.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of the first matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StrideC - Supplies the number of elements between each matrix C.
+
+    BatchSize - Supplies the number of operations in the batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchSize == 0) {
+        return;
+    }
+
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.StrideA = StrideA;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.StrideB = StrideB;
+    WorkBlock.PackedB = nullptr;
+    WorkBlock.AlignedN = 0;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.StrideC = StrideC;
+    WorkBlock.BatchSize = BatchSize;
+
+    MlasSgemmBatchSchedule(&WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix
+    multiply operations (SGEMM) that share a matrix B that was packed by
+    MlasGemmPackB, where the matrices A and C of each operation are found at
+    a fixed stride from those of the previous operation.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    StrideA - Supplies the number of elements between each matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of the first matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StrideC - Supplies the number of elements between each matrix C.
+
+    BatchSize - Supplies the number of operations in the batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchSize == 0) {
+        return;
+    }
+
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = CblasNoTrans;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.StrideA = StrideA;
+    WorkBlock.B = nullptr;
+    WorkBlock.ldb = 0;
+    WorkBlock.StrideB = 0;
+    WorkBlock.PackedB = (const float*)PackedB;
+    WorkBlock.AlignedN = (N + 15) & ~size_t(15);
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.StrideC = StrideC;
+    WorkBlock.BatchSize = BatchSize;
+
+    MlasSgemmBatchSchedule(&WorkBlock, ThreadPool);
+}
@@ -0,0 +1,455 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/graph/graph_utils.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// The Attention kernel is implemented for float.
+static bool IsSupportedDataType(const NodeArg& node_arg) {
+  return node_arg.Type() != nullptr && *node_arg.Type() == "tensor(float)";
+}
+
+static bool IsMatchingNode(const Node& node, const std::string& op_type,
+                           const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions,
+                           const std::string& provider) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, versions) &&
+         node.GetExecutionProviderType() == provider;
+}
+
+// Get the value of a constant float input with a single element.
+static bool GetConstantScalar(const Graph& graph, const NodeArg& input_arg, float& value) {
+  const ONNX_NAMESPACE::TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  auto init_const = onnxruntime::make_unique<Initializer>(*tensor_proto);
+  if (init_const->size() != 1) {
+    return false;
+  }
+
+  value = *init_const->data<float>();
+  return true;
+}
+
+static bool HasPerm(const Node& transpose, const std::vector<int64_t>& expected_perm) {
+  std::vector<int64_t> perm;
+  return graph_utils::GetRepeatedNodeAttributeValues(transpose, "perm", perm) && perm == expected_perm;
+}
+
+// Get the constant shape of a Reshape node, and check that it keeps the batch and sequence dims of x,
+// i.e. that each of its first two values is 0 (copy the dim), -1 (infer the dim) or the dim of x.
+static bool GetReshapeShape(const Graph& graph, const Node& reshape, const NodeArg& x, size_t rank,
+                            std::vector<int64_t>& shape) {
+  const ONNX_NAMESPACE::TensorProto* tensor_proto =
+      graph_utils::GetConstantInitializer(graph, reshape.InputDefs()[1]->Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+    return false;
+  }
+
+  auto init_const = onnxruntime::make_unique<Initializer>(*tensor_proto);
+  if (static_cast<size_t>(init_const->size()) != rank) {
+    return false;
+  }
+
+  const int64_t* data = init_const->data<int64_t>();
+  shape.assign(data, data + rank);
+
+  const auto* x_shape = x.Shape();
+  for (int i = 0; i < 2; ++i) {
+    if (shape[i] == 0 || (shape[i] == -1 && shape[1 - i] != -1)) {
+      continue;
+    }
+
+    const auto& dim = x_shape->dim(i);
+    if (!dim.has_dim_value() || dim.dim_value() != shape[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Check that an input of a node is a constant float initializer of the given dims.
+static bool IsConstantOfDims(const Graph& graph, const NodeArg& input_arg, const std::vector<int64_t>& dims) {
+  const ONNX_NAMESPACE::TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+      tensor_proto->dims_size() != static_cast<int>(dims.size())) {
+    return false;
+  }
+
+  for (int i = 0; i < tensor_proto->dims_size(); ++i) {
+    if (tensor_proto->dims(i) != dims[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// The nodes of the Q, K or V projection: Transpose(Reshape(MatMul(x, weight) + bias)).
+struct ProjectionNodes {
+  Node* matmul = nullptr;
+  Node* add = nullptr;
+  Node* reshape = nullptr;
+  Node* transpose = nullptr;
+  const NodeArg* weight = nullptr;
+  const NodeArg* bias = nullptr;
+  int64_t num_heads = 0;
+  int64_t head_size = 0;
+};
+
+// Match the projection walking up from the node consuming its Transpose.
+static bool MatchProjection(Graph& graph, const Node& node, int input_index, const std::vector<int64_t>& perm,
+                            const std::string& provider, ProjectionNodes& projection) {
+  projection.transpose = graph_utils::GetInputNode(graph, node, input_index);
+  if (projection.transpose == nullptr ||
+      !IsMatchingNode(*projection.transpose, "Transpose", {1}, provider) ||
+      !HasPerm(*projection.transpose, perm)) {
+    return false;
+  }
+
+  projection.reshape = graph_utils::GetInputNode(graph, *projection.transpose, 0);
+  if (projection.reshape == nullptr || !IsMatchingNode(*projection.reshape, "Reshape", {5}, provider)) {
+    return false;
+  }
+
+  projection.add = graph_utils::GetInputNode(graph, *projection.reshape, 0);
+  if (projection.add == nullptr || !IsMatchingNode(*projection.add, "Add", {7}, provider)) {
+    return false;
+  }
+
+  // the bias may be either input of the Add
+  for (int i = 0; i < 2 && projection.matmul == nullptr; ++i) {
+    Node* matmul = graph_utils::GetInputNode(graph, *projection.add, i);
+    if (matmul != nullptr && IsMatchingNode(*matmul, "MatMul", {1, 9}, provider)) {
+      projection.matmul = matmul;
+      projection.bias = projection.add->InputDefs()[1 - i];
+    }
+  }
+
+  if (projection.matmul == nullptr) {
+    return false;
+  }
+
+  projection.weight = projection.matmul->InputDefs()[1];
+
+  const NodeArg& x = *projection.matmul->InputDefs()[0];
+  const auto* x_shape = x.Shape();
+  if (!IsSupportedDataType(x) || x_shape == nullptr || x_shape->dim_size() != 3 ||
+      !x_shape->dim(2).has_dim_value()) {
+    return false;
+  }
+
+  const int64_t hidden_size = x_shape->dim(2).dim_value();
+  std::vector<int64_t> shape;
+  if (!IsConstantOfDims(graph, *projection.weight, {hidden_size, hidden_size}) ||
+      !IsConstantOfDims(graph, *projection.bias, {hidden_size}) ||
+      !GetReshapeShape(graph, *projection.reshape, x, 4, shape) ||
+      shape[2] <= 0 || shape[3] <= 0 || shape[2] * shape[3] != hidden_size) {
+    return false;
+  }
+
+  projection.num_heads = shape[2];
+  projection.head_size = shape[3];
+  return true;
+}
+
+// Match the subgraph converting a (batch_size, sequence_length) mask of 1s and 0s to the values added to the
+// attention scores, walking up from its last node: (1 - Cast(Unsqueeze(mask))) * -10000, where the mask is
+// unsqueezed to (batch_size, 1, 1, sequence_length). The nodes are returned in that order. The Attention op applies
+// an integer mask the same way, so the mask value must be -10000 and the mask must have an integer type.
+static bool MatchMask(Graph& graph, Node& mul, const std::string& provider,
+                      std::vector<Node*>& mask_nodes, NodeArg*& mask) {
+  if (!IsMatchingNode(mul, "Mul", {7}, provider)) {
+    return false;
+  }
+
+  Node* sub = nullptr;
+  float value = 0.f;
+  for (int i = 0; i < 2 && sub == nullptr; ++i) {
+    if (GetConstantScalar(graph, *mul.InputDefs()[1 - i], value) && value == -10000.f) {
+      sub = graph_utils::GetInputNode(graph, mul, i);
+    }
+  }
+
+  if (sub == nullptr || !IsMatchingNode(*sub, "Sub", {7}, provider) ||
+      !GetConstantScalar(graph, *sub->InputDefs()[0], value) || value != 1.f) {
+    return false;
+  }
+
+  mask_nodes = {&mul, sub};
+  std::vector<Node*> unsqueeze_nodes;
+  Node* node = graph_utils::GetInputNode(graph, *sub, 1);
+  while (node != nullptr) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Unsqueeze", {1, 11})) {
+      unsqueeze_nodes.push_back(node);
+    } else if (!graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Cast", {6, 9})) {
+      break;
+    }
+
+    mask_nodes.push_back(node);
+    node = graph_utils::GetInputNode(graph, *node, 0);
+  }
+
+  if (unsqueeze_nodes.empty()) {
+    return false;
+  }
+
+  mask = mask_nodes.back()->MutableInputDefs()[0];
+  const auto* mask_shape = mask->Shape();
+  const auto* mask_type = mask->TypeAsProto();
+  if (mask_shape == nullptr || mask_shape->dim_size() != 2 || mask_type == nullptr ||
+      !(mask_type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_INT32 ||
+        mask_type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_INT64 ||
+        mask_type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_BOOL)) {
+    return false;
+  }
+
+  // apply the Unsqueeze nodes to the dims of the mask, where -1 is an inserted dim
+  std::vector<int64_t> dims{0, 1};
+  for (auto it = unsqueeze_nodes.rbegin(); it != unsqueeze_nodes.rend(); ++it) {
+    std::vector<int64_t> axes;
+    if (!graph_utils::GetRepeatedNodeAttributeValues(**it, "axes", axes)) {
+      return false;
+    }
+
+    const int64_t output_rank = static_cast<int64_t>(dims.size() + axes.size());
+    for (auto& axis : axes) {
+      if (axis < 0) {
+        axis += output_rank;
+      }
+    }
+
+    std::sort(axes.begin(), axes.end());
+    for (auto axis : axes) {
+      if (axis < 0 || axis > static_cast<int64_t>(dims.size())) {
+        return false;
+      }
+      dims.insert(dims.begin() + axis, -1);
+    }
+  }
+
+  return dims == std::vector<int64_t>{0, -1, -1, 1};
+}
+
+// Add an initializer concatenating the Q, K and V weights or biases along their last dim.
+static NodeArg& AddConcatenatedInitializer(Graph& graph, const std::string& name,
+                                           const std::vector<const NodeArg*>& args, int64_t hidden_size) {
+  const auto* first_proto = graph_utils::GetConstantInitializer(graph, args[0]->Name());
+  std::vector<int64_t> dims(first_proto->dims().begin(), first_proto->dims().end());
+  dims.back() *= 3;
+
+  Initializer concatenated(ONNX_NAMESPACE::TensorProto_DataType_FLOAT, graph.GenerateNodeArgName(name), dims);
+  float* data = concatenated.data<float>();
+  const int64_t num_rows = concatenated.size() / (3 * hidden_size);
+  for (size_t i = 0; i < args.size(); ++i) {
+    Initializer init(*graph_utils::GetConstantInitializer(graph, args[i]->Name()));
+    const float* src = init.data<float>();
+    for (int64_t row = 0; row < num_rows; ++row) {
+      std::copy(src + row * hidden_size, src + (row + 1) * hidden_size,
+                data + row * 3 * hidden_size + i * hidden_size);
+    }
+  }
+
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  concatenated.ToProto(tensor_proto);
+  return graph_utils::AddInitializer(graph, tensor_proto);
+}
+
+// Add the node casting the mask to the int32 (batch_size, sequence_length) mask input of the Attention op. The whole
+// mask is kept, as the valid tokens aren't necessarily a prefix of each sequence as a mask_index would assume.
+static Node& AddMaskInput(Graph& graph, NodeArg& mask, const Node& mask_consumer, const std::string& provider) {
+  ONNX_NAMESPACE::TypeProto int32_type;
+  int32_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT32);
+  *int32_type.mutable_tensor_type()->mutable_shape() = *mask.Shape();
+
+  NodeArg& mask_int32 = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("mask_int32"), &int32_type);
+  Node& cast_node = graph.AddNode(graph.GenerateNodeName("MaskCast"), "Cast", "cast mask to int32",
+                                  {&mask}, {&mask_int32});
+  cast_node.AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_INT32));
+  cast_node.SetExecutionProviderType(provider);
+
+  // connect the new node to the node producing the mask, if any
+  for (auto it = mask_consumer.InputEdgesBegin(); it != mask_consumer.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == 0) {
+      graph.AddEdge(it->GetNode().Index(), cast_node.Index(), it->GetSrcArgIndex(), 0);
+    }
+  }
+
+  return cast_node;
+}
+
+Status AttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the node computing the mask input of each mask, which is shared by the attention of all the layers
+  std::unordered_map<std::string, NodeIndex> mask_input_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_softmax = graph.GetNode(node_index);
+    if (p_softmax == nullptr)
+      continue;  // we removed the node as part of an earlier fusion
+
+    Node& softmax_node = *p_softmax;
+    ORT_RETURN_IF_ERROR(Recurse(softmax_node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax_node, "Softmax", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(softmax_node, GetCompatibleExecutionProviders()) ||
+        softmax_node.GetOutputEdgesCount() != 1) {
+      continue;
+    }
+
+    // softmax over the last axis of the (batch_size, num_heads, sequence_length, sequence_length) scores
+    const auto* axis_attr = graph_utils::GetNodeAttribute(softmax_node, "axis");
+    if (axis_attr == nullptr || (axis_attr->i() != 3 && axis_attr->i() != -1)) {
+      continue;
+    }
+
+    const std::string& provider = softmax_node.GetExecutionProviderType();
+    Node* p_add_mask = graph_utils::GetInputNode(graph, softmax_node, 0);
+    if (p_add_mask == nullptr || !IsMatchingNode(*p_add_mask, "Add", {7}, provider)) {
+      continue;
+    }
+
+    // the scaled scores and the mask may be either input of the Add
+    Node* p_scale = nullptr;
+    Node* p_qk = nullptr;
+    float scale = 0.f;
+    std::vector<Node*> mask_nodes;
+    NodeArg* mask = nullptr;
+    for (int i = 0; i < 2 && p_qk == nullptr; ++i) {
+      Node* scale_node = graph_utils::GetInputNode(graph, *p_add_mask, i);
+      Node* mask_mul_node = graph_utils::GetInputNode(graph, *p_add_mask, 1 - i);
+      if (scale_node == nullptr || mask_mul_node == nullptr ||
+          !MatchMask(graph, *mask_mul_node, provider, mask_nodes, mask)) {
+        continue;
+      }
+
+      if (IsMatchingNode(*scale_node, "Div", {7}, provider) &&
+          GetConstantScalar(graph, *scale_node->InputDefs()[1], scale) && scale != 0.f) {
+        p_scale = scale_node;
+        p_qk = graph_utils::GetInputNode(graph, *scale_node, 0);
+        scale = 1.f / scale;
+      } else if (IsMatchingNode(*scale_node, "Mul", {7}, provider)) {
+        for (int j = 0; j < 2 && p_qk == nullptr; ++j) {
+          if (GetConstantScalar(graph, *scale_node->InputDefs()[1 - j], scale)) {
+            p_scale = scale_node;
+            p_qk = graph_utils::GetInputNode(graph, *scale_node, j);
+          }
+        }
+      }
+    }
+
+    if (p_qk == nullptr || !IsMatchingNode(*p_qk, "MatMul", {1, 9}, provider)) {
+      continue;
+    }
+
+    Node* p_context = graph.GetNode(softmax_node.OutputNodesBegin()->Index());
+    if (!IsMatchingNode(*p_context, "MatMul", {1, 9}, provider) ||
+        p_context->InputDefs()[0] != softmax_node.OutputDefs()[0] ||
+        p_context->GetOutputEdgesCount() != 1) {
+      continue;
+    }
+
+    ProjectionNodes q, k, v;
+    if (!MatchProjection(graph, *p_qk, 0, {0, 2, 1, 3}, provider, q) ||
+        !MatchProjection(graph, *p_qk, 1, {0, 2, 3, 1}, provider, k) ||
+        !MatchProjection(graph, *p_context, 1, {0, 2, 1, 3}, provider, v)) {
+      continue;
+    }
+
+    NodeArg& x = *q.matmul->MutableInputDefs()[0];
+    if (k.matmul->InputDefs()[0] != &x || v.matmul->InputDefs()[0] != &x ||
+        k.num_heads != q.num_heads || v.num_heads != q.num_heads ||
+        k.head_size != q.head_size || v.head_size != q.head_size ||
+        std::abs(scale * std::sqrt(static_cast<float>(q.head_size)) - 1.f) > 1e-4f) {
+      continue;
+    }
+
+    const int64_t hidden_size = q.num_heads * q.head_size;
+    Node* p_transpose = graph.GetNode(p_context->OutputNodesBegin()->Index());
+    if (!IsMatchingNode(*p_transpose, "Transpose", {1}, provider) || !HasPerm(*p_transpose, {0, 2, 1, 3}) ||
+        p_transpose->GetOutputEdgesCount() != 1) {
+      continue;
+    }
+
+    Node* p_reshape = graph.GetNode(p_transpose->OutputNodesBegin()->Index());
+    std::vector<int64_t> output_shape;
+    if (!IsMatchingNode(*p_reshape, "Reshape", {5}, provider) ||
+        !GetReshapeShape(graph, *p_reshape, x, 3, output_shape) || output_shape[2] != hidden_size) {
+      continue;
+    }
+
+    std::vector<std::reference_wrapper<Node>> nodes_to_fuse;
+    for (const ProjectionNodes* projection : {&q, &k, &v}) {
+      for (Node* node : {projection->matmul, projection->add, projection->reshape, projection->transpose}) {
+        nodes_to_fuse.push_back(*node);
+      }
+    }
+    for (Node* node : {p_qk, p_scale, p_add_mask, &softmax_node, p_context, p_transpose, p_reshape}) {
+      nodes_to_fuse.push_back(*node);
+    }
+
+    // the outputs of the nodes other than the last one will no longer be produced
+    bool is_valid = true;
+    for (size_t i = 0; i + 1 < nodes_to_fuse.size() && is_valid; ++i) {
+      const Node& node = nodes_to_fuse[i];
+      is_valid = node.GetOutputEdgesCount() == 1 && graph.GetNodeOutputsInGraphOutputs(node).empty();
+    }
+
+    if (!is_valid) {
+      continue;
+    }
+
+    auto mask_input_it = mask_input_nodes.find(mask->Name());
+    if (mask_input_it == mask_input_nodes.end()) {
+      Node& mask_input_node = AddMaskInput(graph, *mask, *mask_nodes.back(), provider);
+      mask_input_it = mask_input_nodes.emplace(mask->Name(), mask_input_node.Index()).first;
+    }
+    Node& mask_input_node = *graph.GetNode(mask_input_it->second);
+
+    NodeArg& qkv_weight = AddConcatenatedInitializer(graph, "AttentionFusion_QKV_Weight",
+                                                     {q.weight, k.weight, v.weight}, hidden_size);
+    NodeArg& qkv_bias = AddConcatenatedInitializer(graph, "AttentionFusion_QKV_Bias",
+                                                   {q.bias, k.bias, v.bias}, hidden_size);
+
+    Node& attention_node = graph.AddNode(graph.GenerateNodeName("Attention"),
+                                         "Attention",
+                                         "fused Attention subgraphs ",
+                                         {&x, &qkv_weight, &qkv_bias, mask_input_node.MutableOutputDefs()[0]},
+                                         {}, {}, kMSDomain);
+    attention_node.AddAttribute("num_heads", q.num_heads);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    attention_node.SetExecutionProviderType(provider);
+
+    graph.AddEdge(mask_input_node.Index(), attention_node.Index(), 0, 3);
+
+    // move input edges to the Q MatMul across to the attention_node.
+    // move output definitions and output edges from the last Reshape to attention_node.
+    // remove all the other nodes.
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, attention_node);
+
+    // remove the nodes of the mask subgraph once the attention of all the layers using it is fused
+    for (Node* node : mask_nodes) {
+      if (node->GetOutputEdgesCount() != 0 || !graph.GetNodeOutputsInGraphOutputs(*node).empty()) {
+        break;
+      }
+      graph.RemoveNode(node->Index());
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class AttentionFusion
+
+Rewrite graph fusing multi-head self-attention subgraph to a single Attention node.
+
+The subgraph, where x is (batch_size, sequence_length, hidden_size) and mask is (batch_size, sequence_length):
+  q = Transpose(Reshape(MatMul(x, Wq) + bq, (0, 0, N, H)), (0, 2, 1, 3))   also k with perm (0, 2, 3, 1), and v
+  scores = Softmax(MatMul(q, k) / sqrt(H) + (1 - Cast(Unsqueeze(mask))) * -10000)
+  y = Reshape(Transpose(MatMul(scores, v), (0, 2, 1, 3)), (0, 0, N * H))
+
+The weights and biases of Q, K and V are concatenated to a single weight and bias, and the integer mask is cast to
+the int32 (batch_size, sequence_length) mask input of the Attention op.
+*/
+class AttentionFusion : public GraphTransformer {
+ public:
+  AttentionFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("AttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/cast_elimination.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+// Returns true if every value of from_type is exactly representable in to_type, so casting to to_type and back to
+// from_type returns the original value.
+static bool IsLosslessCast(int32_t from_type, int32_t to_type) {
+  static const std::unordered_map<int32_t, std::unordered_set<int32_t>> lossless_casts{
+      {TensorProto::BOOL,
+       {TensorProto::INT8, TensorProto::UINT8, TensorProto::INT16, TensorProto::UINT16, TensorProto::INT32,
+        TensorProto::UINT32, TensorProto::INT64, TensorProto::UINT64, TensorProto::FLOAT16, TensorProto::FLOAT,
+        TensorProto::DOUBLE}},
+      {TensorProto::INT8,
+       {TensorProto::INT16, TensorProto::INT32, TensorProto::INT64, TensorProto::FLOAT16, TensorProto::FLOAT,
+        TensorProto::DOUBLE}},
+      {TensorProto::UINT8,
+       {TensorProto::INT16, TensorProto::UINT16, TensorProto::INT32, TensorProto::UINT32, TensorProto::INT64,
+        TensorProto::UINT64, TensorProto::FLOAT16, TensorProto::FLOAT, TensorProto::DOUBLE}},
+      {TensorProto::INT16, {TensorProto::INT32, TensorProto::INT64, TensorProto::FLOAT, TensorProto::DOUBLE}},
+      {TensorProto::UINT16,
+       {TensorProto::INT32, TensorProto::UINT32, TensorProto::INT64, TensorProto::UINT64, TensorProto::FLOAT,
+        TensorProto::DOUBLE}},
+      {TensorProto::INT32, {TensorProto::INT64, TensorProto::DOUBLE}},
+      {TensorProto::UINT32, {TensorProto::INT64, TensorProto::UINT64, TensorProto::DOUBLE}},
+      {TensorProto::FLOAT16, {TensorProto::FLOAT, TensorProto::DOUBLE}},
+      {TensorProto::FLOAT, {TensorProto::DOUBLE}}};
+
+  auto it = lossless_casts.find(from_type);
+  return it != lossless_casts.end() && it->second.count(to_type) != 0;
+}
+
+static int32_t GetElementType(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() ? type->tensor_type().elem_type() : TensorProto::UNDEFINED;
+}
+
+static int32_t GetCastTo(const Node& node) {
+  const auto* to = graph_utils::GetNodeAttribute(node, "to");
+  return to != nullptr ? static_cast<int32_t>(to->i()) : TensorProto::UNDEFINED;
+}
+
+static bool IsCast(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9});
+}
+
+// Returns the Cast producing the input of the Cast if the two Casts together return their input unchanged.
+static const Node* GetInverseInputCast(const Node& node) {
+  const Node* input_node = graph_utils::GetInputNode(node, 0);
+  if (input_node == nullptr || !IsCast(*input_node) ||
+      input_node->GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  int32_t original_type = GetElementType(*input_node->InputDefs()[0]);
+  return original_type == GetCastTo(node) && IsLosslessCast(original_type, GetCastTo(*input_node))
+             ? input_node
+             : nullptr;
+}
+
+Status CastElimination::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  const Node* input_cast = GetInverseInputCast(node);
+  if (input_cast != nullptr) {
+    graph_utils::RemoveInverseNodes(graph, *graph.GetNode(input_cast->Index()), node);
+    rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+  } else if (graph_utils::RemoveNode(graph, node)) {
+    rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+  }
+
+  return Status::OK();
+}
+
+bool CastElimination::SatisfyCondition(const Graph& graph, const Node& node) const {
+  if (!IsCast(node) || !graph_utils::CanRemoveNode(graph, node)) {
+    return false;
+  }
+
+  int32_t input_type = GetElementType(*node.InputDefs()[0]);
+  return (input_type != TensorProto::UNDEFINED && input_type == GetCastTo(node)) ||
+         GetInverseInputCast(node) != nullptr;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class CastElimination
+
+Rewrite rule that eliminates casts that don't change their input, as the CPU Cast kernel copies its input.
+  - a Cast to the type of its input is removed.
+  - a Cast back to the original type after a Cast to a type that represents all the values of the original type
+    exactly (e.g. float16 -> float -> float16) is removed along with the first Cast.
+
+It is attempted to be triggered only on nodes with op type "Cast".
+*/
+class CastElimination : public RewriteRule {
+ public:
+  CastElimination() noexcept : RewriteRule("CastElimination") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Cast"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
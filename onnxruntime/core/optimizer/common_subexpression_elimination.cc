@@ -0,0 +1,149 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/graph/graph_utils.h"
+#include <algorithm>
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// Ops that may produce different outputs for the same inputs.
+static const std::unordered_set<std::string> non_deterministic_ops{
+    "Dropout", "Multinomial", "RandomNormal", "RandomNormalLike", "RandomUniform", "RandomUniformLike"};
+
+static void HashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// What makes two nodes equivalent, other than the node properties that are compared directly.
+struct NodeSignature {
+  const Node* node;
+  std::string attributes;  // the attributes sorted by name and serialized
+  size_t hash;
+};
+
+static NodeSignature GetSignature(const Node& node) {
+  NodeSignature signature{&node, "", std::hash<std::string>{}(node.OpType())};
+
+  std::vector<const ONNX_NAMESPACE::AttributeProto*> attributes;
+  for (const auto& attribute : node.GetAttributes()) {
+    attributes.push_back(&attribute.second);
+  }
+  std::sort(attributes.begin(), attributes.end(),
+            [](const ONNX_NAMESPACE::AttributeProto* a, const ONNX_NAMESPACE::AttributeProto* b) {
+              return a->name() < b->name();
+            });
+  for (const auto* attribute : attributes) {
+    signature.attributes += attribute->SerializeAsString();
+  }
+
+  HashCombine(signature.hash, std::hash<std::string>{}(node.Domain()));
+  HashCombine(signature.hash, std::hash<std::string>{}(signature.attributes));
+  for (const NodeArg* input : node.InputDefs()) {
+    HashCombine(signature.hash, std::hash<const NodeArg*>{}(input));
+  }
+
+  return signature;
+}
+
+static bool AreEquivalent(const NodeSignature& a, const NodeSignature& b) {
+  const Node& node_a = *a.node;
+  const Node& node_b = *b.node;
+  if (a.hash != b.hash || node_a.OpType() != node_b.OpType() || node_a.Domain() != node_b.Domain() ||
+      node_a.Op()->SinceVersion() != node_b.Op()->SinceVersion() ||
+      node_a.GetExecutionProviderType() != node_b.GetExecutionProviderType() ||
+      a.attributes != b.attributes) {
+    return false;
+  }
+
+  const auto& inputs_a = node_a.InputDefs();
+  const auto& inputs_b = node_b.InputDefs();
+  if (inputs_a.size() != inputs_b.size() || !std::equal(inputs_a.begin(), inputs_a.end(), inputs_b.begin())) {
+    return false;
+  }
+
+  // the optional outputs produced by the nodes must match too
+  const auto& outputs_a = node_a.OutputDefs();
+  const auto& outputs_b = node_b.OutputDefs();
+  if (outputs_a.size() != outputs_b.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < outputs_a.size(); ++i) {
+    if (outputs_a[i]->Exists() != outputs_b[i]->Exists()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool CanMerge(const Node& node) {
+  // ops in custom domains may have side effects
+  return node.Op() != nullptr && !node.ContainsSubgraph() && !node.OutputDefs().empty() &&
+         (graph_utils::MatchesOpSetDomain(node, kOnnxDomain) || node.Domain() == kMSDomain) &&
+         non_deterministic_ops.count(node.OpType()) == 0;
+}
+
+Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the signatures of the nodes kept so far by hash. as the nodes are visited in topological order, the consumers
+  // of a merged node are visited after it and see the inputs of the node it was merged into.
+  std::unordered_map<size_t, std::vector<NodeSignature>> kept_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // node was removed
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) || !CanMerge(node)) {
+      continue;
+    }
+
+    NodeSignature signature = GetSignature(node);
+    auto& candidates = kept_nodes[signature.hash];
+    auto equivalent = std::find_if(candidates.begin(), candidates.end(),
+                                   [&signature](const NodeSignature& candidate) {
+                                     return AreEquivalent(candidate, signature);
+                                   });
+
+    // a node producing a graph output can't be removed, but can be kept for the nodes after it
+    if (equivalent == candidates.end() || !graph.GetNodeOutputsInGraphOutputs(node).empty()) {
+      candidates.push_back(std::move(signature));
+      continue;
+    }
+
+    // the consumers of the outputs see the names of the outputs of the kept node, which must not clash with the
+    // names in the subgraphs that consume the outputs as implicit inputs
+    Node& kept_node = *graph.GetNode(equivalent->node->Index());
+    const int num_outputs = static_cast<int>(node.OutputDefs().size());
+    bool can_replace = true;
+    for (int i = 0; i < num_outputs && can_replace; ++i) {
+      can_replace = graph_utils::CanUpdateImplicitInputNameInSubgraphs(graph, node, i,
+                                                                       kept_node.OutputDefs()[i]->Name());
+    }
+
+    if (!can_replace) {
+      candidates.push_back(std::move(signature));
+      continue;
+    }
+
+    for (int i = 0; i < num_outputs; ++i) {
+      graph_utils::ReplaceDownstreamNodeInput(graph, node, i, kept_node, i);
+    }
+
+    graph.RemoveNode(node.Index());
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class CommonSubexpressionElimination
+
+Transformer that merges equivalent nodes, i.e. nodes with the same op type, domain, attributes and inputs.
+The consumers of a duplicate node are moved to the outputs of the first equivalent node, and the duplicate node is
+removed, so repeated computations such as Shape->Gather->Unsqueeze chains are only done once.
+
+Non-deterministic ops like RandomNormal or Dropout are never merged, nor are nodes with subgraphs.
+*/
+class CommonSubexpressionElimination : public GraphTransformer {
+ public:
+  CommonSubexpressionElimination(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("CommonSubexpressionElimination", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
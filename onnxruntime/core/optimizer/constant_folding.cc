@@ -6,11 +6,192 @@
 #include "core/optimizer/optimizer_execution_frame.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/optimizer/initializer.h"
 
+#include <limits>
+
+using namespace ONNX_NAMESPACE;
 using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
+// Get the values of a constant int32 or int64 initializer.
+static bool GetConstantInt64Values(const Graph& graph, const NodeArg* input, std::vector<int64_t>& values) {
+  const auto* initializer = input != nullptr && input->Exists()
+                                ? graph_utils::GetConstantInitializer(graph, input->Name())
+                                : nullptr;
+  if (initializer == nullptr) {
+    return false;
+  }
+
+  Initializer init(*initializer);
+  if (initializer->data_type() == TensorProto::INT64) {
+    const int64_t* data = init.data<int64_t>();
+    values.assign(data, data + init.size());
+  } else if (initializer->data_type() == TensorProto::INT32) {
+    const int32_t* data = init.data<int32_t>();
+    values.assign(data, data + init.size());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Get the indices of the elements of a 1D tensor of the given size that a Slice selects.
+static bool GetSliceIndices(const Graph& graph, const Node& slice, int64_t size, std::vector<int64_t>& indices) {
+  std::vector<int64_t> starts;
+  std::vector<int64_t> ends;
+  std::vector<int64_t> axes;
+  std::vector<int64_t> steps;
+  const auto& inputs = slice.InputDefs();
+  if (graph_utils::MatchesOpSinceVersion(slice, {1})) {
+    if (!graph_utils::GetRepeatedNodeAttributeValues(slice, "starts", starts) ||
+        !graph_utils::GetRepeatedNodeAttributeValues(slice, "ends", ends)) {
+      return false;
+    }
+    graph_utils::GetRepeatedNodeAttributeValues(slice, "axes", axes);
+  } else if (!GetConstantInt64Values(graph, inputs[1], starts) || !GetConstantInt64Values(graph, inputs[2], ends) ||
+             (inputs.size() > 3 && inputs[3]->Exists() && !GetConstantInt64Values(graph, inputs[3], axes)) ||
+             (inputs.size() > 4 && inputs[4]->Exists() && !GetConstantInt64Values(graph, inputs[4], steps))) {
+    return false;
+  }
+
+  // the output of a Shape is 1D so only axis 0 can be sliced
+  if (starts.size() != 1 || ends.size() != 1 ||
+      (!axes.empty() && (axes.size() != 1 || (axes[0] != 0 && axes[0] != -1))) ||
+      (!steps.empty() && (steps.size() != 1 || steps[0] == 0))) {
+    return false;
+  }
+
+  // clamp start and end the same way as the CPU Slice kernel
+  const int64_t step = steps.empty() ? 1 : steps[0];
+  int64_t start = starts[0] < 0 ? starts[0] + size : starts[0];
+  start = step < 0 ? std::max<int64_t>(0, std::min(start, size - 1)) : std::max<int64_t>(0, std::min(start, size));
+
+  int64_t end = ends[0];
+  // INT_MAX means slicing to the end of the dimension in the direction of step
+  if (end == std::numeric_limits<int32_t>::max() || end == std::numeric_limits<int64_t>::max()) {
+    end = step < 0 ? -1 : size;
+  } else {
+    if (end < 0) {
+      end += size;
+    }
+    end = std::max<int64_t>(step < 0 ? -1 : 0, std::min(end, size));
+  }
+
+  if (step > 0) {
+    for (int64_t i = start; i < end; i += step) {
+      indices.push_back(i);
+    }
+  } else {
+    for (int64_t i = start; i > end; i += step) {
+      indices.push_back(i);
+    }
+  }
+  return true;
+}
+
+// Compute the output of a Gather or Slice of the output of a Shape node if all the dimensions it selects are known.
+// The dims of the output are returned in output_dims.
+static bool ComputeShapeSubset(const Graph& graph, const Node& node, const Node*& shape_node,
+                               std::vector<int64_t>& values, std::vector<int64_t>& output_dims) {
+  bool is_gather = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11});
+  if (!is_gather && !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Slice", {1, 10, 11})) {
+    return false;
+  }
+
+  shape_node = graph_utils::GetInputNode(node, 0);
+  if (shape_node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*shape_node, "Shape", {1})) {
+    return false;
+  }
+
+  const auto* shape = shape_node->InputDefs()[0]->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  const int64_t rank = shape->dim_size();
+  std::vector<int64_t> indices;
+  if (is_gather) {
+    const auto* axis = graph_utils::GetNodeAttribute(node, "axis");
+    if ((axis != nullptr && axis->i() != 0 && axis->i() != -1) ||
+        !GetConstantInt64Values(graph, node.InputDefs()[1], indices)) {
+      return false;
+    }
+    const auto* indices_initializer = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+    output_dims.assign(indices_initializer->dims().begin(), indices_initializer->dims().end());
+  } else {
+    if (!GetSliceIndices(graph, node, rank, indices)) {
+      return false;
+    }
+    output_dims = {static_cast<int64_t>(indices.size())};
+  }
+
+  for (int64_t index : indices) {
+    if (index < 0) {
+      index += rank;
+    }
+    if (index < 0 || index >= rank || !utils::HasDimValue(shape->dim(static_cast<int>(index))) ||
+        shape->dim(static_cast<int>(index)).dim_value() < 0) {
+      return false;
+    }
+    values.push_back(shape->dim(static_cast<int>(index)).dim_value());
+  }
+
+  return true;
+}
+
+// Replace a Gather or Slice of a Shape with an initializer, if the dimensions it selects are known.
+static bool FoldShapeSubset(Graph& graph, Node& node) {
+  const Node* shape_node = nullptr;
+  std::vector<int64_t> values;
+  std::vector<int64_t> dims;
+  const auto& output_name = node.OutputDefs()[0]->Name();
+  if (!ComputeShapeSubset(graph, node, shape_node, values, dims) ||
+      !graph_utils::CanReplaceNodeWithInitializer(graph, node, output_name)) {
+    return false;
+  }
+
+  TensorProto initializer;
+  initializer.set_name(output_name);
+  initializer.set_data_type(TensorProto::INT64);
+  for (int64_t dim : dims) {
+    initializer.add_dims(dim);
+  }
+  for (int64_t value : values) {
+    initializer.add_int64_data(value);
+  }
+
+  Node& mutable_shape_node = *graph.GetNode(shape_node->Index());
+  graph_utils::ReplaceNodeWithInitializer(graph, node, graph_utils::AddInitializer(graph, initializer));
+  graph_utils::RemoveNodeIfUnused(graph, mutable_shape_node);
+  return true;
+}
+
+// Get the total size of the outputs of a node if their types and shapes are known.
+static bool GetOutputSizeInBytes(const Node& node, size_t& size) {
+  size = 0;
+  for (const auto* output : node.OutputDefs()) {
+    const auto* type = output->TypeAsProto();
+    const auto* shape = output->Shape();
+    if (type == nullptr || !type->has_tensor_type() || shape == nullptr) {
+      return false;
+    }
+
+    size_t num_elements = 1;
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+        return false;
+      }
+      num_elements *= static_cast<size_t>(dim.dim_value());
+    }
+
+    const auto* tensor_type = DataTypeImpl::TypeFromProto(*type)->AsTensorType();
+    size += num_elements * tensor_type->GetElementType()->Size();
+  }
+  return true;
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
@@ -23,6 +204,12 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level)
 
     ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
 
+    if (graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) &&
+        FoldShapeSubset(graph, *node)) {
+      modified = true;
+      continue;
+    }
+
     InitializedTensorSet constant_inputs;
 
     // Check if constant folding can be applied on this node.
@@ -36,6 +223,14 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level)
       continue;
     }
 
+    // don't compute outputs that may exceed the size limit. the size must be known before running the node, as
+    // computing a large output to find out it's too large can take as much memory as the limit is meant to save.
+    size_t output_size = 0;
+    if (max_output_bytes_ != 0 &&
+        (!GetOutputSizeInBytes(*node, output_size) || output_size > max_output_bytes_)) {
+      continue;
+    }
+
     // Create execution frame for executing constant nodes.
     OptimizerExecutionFrame::Info info({node}, constant_inputs);
 
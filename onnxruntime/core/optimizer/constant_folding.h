@@ -13,13 +13,22 @@ namespace onnxruntime {
 
 Transformer that traverses the graph top-down and performs constant folding, i.e.,
 it statically computes parts of the graph that rely only on constant initializers.
+
+A Gather or Slice of the output of a Shape node is also folded if the dimensions it selects are known, even if the
+other dimensions are symbolic, so shape computations on static dimensions are not done at runtime.
 */
 class ConstantFolding : public GraphTransformer {
  public:
-  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept :
-    GraphTransformer("ConstantFolding", compatible_execution_providers) {}
+  /** @param max_output_bytes A node is not folded if its outputs take more than this many bytes, as the folded
+      outputs are stored as initializers, or if their size isn't known from the static shapes. 0 means there is
+      no limit. */
+  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {},
+                  size_t max_output_bytes = 0) noexcept :
+    GraphTransformer("ConstantFolding", compatible_execution_providers), max_output_bytes_(max_output_bytes) {}
 
  private:
+  const size_t max_output_bytes_;
+
   /** Constant folding will not be applied to nodes whose op_type is included in this set.
       All non-deterministic operators should be included in this set. */
   const std::unordered_set<std::string> excluded_op_types_ =
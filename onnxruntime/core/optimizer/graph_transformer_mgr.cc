@@ -3,23 +3,59 @@
 
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
+
+#include <limits>
 using namespace onnxruntime;
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
-common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level) const {
+common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level,
+                                                          profiling::Profiler* profiler) const {
   const auto& transformers = level_to_transformer_map_.find(level);
   if (transformers == level_to_transformer_map_.end()) {
     return Status::OK();
   }
 
+  const bool profiling = profiler != nullptr && profiler->IsEnabled();
+  const auto& level_transformers = transformers->second;
+
+  // the number of modifications of the graph so far, and that number when each transformer last ran without
+  // modifying the graph. running a transformer again on the same graph wouldn't change anything.
+  constexpr size_t kNotUnchanged = std::numeric_limits<size_t>::max();
+  size_t num_modifications = 0;
+  std::vector<size_t> unchanged_at(level_transformers.size(), kNotUnchanged);
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
-    for (const auto& transformer : transformers->second) {
+    for (size_t i = 0; i < level_transformers.size(); ++i) {
+      if (unchanged_at[i] == num_modifications) {
+        continue;
+      }
+
+      const auto& transformer = level_transformers[i];
       bool modified = false;
+      TimePoint start_time;
+      if (profiling) {
+        start_time = profiler->StartTime();
+      }
+
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified));
-      graph_changed = graph_changed || modified;
+
+      if (profiling) {
+        profiler->EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer->Name(), start_time,
+                                        {{"level", std::to_string(static_cast<int>(level))},
+                                         {"step", std::to_string(step)},
+                                         {"modified", modified ? "true" : "false"}});
+      }
+
+      if (modified) {
+        ++num_modifications;
+        unchanged_at[i] = kNotUnchanged;
+        graph_changed = true;
+      } else {
+        unchanged_at[i] = num_modifications;
+      }
     }
     if (!graph_changed) {
       break;
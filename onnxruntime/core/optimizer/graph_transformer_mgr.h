@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/common/profiler.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/rewrite_rule.h"
@@ -19,8 +20,12 @@ class GraphTransformerManager {
   // Register a transformer with a level.
   common::Status Register(std::unique_ptr<GraphTransformer> transformer, TransformerLevel level);  
 
-  // Apply all transformers registered for the given level on the given graph
-  common::Status ApplyTransformers(Graph& graph, TransformerLevel level) const;
+  // Apply all transformers registered for the given level on the given graph, until none of them modifies the graph
+  // or the number of steps is reached. A transformer is skipped while the graph is unchanged since it last ran
+  // without modifying it.
+  // If a profiler is given and enabled, an event with the duration and the result of each transformer run is recorded.
+  common::Status ApplyTransformers(Graph& graph, TransformerLevel level,
+                                   profiling::Profiler* profiler = nullptr) const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransformerManager);  
@@ -0,0 +1,298 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/graph/graph_utils.h"
+#include <algorithm>
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// LayerNormalization is implemented for these data types.
+static std::vector<std::string> supported_data_types{"tensor(float)", "tensor(double)"};
+
+static bool IsSupportedDataType(const NodeArg& node_arg) {
+  return node_arg.Type() != nullptr &&
+         std::find(supported_data_types.begin(), supported_data_types.end(), *node_arg.Type()) !=
+             supported_data_types.end();
+}
+
+// Check the op type, version and provider of a node in the subgraph, and that it produces the data type of x.
+static bool IsMatchingNode(const Node& node, const std::string& op_type,
+                           const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions,
+                           const std::string& provider, const NodeArg& x) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, versions) &&
+         node.GetExecutionProviderType() == provider &&
+         node.OutputDefs()[0]->Type() == x.Type();
+}
+
+// Return the node consuming the output of node if it's the only consumer, otherwise nullptr.
+static Node* GetOnlyChildNode(Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1) {
+    return nullptr;
+  }
+  return graph.GetNode(node.OutputNodesBegin()->Index());
+}
+
+// Get the value of a constant scalar input, or a constant with a single element.
+static bool GetConstantScalar(const Graph& graph, const NodeArg& input_arg, double& value) {
+  const ONNX_NAMESPACE::TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr) {
+    return false;
+  }
+
+  auto init_const = onnxruntime::make_unique<Initializer>(*tensor_proto);
+  if (init_const->size() != 1) {
+    return false;
+  }
+
+  const auto data_type = tensor_proto->data_type();
+  if (data_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    value = *init_const->data<float>();
+  } else if (data_type == ONNX_NAMESPACE::TensorProto_DataType_DOUBLE) {
+    value = *init_const->data<double>();
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+// Get the first normalized axis from the axes of a ReduceMean node, as a negative axis.
+// The axes must be the trailing axes of x, and the reduced dims must be kept.
+static bool GetNormalizedAxis(const Node& reduce_mean, const NodeArg& x, int64_t& axis) {
+  const auto* keepdims_attr = graph_utils::GetNodeAttribute(reduce_mean, "keepdims");
+  if (keepdims_attr != nullptr && keepdims_attr->i() != 1) {
+    return false;
+  }
+
+  // no axes means all axes. x may have leading dims the scale and bias aren't defined for so don't fuse that.
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(reduce_mean, "axes", axes) || axes.empty()) {
+    return false;
+  }
+
+  const auto* x_shape = x.Shape();
+  const int64_t rank = x_shape != nullptr ? x_shape->dim_size() : -1;
+  for (auto& a : axes) {
+    if (a >= 0) {
+      // a positive axis can only be converted if the rank is known
+      if (rank < 0) {
+        return false;
+      }
+      a -= rank;
+    }
+
+    if (a >= 0 || (rank >= 0 && a < -rank)) {
+      return false;
+    }
+  }
+
+  std::sort(axes.begin(), axes.end());
+  const auto num_axes = static_cast<int64_t>(axes.size());
+  for (int64_t i = 0; i < num_axes; ++i) {
+    if (axes[i] != i - num_axes) {
+      return false;
+    }
+  }
+
+  axis = axes.front();
+  return true;
+}
+
+// The kernel reads scale and bias as tensors with the normalized dims of x, so the subgraph can only be fused if
+// they have those dims and the Mul and Add don't broadcast them over the normalized dims.
+static bool IsValidScaleOrBias(const NodeArg& x, const NodeArg& arg, int64_t axis) {
+  const auto* x_shape = x.Shape();
+  const auto* arg_shape = arg.Shape();
+  if (x_shape == nullptr || arg_shape == nullptr) {
+    return false;
+  }
+
+  const int x_rank = x_shape->dim_size();
+  const int arg_rank = arg_shape->dim_size();
+  const int num_axes = static_cast<int>(-axis);
+  for (int i = 1; i <= std::max(num_axes, arg_rank); ++i) {
+    // a missing dim of arg broadcasts like a dim of 1
+    int64_t arg_dim = 1;
+    if (i <= arg_rank) {
+      const auto& dim = arg_shape->dim(arg_rank - i);
+      if (!dim.has_dim_value()) {
+        return false;
+      }
+      arg_dim = dim.dim_value();
+    }
+
+    if (i > num_axes) {
+      // leading dims of arg beyond the normalized dims
+      if (arg_dim != 1) {
+        return false;
+      }
+      continue;
+    }
+
+    const auto& x_dim = x_shape->dim(x_rank - i);
+    if (!x_dim.has_dim_value() || x_dim.dim_value() != arg_dim) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status LayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_reduce_mean = graph.GetNode(node_index);
+    if (p_reduce_mean == nullptr)
+      continue;  // we removed the node as part of an earlier fusion
+
+    Node& reduce_mean_node = *p_reduce_mean;
+    ORT_RETURN_IF_ERROR(Recurse(reduce_mean_node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(reduce_mean_node, "ReduceMean", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(reduce_mean_node, GetCompatibleExecutionProviders()) ||
+        reduce_mean_node.GetOutputEdgesCount() == 0 ||
+        reduce_mean_node.GetOutputEdgesCount() > 2) {
+      continue;
+    }
+
+    const std::string& provider = reduce_mean_node.GetExecutionProviderType();
+    NodeArg& x = *reduce_mean_node.MutableInputDefs()[0];
+    int64_t axis = 0;
+    if (!IsSupportedDataType(x) || !GetNormalizedAxis(reduce_mean_node, x, axis)) {
+      continue;
+    }
+
+    // the mean is subtracted from x by one Sub node, or one Sub for the Pow and one for the Div
+    std::vector<Node*> sub_nodes;
+    bool is_valid = true;
+    for (auto it = reduce_mean_node.OutputNodesBegin(); it != reduce_mean_node.OutputNodesEnd(); ++it) {
+      Node& sub_node = *graph.GetNode(it->Index());
+      if (!IsMatchingNode(sub_node, "Sub", {7}, provider, x) ||
+          sub_node.InputDefs()[0] != &x ||
+          sub_node.InputDefs()[1] != reduce_mean_node.OutputDefs()[0]) {
+        is_valid = false;
+        break;
+      }
+      sub_nodes.push_back(&sub_node);
+    }
+
+    if (!is_valid) {
+      continue;
+    }
+
+    Node* p_pow = nullptr;
+    Node* p_div = nullptr;
+    for (Node* sub_node : sub_nodes) {
+      for (auto it = sub_node->OutputNodesBegin(); it != sub_node->OutputNodesEnd(); ++it) {
+        Node& next_node = *graph.GetNode(it->Index());
+        if (next_node.InputDefs()[0] != sub_node->OutputDefs()[0]) {
+          is_valid = false;
+        } else if (p_pow == nullptr && IsMatchingNode(next_node, "Pow", {7}, provider, x)) {
+          p_pow = &next_node;
+        } else if (p_div == nullptr && IsMatchingNode(next_node, "Div", {7}, provider, x)) {
+          p_div = &next_node;
+        } else {
+          is_valid = false;
+        }
+      }
+    }
+
+    double exponent = 0;
+    if (!is_valid || p_pow == nullptr || p_div == nullptr ||
+        !GetConstantScalar(graph, *p_pow->InputDefs()[1], exponent) || exponent != 2.0) {
+      continue;
+    }
+
+    Node* p_reduce_mean2 = GetOnlyChildNode(graph, *p_pow);
+    int64_t axis2 = 0;
+    if (p_reduce_mean2 == nullptr ||
+        !IsMatchingNode(*p_reduce_mean2, "ReduceMean", {1, 11}, provider, x) ||
+        !GetNormalizedAxis(*p_reduce_mean2, x, axis2) || axis2 != axis) {
+      continue;
+    }
+
+    Node* p_add_epsilon = GetOnlyChildNode(graph, *p_reduce_mean2);
+    if (p_add_epsilon == nullptr || !IsMatchingNode(*p_add_epsilon, "Add", {7}, provider, x)) {
+      continue;
+    }
+
+    // epsilon may be either input of the Add
+    const int epsilon_input_index = p_add_epsilon->InputDefs()[0] == p_reduce_mean2->OutputDefs()[0] ? 1 : 0;
+    double epsilon = 0;
+    if (!GetConstantScalar(graph, *p_add_epsilon->InputDefs()[epsilon_input_index], epsilon)) {
+      continue;
+    }
+
+    Node* p_sqrt = GetOnlyChildNode(graph, *p_add_epsilon);
+    if (p_sqrt == nullptr || !IsMatchingNode(*p_sqrt, "Sqrt", {6}, provider, x) ||
+        GetOnlyChildNode(graph, *p_sqrt) != p_div || p_div->InputDefs()[1] != p_sqrt->OutputDefs()[0]) {
+      continue;
+    }
+
+    Node* p_mul = GetOnlyChildNode(graph, *p_div);
+    if (p_mul == nullptr || !IsMatchingNode(*p_mul, "Mul", {7}, provider, x)) {
+      continue;
+    }
+
+    Node* p_add_bias = GetOnlyChildNode(graph, *p_mul);
+    if (p_add_bias == nullptr || !IsMatchingNode(*p_add_bias, "Add", {7}, provider, x)) {
+      continue;
+    }
+
+    const int scale_input_index = p_mul->InputDefs()[0] == p_div->OutputDefs()[0] ? 1 : 0;
+    const int bias_input_index = p_add_bias->InputDefs()[0] == p_mul->OutputDefs()[0] ? 1 : 0;
+    NodeArg* scale = p_mul->MutableInputDefs()[scale_input_index];
+    NodeArg* bias = p_add_bias->MutableInputDefs()[bias_input_index];
+    if (!IsValidScaleOrBias(x, *scale, axis) || !IsValidScaleOrBias(x, *bias, axis)) {
+      continue;
+    }
+
+    std::vector<std::reference_wrapper<Node>> nodes_to_fuse{reduce_mean_node};
+    for (Node* sub_node : sub_nodes) {
+      nodes_to_fuse.push_back(*sub_node);
+    }
+    for (Node* node : {p_pow, p_reduce_mean2, p_add_epsilon, p_sqrt, p_div, p_mul, p_add_bias}) {
+      nodes_to_fuse.push_back(*node);
+    }
+
+    // the outputs of the nodes other than the last one will no longer be produced
+    bool produces_graph_output = false;
+    for (size_t i = 0; i + 1 < nodes_to_fuse.size(); ++i) {
+      if (!graph.GetNodeOutputsInGraphOutputs(nodes_to_fuse[i]).empty()) {
+        produces_graph_output = true;
+        break;
+      }
+    }
+
+    if (produces_graph_output) {
+      continue;
+    }
+
+    Node& layer_norm_node = graph.AddNode(graph.GenerateNodeName("LayerNormalization"),
+                                          "LayerNormalization",
+                                          "fused LayerNorm subgraphs ",
+                                          {&x, scale, bias},
+                                          {}, {}, kOnnxDomain);
+    layer_norm_node.AddAttribute("axis", axis);
+    layer_norm_node.AddAttribute("epsilon", static_cast<float>(epsilon));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    layer_norm_node.SetExecutionProviderType(provider);
+
+    // move input edges to the first ReduceMean across to the layer_norm_node.
+    // move output definitions and output edges from the last Add to layer_norm_node.
+    // remove all the other nodes.
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, layer_norm_node);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class LayerNormFusion
+
+Rewrite graph fusing Layer Normalization subgraph to a single LayerNormalization node.
+
+The formula corresponding to LayerNorm subgraph, where the mean is over the trailing axes of x:
+  d = x - ReduceMean(x)
+  y = d / Sqrt(ReduceMean(Pow(d, 2)) + epsilon) * scale + bias
+
+The subtraction may be done by two Sub nodes, one for the Pow and one for the Div.
+*/
+class LayerNormFusion : public GraphTransformer {
+ public:
+  LayerNormFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("LayerNormFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
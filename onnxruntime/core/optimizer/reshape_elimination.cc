@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/reshape_elimination.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include <algorithm>
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+// Returns true if the inferred shapes of the NodeArgs are known and the same.
+static bool HaveSameShape(const NodeArg& a, const NodeArg& b) {
+  const auto* shape_a = a.Shape();
+  const auto* shape_b = b.Shape();
+  if (shape_a == nullptr || shape_b == nullptr || shape_a->dim_size() != shape_b->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape_a->dim_size(); ++i) {
+    const auto& dim_a = shape_a->dim(i);
+    const auto& dim_b = shape_b->dim(i);
+    bool same_value = dim_a.has_dim_value() && dim_b.has_dim_value() && dim_a.dim_value() == dim_b.dim_value();
+    bool same_param = dim_a.has_dim_param() && dim_b.has_dim_param() && !dim_a.dim_param().empty() &&
+                      dim_a.dim_param() == dim_b.dim_param();
+    if (!same_value && !same_param) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool IsIdentityReshape(const Graph& graph, const Node& node) {
+  if (!HaveSameShape(*node.InputDefs()[0], *node.OutputDefs()[0])) {
+    return false;
+  }
+
+  // graph_utils::RemoveNode connects the consumers to the node's single input edge whatever input it's for, which
+  // would be the target shape in Reshape(X, Shape(Y)) if X is a graph input, so the edge must be for the data input
+  if (node.GetInputEdgesCount() != 1 || node.InputEdgesBegin()->GetDstArgIndex() != 0) {
+    return false;
+  }
+
+  return graph_utils::CanRemoveNode(graph, node);
+}
+
+// Returns the Reshape or Flatten producing the input of the Reshape if the Reshape can consume its input instead.
+static const Node* GetInputReshape(const Graph& graph, const Node& node) {
+  const Node* input_node = graph_utils::GetInputNode(node, 0);
+  if (input_node == nullptr || input_node->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+      !(graph_utils::IsSupportedOptypeVersionAndDomain(*input_node, "Reshape", {5}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(*input_node, "Flatten", {1, 9, 11}))) {
+    return nullptr;
+  }
+
+  // a 0 in the target shape copies a dimension of the input, which the input node changes
+  const auto* shape = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+  if (shape == nullptr || shape->data_type() != TensorProto::INT64) {
+    return nullptr;
+  }
+
+  Initializer shape_init(*shape);
+  const int64_t* shape_data = shape_init.data<int64_t>();
+  if (std::any_of(shape_data, shape_data + shape_init.size(), [](int64_t dim) { return dim == 0; })) {
+    return nullptr;
+  }
+
+  return input_node;
+}
+
+Status ReshapeElimination::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  const Node* input_reshape = GetInputReshape(graph, node);
+  if (input_reshape != nullptr) {
+    Node& input_node = *graph.GetNode(input_reshape->Index());
+    graph_utils::BypassInputNode(graph, node, 0, input_node);
+    if (graph_utils::RemoveNodeIfUnused(graph, input_node)) {
+      rule_effect = RewriteRuleEffect::kModifiedRestOfGraph;
+    } else {
+      rule_effect = RewriteRuleEffect::kUpdatedCurrentNode;
+    }
+  }
+
+  // the reshapes may have cancelled out
+  if (IsIdentityReshape(graph, node) && graph_utils::RemoveNode(graph, node)) {
+    rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+  }
+
+  return Status::OK();
+}
+
+bool ReshapeElimination::SatisfyCondition(const Graph& graph, const Node& node) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5})) {
+    return false;
+  }
+
+  return IsIdentityReshape(graph, node) || GetInputReshape(graph, node) != nullptr;
+}
+
+}  // namespace onnxruntime
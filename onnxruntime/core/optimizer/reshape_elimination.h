@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class ReshapeElimination
+
+Rewrite rule that collapses chains of reshapes, as the CPU Reshape kernel copies its input.
+  - a Reshape consuming the output of another Reshape or of a Flatten reshapes the input of that node directly, if
+    its target shape has no 0 (copy the input dimension) values.
+  - a Reshape whose output shape, as inferred, is the same as its input shape is removed.
+
+It is attempted to be triggered only on nodes with op type "Reshape".
+*/
+class ReshapeElimination : public RewriteRule {
+ public:
+  ReshapeElimination() noexcept : RewriteRule("ReshapeElimination") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Reshape"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
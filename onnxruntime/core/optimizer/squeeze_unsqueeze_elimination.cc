@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/squeeze_unsqueeze_elimination.h"
+#include "core/graph/graph_utils.h"
+#include <algorithm>
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+// Get the axes of a Squeeze or Unsqueeze, made non-negative using the rank of the input of the Squeeze.
+static bool GetNormalizedAxes(const Node& node, const NodeArg& unsqueezed, std::vector<int64_t>& axes) {
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes)) {
+    // a Squeeze without axes removes all the dimensions of size 1
+    return false;
+  }
+
+  const auto* shape = unsqueezed.Shape();
+  for (auto& axis : axes) {
+    if (axis < 0) {
+      if (shape == nullptr) {
+        return false;
+      }
+      axis += shape->dim_size();
+    }
+  }
+
+  std::sort(axes.begin(), axes.end());
+  return true;
+}
+
+Status SqueezeUnsqueezeElimination::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  Node& input_node = *graph_utils::GetInputNode(graph, node, 0);
+  graph_utils::RemoveInverseNodes(graph, input_node, node);
+  rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+
+  return Status::OK();
+}
+
+bool SqueezeUnsqueezeElimination::SatisfyCondition(const Graph& graph, const Node& node) const {
+  bool is_unsqueeze = node.OpType() == "Unsqueeze";
+  const std::string inverse_op_type = is_unsqueeze ? "Squeeze" : "Unsqueeze";
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, node.OpType(), {1, 11})) {
+    return false;
+  }
+
+  const Node* input_node = graph_utils::GetInputNode(node, 0);
+  if (input_node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*input_node, inverse_op_type, {1, 11}) ||
+      input_node->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+      !graph_utils::CanRemoveNode(graph, node)) {
+    return false;
+  }
+
+  // the axes of both nodes refer to the dimensions of the input of the Squeeze
+  const NodeArg& unsqueezed = is_unsqueeze ? *input_node->InputDefs()[0] : *node.InputDefs()[0];
+  std::vector<int64_t> axes;
+  std::vector<int64_t> input_axes;
+  return GetNormalizedAxes(node, unsqueezed, axes) && GetNormalizedAxes(*input_node, unsqueezed, input_axes) &&
+         axes == input_axes;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class SqueezeUnsqueezeElimination
+
+Rewrite rule that eliminates an Unsqueeze of the output of a Squeeze with the same axes, or a Squeeze of the output
+of an Unsqueeze with the same axes, as together they return their input unchanged.
+
+It is attempted to be triggered only on nodes with op type "Squeeze" or "Unsqueeze".
+*/
+class SqueezeUnsqueezeElimination : public RewriteRule {
+ public:
+  SqueezeUnsqueezeElimination() noexcept : RewriteRule("SqueezeUnsqueezeElimination") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Squeeze", "Unsqueeze"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,533 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/transpose_optimizer.h"
+#include "core/graph/graph_utils.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// Elementwise ops with a single input. Clip has optional scalar min and max inputs.
+static const std::unordered_set<std::string> unary_elementwise_ops{
+    "Abs", "Cast", "Ceil", "Clip", "Cos", "Elu", "Erf", "Exp", "Floor", "HardSigmoid", "Identity", "IsNaN",
+    "LeakyRelu", "Log", "Neg", "Not", "Reciprocal", "Relu", "Round", "Selu", "Sigmoid", "Sign", "Sin", "Softplus",
+    "Softsign", "Sqrt", "Tan", "Tanh", "ThresholdedRelu"};
+
+// Elementwise ops with two inputs that are broadcast to each other.
+static const std::unordered_set<std::string> binary_elementwise_ops{
+    "Add", "And", "Div", "Equal", "Greater", "Less", "Max", "Min", "Mul", "Or", "Pow", "PRelu", "Sub", "Sum", "Xor"};
+
+static const std::unordered_set<std::string> reduce_ops{
+    "ReduceL1", "ReduceL2", "ReduceLogSum", "ReduceLogSumExp", "ReduceMax", "ReduceMean", "ReduceMin", "ReduceProd",
+    "ReduceSum", "ReduceSumSquare"};
+
+static bool IsOnnxOp(const Node& node, const std::unordered_set<std::string>& op_types) {
+  return op_types.count(node.OpType()) != 0 && graph_utils::MatchesOpSetDomain(node, kOnnxDomain);
+}
+
+// Get the perm of a Transpose node. The default perm reverses the dims, so it needs the rank of the input.
+static bool GetPerm(const Node& transpose, std::vector<int64_t>& perm) {
+  if (graph_utils::GetRepeatedNodeAttributeValues(transpose, "perm", perm)) {
+    return !perm.empty();
+  }
+
+  const auto* shape = transpose.InputDefs()[0]->Shape();
+  if (shape == nullptr || shape->dim_size() == 0) {
+    return false;
+  }
+
+  perm.resize(shape->dim_size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    perm[i] = static_cast<int64_t>(perm.size() - i - 1);
+  }
+  return true;
+}
+
+static bool IsIdentityPerm(const std::vector<int64_t>& perm) {
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::vector<int64_t> InvertPerm(const std::vector<int64_t>& perm) {
+  std::vector<int64_t> inverse(perm.size());
+  for (size_t i = 0; i < perm.size(); ++i) {
+    inverse[perm[i]] = static_cast<int64_t>(i);
+  }
+  return inverse;
+}
+
+// Normalize an axis attribute value of an op on a tensor of the given rank.
+static bool NormalizeAxis(int64_t& axis, int64_t rank) {
+  if (axis < 0) {
+    axis += rank;
+  }
+  return axis >= 0 && axis < rank;
+}
+
+// Get the Transpose producing an input of node if it has the given perm and no other consumers.
+static Node* GetInputTranspose(Graph& graph, const Node& node, int input_index, const std::vector<int64_t>& perm) {
+  Node* transpose = graph_utils::GetInputNode(graph, node, input_index);
+  std::vector<int64_t> input_perm;
+  if (transpose == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*transpose, "Transpose", {1}) ||
+      transpose->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+      transpose->GetOutputEdgesCount() != 1 || !graph.GetNodeOutputsInGraphOutputs(*transpose).empty() ||
+      !GetPerm(*transpose, input_perm) || input_perm != perm) {
+    return nullptr;
+  }
+  return transpose;
+}
+
+// Remove a Transpose with an identity perm. If it produces a graph output, the node producing its input is updated
+// to produce the graph output instead.
+static bool RemoveIdentityTranspose(Graph& graph, Node& transpose) {
+  if (graph_utils::CanRemoveNode(graph, transpose)) {
+    return graph_utils::RemoveNode(graph, transpose);
+  }
+
+  Node* input_node = graph_utils::GetInputNode(graph, transpose, 0);
+  if (input_node == nullptr || !graph.GetNodeOutputsInGraphOutputs(*input_node).empty() ||
+      transpose.GetOutputEdgesCount() != 0) {
+    return false;
+  }
+
+  // the input of the Transpose must not have other consumers
+  const NodeArg* input = transpose.InputDefs()[0];
+  int output_index = -1;
+  int num_consumers = 0;
+  for (auto it = input_node->OutputEdgesBegin(); it != input_node->OutputEdgesEnd(); ++it) {
+    if (input_node->OutputDefs()[it->GetSrcArgIndex()] == input) {
+      output_index = it->GetSrcArgIndex();
+      ++num_consumers;
+    }
+  }
+
+  if (num_consumers != 1) {
+    return false;
+  }
+
+  graph.RemoveEdge(input_node->Index(), transpose.Index(), output_index, 0);
+  input_node->MutableOutputDefs()[output_index] = transpose.MutableOutputDefs()[0];
+  graph.RemoveNode(transpose.Index());
+  return true;
+}
+
+// Insert a Transpose after an output of node. node produces a new NodeArg, and the Transpose transposes it to the
+// original output for the consumers of the output.
+static Node& InsertTransposeAfter(Graph& graph, Node& node, int output_index, const std::vector<int64_t>& perm) {
+  NodeArg* output = node.MutableOutputDefs()[output_index];
+
+  std::vector<std::pair<NodeIndex, int>> consumers;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (it->GetSrcArgIndex() == output_index) {
+      consumers.emplace_back(it->GetNode().Index(), it->GetDstArgIndex());
+    }
+  }
+  for (const auto& consumer : consumers) {
+    graph.RemoveEdge(node.Index(), consumer.first, output_index, consumer.second);
+  }
+
+  // the shape of the new output is in the layout of the input of node, so leave it to shape inferencing
+  std::unique_ptr<TypeProto> type;
+  if (output->TypeAsProto() != nullptr) {
+    type = onnxruntime::make_unique<TypeProto>(*output->TypeAsProto());
+    type->mutable_tensor_type()->clear_shape();
+  }
+  NodeArg& new_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output->Name()), type.get());
+  node.MutableOutputDefs()[output_index] = &new_output;
+
+  Node& transpose = graph.AddNode(graph.GenerateNodeName("Transpose"), "Transpose", "pushed down Transpose",
+                                  {&new_output}, {output});
+  transpose.AddAttribute("perm", perm);
+  transpose.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  graph.AddEdge(node.Index(), transpose.Index(), output_index, 0);
+  for (const auto& consumer : consumers) {
+    graph.AddEdge(transpose.Index(), consumer.first, 0, consumer.second);
+  }
+
+  return transpose;
+}
+
+static size_t GetElementSize(int32_t data_type) {
+  switch (data_type) {
+    case TensorProto_DataType_FLOAT16:
+      return sizeof(uint16_t);
+    case TensorProto_DataType_FLOAT:
+    case TensorProto_DataType_INT32:
+      return sizeof(int32_t);
+    case TensorProto_DataType_DOUBLE:
+    case TensorProto_DataType_INT64:
+      return sizeof(int64_t);
+    default:
+      return 0;
+  }
+}
+
+// Get a constant input of a binary op in the layout of the input of the Transpose being pushed below the op.
+// The constant is broadcast to the output of the Transpose, so its dims are padded with leading 1s and it is
+// transposed by the inverse of perm. Only constants that don't broadcast the output of the Transpose to a larger
+// shape are supported.
+static NodeArg* GetTransposedConstant(Graph& graph, const NodeArg& input, const Node& transpose,
+                                      const std::vector<int64_t>& perm) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, input.Name());
+  const size_t element_size = tensor_proto != nullptr ? GetElementSize(tensor_proto->data_type()) : 0;
+  const int rank = static_cast<int>(perm.size());
+  if (element_size == 0 || tensor_proto->dims_size() > rank) {
+    return nullptr;
+  }
+
+  // a scalar broadcasts the same way in any layout
+  if (tensor_proto->dims_size() == 0) {
+    return graph.GetNodeArg(input.Name());
+  }
+
+  const auto* transposed_shape = transpose.OutputDefs()[0]->Shape();
+  std::vector<int64_t> dims(rank - tensor_proto->dims_size(), 1);
+  for (int i = 0; i < tensor_proto->dims_size(); ++i) {
+    const int64_t dim = tensor_proto->dims(i);
+    const int axis = static_cast<int>(dims.size());
+    if (dim != 1 && (transposed_shape == nullptr || transposed_shape->dim_size() != rank ||
+                     !transposed_shape->dim(axis).has_dim_value() ||
+                     transposed_shape->dim(axis).dim_value() != dim)) {
+      return nullptr;
+    }
+    dims.push_back(dim);
+  }
+
+  const std::vector<int64_t> inverse_perm = InvertPerm(perm);
+  std::vector<int64_t> new_dims(rank);
+  for (int i = 0; i < rank; ++i) {
+    new_dims[i] = dims[inverse_perm[i]];
+  }
+
+  Initializer src(*tensor_proto);
+  Initializer dst(static_cast<TensorProto_DataType>(tensor_proto->data_type()),
+                  graph.GenerateNodeArgName(input.Name() + "_transposed"), new_dims);
+  const char* src_data = src.data<char>();
+  char* dst_data = dst.data<char>();
+
+  // walk the output in order, keeping the offset of the current element in the input
+  std::vector<int64_t> src_strides(rank, 1);
+  for (int i = rank - 2; i >= 0; --i) {
+    src_strides[i] = src_strides[i + 1] * dims[i + 1];
+  }
+  std::vector<int64_t> index(rank, 0);
+  int64_t src_offset = 0;
+  for (int64_t i = 0; i < dst.size(); ++i) {
+    std::memcpy(dst_data + i * element_size, src_data + src_offset * element_size, element_size);
+    for (int axis = rank - 1; axis >= 0; --axis) {
+      const int64_t src_stride = src_strides[inverse_perm[axis]];
+      if (++index[axis] < new_dims[axis]) {
+        src_offset += src_stride;
+        break;
+      }
+      src_offset -= (new_dims[axis] - 1) * src_stride;
+      index[axis] = 0;
+    }
+  }
+
+  TensorProto new_tensor_proto;
+  dst.ToProto(new_tensor_proto);
+  return &graph_utils::AddInitializer(graph, new_tensor_proto);
+}
+
+// Fold a 2D Transpose into the transA or transB attribute of the Gemm or MatMul consuming it.
+static bool FoldIntoGemm(Graph& graph, Node& transpose, Node& consumer, int input_index,
+                         const std::vector<int64_t>& perm) {
+  if (perm != std::vector<int64_t>{1, 0} || input_index > 1) {
+    return false;
+  }
+
+  const std::string trans_attr = input_index == 0 ? "transA" : "transB";
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "Gemm", {7, 9, 11})) {
+    const auto* attr = graph_utils::GetNodeAttribute(consumer, trans_attr);
+    const int64_t trans = attr != nullptr ? attr->i() : 0;
+    graph_utils::BypassInputNode(graph, consumer, input_index, transpose);
+    consumer.AddAttribute(trans_attr, static_cast<int64_t>(trans == 0 ? 1 : 0));
+    graph_utils::RemoveNodeIfUnused(graph, transpose);
+    return true;
+  }
+
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "MatMul", {1, 9})) {
+    return false;
+  }
+
+  // a MatMul can be replaced by a Gemm if it multiplies float matrices, and Gemm doesn't require the C input
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_version = domain_to_version.find(kOnnxDomain);
+  if (onnx_version == domain_to_version.end() || onnx_version->second < 11) {
+    return false;
+  }
+
+  for (const NodeArg* input : consumer.InputDefs()) {
+    if (input->Type() == nullptr || *input->Type() != "tensor(float)" ||
+        input->Shape() == nullptr || input->Shape()->dim_size() != 2) {
+      return false;
+    }
+  }
+
+  // leave a MatMul followed by an Add to MatMulAddFusion, as a Gemm with the bias can have its inputs folded later
+  if (consumer.GetOutputEdgesCount() == 1 &&
+      graph_utils::IsSupportedOptypeVersionAndDomain(*consumer.OutputNodesBegin(), "Add", {7})) {
+    return false;
+  }
+
+  graph_utils::BypassInputNode(graph, consumer, input_index, transpose);
+  Node& gemm_node = graph.AddNode(graph.GenerateNodeName("Gemm"), "Gemm", "MatMul with folded Transpose",
+                                  consumer.MutableInputDefs(), {});
+  gemm_node.AddAttribute(trans_attr, static_cast<int64_t>(1));
+  gemm_node.SetExecutionProviderType(consumer.GetExecutionProviderType());
+
+  graph_utils::FinalizeNodeFusion(graph, {consumer}, gemm_node);
+  graph_utils::RemoveNodeIfUnused(graph, transpose);
+  return true;
+}
+
+// Update the axes of a reduction to the layout of the input of the Transpose pushed below it, and get the perm of
+// the Transpose to insert after it. The perm is empty if the reduced output doesn't need a Transpose.
+static bool RemapReduceAxes(Node& reduce, const std::vector<int64_t>& perm, std::vector<int64_t>& output_perm) {
+  std::vector<int64_t> axes;
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(reduce, reduce.OpType(), {1, 11}) ||
+      !graph_utils::GetRepeatedNodeAttributeValues(reduce, "axes", axes) || axes.empty()) {
+    return false;
+  }
+
+  const int64_t rank = static_cast<int64_t>(perm.size());
+  std::vector<bool> is_reduced(perm.size(), false);
+  for (auto& axis : axes) {
+    if (!NormalizeAxis(axis, rank)) {
+      return false;
+    }
+    axis = perm[axis];
+    is_reduced[axis] = true;
+  }
+
+  const auto* keepdims_attr = graph_utils::GetNodeAttribute(reduce, "keepdims");
+  if (keepdims_attr == nullptr || keepdims_attr->i() != 0) {
+    output_perm = perm;
+  } else {
+    // the kept axes are renumbered in the output
+    std::vector<int64_t> output_axis(perm.size(), 0);
+    int64_t num_kept = 0;
+    for (size_t i = 0; i < perm.size(); ++i) {
+      output_axis[i] = num_kept;
+      num_kept += is_reduced[i] ? 0 : 1;
+    }
+
+    output_perm.clear();
+    for (auto axis : perm) {
+      if (!is_reduced[axis]) {
+        output_perm.push_back(output_axis[axis]);
+      }
+    }
+
+    if (IsIdentityPerm(output_perm)) {
+      output_perm.clear();
+    }
+  }
+
+  reduce.AddAttribute("axes", axes);
+  return true;
+}
+
+// Push a Transpose with a single consumer below the consumer. next_transpose is set to the Transpose after the
+// consumer to keep pushing down, if any.
+static bool PushDown(Graph& graph, Node& transpose, Node& consumer, int input_index,
+                     const std::vector<int64_t>& perm, Node*& next_transpose) {
+  next_transpose = nullptr;
+  const int64_t rank = static_cast<int64_t>(perm.size());
+  const bool is_split = graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "Split", {2, 11});
+  if (consumer.OutputDefs().empty() || (!is_split && consumer.OutputDefs().size() != 1)) {
+    return false;
+  }
+
+  if (IsOnnxOp(consumer, unary_elementwise_ops)) {
+    if (input_index != 0) {
+      return false;
+    }
+  } else if (IsOnnxOp(consumer, binary_elementwise_ops)) {
+    if (consumer.InputDefs().size() != 2) {
+      return false;
+    }
+
+    // the other input is transposed the same way, or is a constant that can be transposed instead
+    const int other_index = 1 - input_index;
+    Node* other_transpose = GetInputTranspose(graph, consumer, other_index, perm);
+    if (other_transpose != nullptr) {
+      graph_utils::BypassInputNode(graph, consumer, other_index, *other_transpose);
+      graph_utils::RemoveNodeIfUnused(graph, *other_transpose);
+    } else {
+      NodeArg* constant = GetTransposedConstant(graph, *consumer.InputDefs()[other_index], transpose, perm);
+      if (constant == nullptr) {
+        return false;
+      }
+      graph_utils::ReplaceNodeInput(consumer, other_index, *constant);
+    }
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "Concat", {4, 11})) {
+    // all the inputs must be transposed the same way
+    const int num_inputs = static_cast<int>(consumer.InputDefs().size());
+    std::vector<Node*> input_transposes(num_inputs, nullptr);
+    for (int i = 0; i < num_inputs; ++i) {
+      input_transposes[i] = GetInputTranspose(graph, consumer, i, perm);
+      if (input_transposes[i] == nullptr) {
+        return false;
+      }
+    }
+
+    const auto* axis_attr = graph_utils::GetNodeAttribute(consumer, "axis");
+    int64_t axis = axis_attr != nullptr ? axis_attr->i() : 0;
+    if (axis_attr == nullptr || !NormalizeAxis(axis, rank)) {
+      return false;
+    }
+
+    for (int i = 0; i < num_inputs; ++i) {
+      if (i != input_index) {
+        graph_utils::BypassInputNode(graph, consumer, i, *input_transposes[i]);
+        graph_utils::RemoveNodeIfUnused(graph, *input_transposes[i]);
+      }
+    }
+    consumer.AddAttribute("axis", perm[axis]);
+  } else if (IsOnnxOp(consumer, reduce_ops)) {
+    std::vector<int64_t> output_perm;
+    if (input_index != 0 || !RemapReduceAxes(consumer, perm, output_perm)) {
+      return false;
+    }
+
+    graph_utils::BypassInputNode(graph, consumer, 0, transpose);
+    graph_utils::RemoveNodeIfUnused(graph, transpose);
+    if (!output_perm.empty()) {
+      next_transpose = &InsertTransposeAfter(graph, consumer, 0, output_perm);
+    }
+    return true;
+  } else if (is_split) {
+    // splitting produces a Transpose per output, so only push down if they all cancel out with the consumers of
+    // the outputs
+    const auto* axis_attr = graph_utils::GetNodeAttribute(consumer, "axis");
+    int64_t axis = axis_attr != nullptr ? axis_attr->i() : 0;
+    if (input_index != 0 || !NormalizeAxis(axis, rank)) {
+      return false;
+    }
+
+    const std::vector<int64_t> inverse_perm = InvertPerm(perm);
+    std::vector<int> num_consumers(consumer.OutputDefs().size(), 0);
+    for (auto it = consumer.OutputEdgesBegin(); it != consumer.OutputEdgesEnd(); ++it) {
+      std::vector<int64_t> consumer_perm;
+      if (!graph_utils::IsSupportedOptypeVersionAndDomain(it->GetNode(), "Transpose", {1}) ||
+          !GetPerm(it->GetNode(), consumer_perm) || consumer_perm != inverse_perm) {
+        return false;
+      }
+      ++num_consumers[it->GetSrcArgIndex()];
+    }
+
+    if (!graph.GetNodeOutputsInGraphOutputs(consumer).empty() ||
+        std::find(num_consumers.begin(), num_consumers.end(), 0) != num_consumers.end()) {
+      return false;
+    }
+
+    graph_utils::BypassInputNode(graph, consumer, 0, transpose);
+    graph_utils::RemoveNodeIfUnused(graph, transpose);
+    consumer.AddAttribute("axis", perm[axis]);
+    for (int i = 0; i < static_cast<int>(consumer.OutputDefs().size()); ++i) {
+      InsertTransposeAfter(graph, consumer, i, perm);
+    }
+    return true;
+  } else {
+    return false;
+  }
+
+  graph_utils::BypassInputNode(graph, consumer, input_index, transpose);
+  graph_utils::RemoveNodeIfUnused(graph, transpose);
+  next_transpose = &InsertTransposeAfter(graph, consumer, 0, perm);
+  return true;
+}
+
+// Optimize a Transpose. Returns the Transpose to continue with if it was moved, or nullptr if there is none.
+static Node* OptimizeTranspose(Graph& graph, Node& transpose, bool& modified) {
+  std::vector<int64_t> perm;
+  if (!GetPerm(transpose, perm)) {
+    return nullptr;
+  }
+
+  if (IsIdentityPerm(perm)) {
+    if (RemoveIdentityTranspose(graph, transpose)) {
+      modified = true;
+    }
+    return nullptr;
+  }
+
+  // merge with the Transpose producing the input
+  Node* input_node = graph_utils::GetInputNode(graph, transpose, 0);
+  std::vector<int64_t> input_perm;
+  if (input_node != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*input_node, "Transpose", {1}) &&
+      input_node->GetExecutionProviderType() == transpose.GetExecutionProviderType() &&
+      GetPerm(*input_node, input_perm) && input_perm.size() == perm.size()) {
+    std::vector<int64_t> merged_perm(perm.size());
+    for (size_t i = 0; i < perm.size(); ++i) {
+      merged_perm[i] = input_perm[perm[i]];
+    }
+
+    graph_utils::BypassInputNode(graph, transpose, 0, *input_node);
+    transpose.AddAttribute("perm", merged_perm);
+    graph_utils::RemoveNodeIfUnused(graph, *input_node);
+    modified = true;
+    return &transpose;
+  }
+
+  if (transpose.GetOutputEdgesCount() != 1 || !graph.GetNodeOutputsInGraphOutputs(transpose).empty()) {
+    return nullptr;
+  }
+
+  auto consumer_edge = transpose.OutputEdgesBegin();
+  Node& consumer = *graph.GetNode(consumer_edge->GetNode().Index());
+  const int input_index = consumer_edge->GetDstArgIndex();
+  if (consumer.GetExecutionProviderType() != transpose.GetExecutionProviderType() ||
+      input_index >= static_cast<int>(consumer.InputDefs().size())) {
+    return nullptr;
+  }
+
+  if (FoldIntoGemm(graph, transpose, consumer, input_index, perm)) {
+    modified = true;
+    return nullptr;
+  }
+
+  Node* next_transpose = nullptr;
+  if (PushDown(graph, transpose, consumer, input_index, perm, next_transpose)) {
+    modified = true;
+  }
+  return next_transpose;
+}
+
+Status TransposeOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // we removed the node as part of an earlier optimization
+
+    ORT_RETURN_IF_ERROR(Recurse(*p_node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(*p_node, "Transpose", {1}) ||
+        !graph_utils::IsSupportedProvider(*p_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // keep moving the Transpose down until it cancels out or can't be moved any further
+    Node* transpose = p_node;
+    while (transpose != nullptr) {
+      transpose = OptimizeTranspose(graph, *transpose, modified);
+    }
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
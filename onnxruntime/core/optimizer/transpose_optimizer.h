@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TransposeOptimizer
+
+Transformer that moves Transpose nodes down the graph so they cancel out, as in models converted from NHWC
+frameworks where the layout is transposed back and forth around each Conv.
+
+For each Transpose:
+  - consecutive Transposes are merged, and removed if they are inverses.
+  - a Transpose is pushed below a consumer that doesn't depend on the layout of its input: unary elementwise ops,
+    broadcasting binary ops where the other input is transposed the same way or is a constant, Concat where all
+    the inputs are transposed the same way, reductions and Split with the axes remapped.
+  - a 2D Transpose consumed by Gemm or MatMul is folded into the transA or transB attribute of a Gemm.
+*/
+class TransposeOptimizer : public GraphTransformer {
+ public:
+  TransposeOptimizer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TransposeOptimizer", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -83,6 +83,13 @@ class Env {
   virtual common::Status GetFileLength(
       const ORTCHAR_T* file_path, size_t& length) const = 0;
 
+  /**
+   * Gets the time the specified file was last modified, in a platform specific unit.
+   * The value is only meaningful when compared with another value from the same platform.
+   */
+  virtual common::Status GetFileModificationTime(
+      const ORTCHAR_T* file_path, int64_t& modification_time) const = 0;
+
   /**
    * Copies the content of the file into the provided buffer.
    * @param file_path The path to the file.
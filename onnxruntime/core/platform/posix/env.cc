@@ -141,6 +141,21 @@ class PosixEnv : public Env {
     return Status::OK();
   }
 
+  Status GetFileModificationTime(const ORTCHAR_T* file_path, int64_t& modification_time) const override {
+    struct stat stbuf;
+    if (stat(file_path, &stbuf) != 0) {
+      return ReportSystemError("stat", file_path);
+    }
+
+#if defined(__APPLE__)
+    const auto& mtime = stbuf.st_mtimespec;
+#else
+    const auto& mtime = stbuf.st_mtim;
+#endif
+    modification_time = static_cast<int64_t>(mtime.tv_sec) * 1000000000 + static_cast<int64_t>(mtime.tv_nsec);
+    return Status::OK();
+  }
+
   Status ReadFileIntoBuffer(
       const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
       gsl::span<char> buffer) const override {
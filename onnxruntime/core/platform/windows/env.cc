@@ -102,6 +102,20 @@ class WindowsEnv : public Env {
     return Status::OK();
   }
 
+  Status GetFileModificationTime(const ORTCHAR_T* file_path, int64_t& modification_time) const override {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(file_path, GetFileExInfoStandard, &attributes)) {
+      const int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "GetFileAttributesEx ", ToMBString(file_path),
+                             " fail, errcode = ", err);
+    }
+    ULARGE_INTEGER write_time;
+    write_time.LowPart = attributes.ftLastWriteTime.dwLowDateTime;
+    write_time.HighPart = attributes.ftLastWriteTime.dwHighDateTime;
+    modification_time = static_cast<int64_t>(write_time.QuadPart);
+    return Status::OK();
+  }
+
   Status ReadFileIntoBuffer(
       const ORTCHAR_T* const file_path, const FileOffsetType offset, const size_t length,
       const gsl::span<char> buffer) const override {
@@ -12,6 +12,10 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // keep a per-thread cache of small free chunks in front of the arena
+  bool enable_arena_thread_cache{false};
+  // let the Gemm and MatMul kernels keep a pre-packed copy of their constant weights
+  bool enable_weight_prepacking{true};
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -26,10 +30,12 @@ using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&,
 class CPUExecutionProvider : public IExecutionProvider {
  public:
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info)
-      : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
+      : IExecutionProvider{onnxruntime::kCpuExecutionProvider},
+        enable_weight_prepacking_{info.enable_weight_prepacking} {
     DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
                                                 [](int) { return onnxruntime::make_unique<TAllocator>(); },
                                                 std::numeric_limits<size_t>::max()};
+    device_info.arena_thread_cache_config.enable = info.enable_arena_thread_cache;
 
 #ifdef USE_JEMALLOC
     #if defined(USE_MIMALLOC)
@@ -54,7 +60,10 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
 
+  bool WeightPrepackingEnabled() const { return enable_weight_prepacking_; }
+
  private:
   std::vector<FuseRuleFn> fuse_rules_;
+  bool enable_weight_prepacking_;
 };
 }  // namespace onnxruntime
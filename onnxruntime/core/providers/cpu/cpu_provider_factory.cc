@@ -10,28 +10,37 @@
 namespace onnxruntime {
 
 struct CpuProviderFactory : IExecutionProviderFactory {
-  CpuProviderFactory(bool create_arena) : create_arena_(create_arena) {}
+  CpuProviderFactory(bool create_arena, bool enable_weight_prepacking)
+      : create_arena_(create_arena), enable_weight_prepacking_(enable_weight_prepacking) {}
   ~CpuProviderFactory() override = default;
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
   bool create_arena_;
+  bool enable_weight_prepacking_;
 };
 
 std::unique_ptr<IExecutionProvider> CpuProviderFactory::CreateProvider() {
   CPUExecutionProviderInfo info;
   info.create_arena = create_arena_;
+  info.enable_weight_prepacking = enable_weight_prepacking_;
   return onnxruntime::make_unique<CPUExecutionProvider>(info);
 }
 
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena,
+                                                                            bool enable_weight_prepacking) {
+  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0, enable_weight_prepacking);
+}
+
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena) {
-  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0);
+  return CreateExecutionProviderFactory_CPU(use_arena, true);
 }
 
 }  // namespace onnxruntime
 
 ORT_API_STATUS_IMPL(OrtSessionOptionsAppendExecutionProvider_CPU, _In_ OrtSessionOptions* options, int use_arena) {
-  options->provider_factories.push_back(onnxruntime::CreateExecutionProviderFactory_CPU(use_arena));
+  options->provider_factories.push_back(
+      onnxruntime::CreateExecutionProviderFactory_CPU(use_arena, options->value.enable_cpu_weight_prepacking));
   return nullptr;
 }
 
@@ -6,16 +6,31 @@
 #include "core/util/math.h"
 #include "core/mlas/inc/mlas.h"
 
+#include <algorithm>
 #include <cmath>
+#include <type_traits>
 
 namespace onnxruntime {
 
-#define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      OP_TYPE,                                                                     \
-      VERSION,                                                                     \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+// the outputs of these kernels are computed elementwise, so the allocation planner may write an output to the buffer
+// of an input with the same shape when the node is the last consumer of the input. the variadic kernels only allow
+// it for the first input, as some of them read the other inputs after writing to the output.
+#define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)                          \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                   \
+      OP_TYPE,                                                                                      \
+      VERSION,                                                                                      \
+      TYPE,                                                                                         \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      KERNEL_CLASS<TYPE>);
+
+#define REG_ELEMENTWISE_BINARY_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                 \
+      OP_TYPE,                                                                    \
+      VERSION,                                                                    \
+      TYPE,                                                                       \
+      KernelDefBuilder()                                                          \
+          .MayInplace({{0, 0}, {1, 0}})                                           \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),              \
       KERNEL_CLASS<TYPE>);
 
 #define REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
@@ -33,7 +48,7 @@ namespace onnxruntime {
       OP_TYPE,                                                                                        \
       VERSION_FROM, VERSION_TO,                                                                       \
       TYPE,                                                                                           \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                    \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),   \
       KERNEL_CLASS<TYPE>);
 
 #define REG_ELEMENTWISE_LOGICALOP_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS) \
@@ -46,25 +61,25 @@ namespace onnxruntime {
           .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),                                           \
       KERNEL_CLASS<TYPE>);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, float, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, double, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int32_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int64_t, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, float, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, double, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, int32_t, Add);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Add, 7, int64_t, Add);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, float, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, double, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int32_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int64_t, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, float, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, double, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, int32_t, Sub);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Sub, 7, int64_t, Sub);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, float, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, double, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int32_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int64_t, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, float, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, double, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, int32_t, Mul);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Mul, 7, int64_t, Mul);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, float, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, double, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int32_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int64_t, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, float, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, double, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, int32_t, Div);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Div, 7, int64_t, Div);
 
 REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, float, Abs);
 REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, double, Abs);
@@ -91,8 +106,8 @@ REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 6, float, Reciprocal);
 REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, float, Sqrt);
 REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, double, Sqrt);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Pow, 7, float, Pow);
-REG_ELEMENTWISE_TYPED_KERNEL(Pow, 7, double, Pow);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Pow, 7, float, Pow);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(Pow, 7, double, Pow);
 
 REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, float, Exp);
 REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, double, Exp);
@@ -129,10 +144,10 @@ REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(Equal, 11, float, Equal);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mean, 6, 7, float, Mean_6);
 REG_ELEMENTWISE_TYPED_KERNEL(Mean, 8, float, Mean_8);
 
-REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint8_t, BitShift);
-//REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint16_t, BitShift);
-REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint32_t, BitShift);
-REG_ELEMENTWISE_TYPED_KERNEL(BitShift, 11, uint64_t, BitShift);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(BitShift, 11, uint8_t, BitShift);
+//REG_ELEMENTWISE_BINARY_TYPED_KERNEL(BitShift, 11, uint16_t, BitShift);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(BitShift, 11, uint32_t, BitShift);
+REG_ELEMENTWISE_BINARY_TYPED_KERNEL(BitShift, 11, uint64_t, BitShift);
 
 REG_ELEMENTWISE_TYPED_KERNEL(Erf, 9, float, Erf);
 
@@ -173,8 +188,124 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Xor);
 
+// classify the broadcast of an input against the output shape for MlasComputeBinaryOperation. the output is viewed
+// as [outer, channel, inner] where the input is broadcast over the leading (outer) and trailing (inner) axes and
+// matches the output over the axes in between. returns false if the input doesn't fit that pattern.
+static bool GetMlasBroadcast(const std::vector<int64_t>& input_dims, const std::vector<int64_t>& output_dims,
+                             MLAS_BINARY_BROADCAST_KIND& broadcast, size_t& outer, size_t& channel, size_t& inner) {
+  enum { kLeading,
+         kMatching,
+         kTrailing } stage = kLeading;
+
+  outer = channel = inner = 1;
+
+  for (size_t i = 0; i < output_dims.size(); i++) {
+    const auto dim = static_cast<size_t>(output_dims[i]);
+    if (dim == 1)
+      continue;
+
+    if (input_dims[i] == output_dims[i]) {
+      if (stage == kTrailing)
+        return false;
+      stage = kMatching;
+      channel *= dim;
+    } else if (stage == kLeading) {
+      outer *= dim;
+    } else {
+      stage = kTrailing;
+      inner *= dim;
+    }
+  }
+
+  if (stage == kLeading)
+    return false;
+
+  if (inner == 1) {
+    // the input is a single row that is repeated for each outer index
+    broadcast = MlasRowBroadcast;
+    inner = channel;
+    channel = 1;
+  } else {
+    broadcast = MlasChannelBroadcast;
+  }
+
+  return true;
+}
+
+// compute a float binary elementwise op with the MLAS kernels, which are vectorized and split the output across
+// the thread pool. only the same shape, scalar, per-channel and per-row broadcasts are handled, so this returns
+// false for anything else and the caller falls back to the general broadcaster.
+static bool TryMlasBinaryOperation(OpKernelContext& context, MLAS_BINARY_OPERATION_KIND kind) {
+  const Tensor& A = *context.Input<Tensor>(0);
+  const Tensor& B = *context.Input<Tensor>(1);
+
+  const auto& a_shape = A.Shape().GetDims();
+  const auto& b_shape = B.Shape().GetDims();
+  const size_t rank = std::max(a_shape.size(), b_shape.size());
+
+  // align the shapes to the right, padding with leading 1's
+  std::vector<int64_t> a_dims(rank, 1);
+  std::vector<int64_t> b_dims(rank, 1);
+  std::copy(a_shape.begin(), a_shape.end(), a_dims.begin() + (rank - a_shape.size()));
+  std::copy(b_shape.begin(), b_shape.end(), b_dims.begin() + (rank - b_shape.size()));
+
+  std::vector<int64_t> output_dims(rank);
+  for (size_t i = 0; i < rank; i++) {
+    if (a_dims[i] == b_dims[i] || b_dims[i] == 1) {
+      output_dims[i] = a_dims[i];
+    } else if (a_dims[i] == 1) {
+      output_dims[i] = b_dims[i];
+    } else {
+      // let the general broadcaster report the invalid shapes
+      return false;
+    }
+
+    if (output_dims[i] == 0)
+      return false;
+  }
+
+  const TensorShape output_shape(output_dims);
+  const int64_t a_size = A.Shape().Size();
+  const int64_t b_size = B.Shape().Size();
+  const int64_t output_size = output_shape.Size();
+
+  MLAS_BINARY_BROADCAST_KIND broadcast_a = MlasNoBroadcast;
+  MLAS_BINARY_BROADCAST_KIND broadcast_b = MlasNoBroadcast;
+  size_t outer = 1;
+  size_t channel = 1;
+  size_t inner = static_cast<size_t>(output_size);
+
+  if (a_size == output_size) {
+    if (b_size == 1) {
+      broadcast_b = MlasScalarBroadcast;
+    } else if (b_size != output_size && !GetMlasBroadcast(b_dims, output_dims, broadcast_b, outer, channel, inner)) {
+      return false;
+    }
+  } else if (b_size == output_size) {
+    if (a_size == 1) {
+      broadcast_a = MlasScalarBroadcast;
+    } else if (!GetMlasBroadcast(a_dims, output_dims, broadcast_a, outer, channel, inner)) {
+      return false;
+    }
+  } else {
+    // both inputs are broadcast
+    return false;
+  }
+
+  Tensor& C = *context.Output(0, output_shape);
+
+  MlasComputeBinaryOperation(kind, A.Data<float>(), broadcast_a, B.Data<float>(), broadcast_b,
+                             C.MutableData<float>(), outer, channel, inner, context.GetOperatorThreadPool());
+
+  return true;
+}
+
 template <typename T>
 Status Add<T>::Compute(OpKernelContext* context) const {
+  if (std::is_same<T, float>::value && TryMlasBinaryOperation(*context, MlasAddBinaryOperation)) {
+    return Status::OK();
+  }
+
   return BroadcastTwo<T, T>(
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 + input1.array(); },
@@ -184,6 +315,10 @@ Status Add<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Sub<T>::Compute(OpKernelContext* context) const {
+  if (std::is_same<T, float>::value && TryMlasBinaryOperation(*context, MlasSubtractBinaryOperation)) {
+    return Status::OK();
+  }
+
   return BroadcastTwo<T, T>(
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 - input1.array(); },
@@ -193,6 +328,10 @@ Status Sub<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Mul<T>::Compute(OpKernelContext* context) const {
+  if (std::is_same<T, float>::value && TryMlasBinaryOperation(*context, MlasMultiplyBinaryOperation)) {
+    return Status::OK();
+  }
+
   return BroadcastTwo<T, T>(
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 * input1.array(); },
@@ -202,6 +341,10 @@ Status Mul<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Div<T>::Compute(OpKernelContext* context) const {
+  if (std::is_same<T, float>::value && TryMlasBinaryOperation(*context, MlasDivideBinaryOperation)) {
+    return Status::OK();
+  }
+
   return BroadcastTwo<T, T>(
       *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 / input1.array(); },
@@ -344,6 +487,10 @@ Status Min_6<float>::Compute(OpKernelContext* ctx) const {
 
 template <>
 Status Min_8<float>::Compute(OpKernelContext* context) const {
+  if (Node().InputArgCount().front() == 2 && TryMlasBinaryOperation(*context, MlasMinimumBinaryOperation)) {
+    return Status::OK();
+  }
+
   return BroadcastVariadic<float, float>(
       Node(), *context,
       [](EigenVectorMap<float> output, float input0, ConstEigenVectorMap<float> input1) { output = input1.array().min(input0); },
@@ -371,6 +518,11 @@ Status Max_6<float>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status Max_8<T>::Compute(OpKernelContext* context) const {
+  if (std::is_same<T, float>::value && Node().InputArgCount().front() == 2 &&
+      TryMlasBinaryOperation(*context, MlasMaximumBinaryOperation)) {
+    return Status::OK();
+  }
+
   return BroadcastVariadic<T, T>(
       Node(), *context,
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input1.array().max(input0); },
@@ -594,14 +746,14 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sin,
     7,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sin<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     Sin,
     7,
     double,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Sin<double>);
 
 template <typename T>
@@ -621,7 +773,7 @@ class Cos final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Cos,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Cos<float>);
 
 template <typename T>
@@ -641,7 +793,7 @@ class Tan final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Tan,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Tan<float>);
 
 template <typename T>
@@ -661,7 +813,7 @@ class Asin final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Asin,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Asin<float>);
 
 template <typename T>
@@ -681,7 +833,7 @@ class Acos final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Acos,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Acos<float>);
 
 template <typename T>
@@ -701,7 +853,7 @@ class Atan final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Atan,
     7,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Atan<float>);
 
 template <typename T>
@@ -721,7 +873,7 @@ class Sinh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Sinh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Sinh<float>);
 
 template <typename T>
@@ -741,7 +893,7 @@ class Cosh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Cosh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Cosh<float>);
 
 template <typename T>
@@ -773,7 +925,7 @@ class Asinh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Asinh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Asinh<float>);
 
 template <typename T>
@@ -805,7 +957,7 @@ class Acosh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Acosh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Acosh<float>);
 
 template <typename T>
@@ -837,7 +989,7 @@ class Atanh final : public OpKernel {
 ONNX_CPU_OPERATOR_KERNEL(
     Atanh,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Atanh<float>);
 
 template <>
@@ -862,7 +1014,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     PRelu,
     7,
     9,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     PRelu<float>);
 
 // This is a special case version of TBroadcaster just for Expand that only has a shape as the second parameter
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/gemm.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 
@@ -26,4 +27,138 @@ ONNX_CPU_OPERATOR_KERNEL(
     11,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gemm<float>);
+
+static Status GetMlasActivation(const std::string& activation, float leaky_relu_alpha, MLAS_ACTIVATION& mlas_activation) {
+  if (activation == "Relu") {
+    mlas_activation.ActivationKind = MlasReluActivation;
+  } else if (activation == "Sigmoid") {
+    mlas_activation.ActivationKind = MlasLogisticActivation;
+  } else if (activation == "Tanh") {
+    mlas_activation.ActivationKind = MlasTanhActivation;
+  } else if (activation == "LeakyRelu") {
+    mlas_activation.ActivationKind = MlasLeakyReluActivation;
+    mlas_activation.Parameters.LeakyRelu.alpha = leaky_relu_alpha;
+  } else {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Not implemented fused activation: ", activation);
+  }
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+
+  const auto* X = context->Input<Tensor>(0);
+  const auto* W = context->Input<Tensor>(1);
+  const auto* B = context->Input<Tensor>(2);
+  // Bias could be missing. Treat as scalar 0 if that is the case.
+  GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, W->Shape(), trans_B_ != CblasNoTrans,
+                    B != nullptr ? B->Shape() : TensorShape({}));
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  int64_t M = helper.M();
+  int64_t N = helper.N();
+  int64_t K = helper.K();
+  auto Y = context->Output(0, {M, N});
+  // if input is empty tensor, return directly as nothing need to be calculated.
+  if (M == 0 || N == 0)
+    return Status::OK();
+  float* y_data = Y->MutableData<float>();
+
+  // A bias of (N,), (1, N) or (M, N) is added by the epilogue of the gemm while each block of the output is still in
+  // cache, as is the fused activation. Other biases are broadcast to the output first and scaled by beta in the gemm.
+  // Passing 0 for beta if there is no such bias lets the gemm ignore any junk in the output buffer.
+  MLAS_SGEMM_EPILOGUE epilogue{nullptr, nullptr, 0, nullptr};
+  float beta = 0;
+
+  if (beta_ != 0 && B != nullptr) {
+    auto output_mat = EigenMatrixMapRowMajor<float>(y_data, M, N);
+    const auto& b_shape = B->Shape();
+    const float* b_data = B->Data<float>();
+    const bool add_in_epilogue = beta_ == 1.0f && K > 0;
+    if (b_shape.Size() == 1) {
+      // B is (), (1,) or (1, 1), set the scalar
+      output_mat.setConstant(*b_data);
+      beta = beta_;
+    } else if (b_shape.NumDimensions() == 1 || b_shape[0] == 1) {
+      // B is (N,) or (1, N)
+      if (add_in_epilogue) {
+        epilogue.Bias = b_data;
+      } else {
+        output_mat.rowwise() = ConstEigenVectorMap<float>(b_data, N).transpose();
+        beta = beta_;
+      }
+    } else if (b_shape[1] == 1) {
+      // B is (M, 1)
+      output_mat.colwise() = ConstEigenVectorMap<float>(b_data, M);
+      beta = beta_;
+    } else {
+      // B is (M, N), no broadcast needed.
+      if (add_in_epilogue) {
+        epilogue.Addend = b_data;
+        epilogue.ldaddend = static_cast<size_t>(N);
+      } else {
+        output_mat = ConstEigenMatrixMapRowMajor<float>(b_data, M, N);
+        beta = beta_;
+      }
+    }
+  }
+
+  MLAS_ACTIVATION activation;
+  if (!activation_.empty()) {
+    ORT_RETURN_IF_ERROR(GetMlasActivation(activation_, leaky_relu_alpha_, activation));
+    epilogue.Activation = &activation;
+  }
+
+  const bool has_epilogue = epilogue.Bias != nullptr || epilogue.Addend != nullptr || epilogue.Activation != nullptr;
+
+  // W * x
+  const size_t lda = static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M);
+  if (packed_b_) {
+    // W is an initializer that was packed when the kernel was created
+    MlasGemm(trans_A_, M, N, K, alpha_, X->Data<float>(), lda, packed_b_.get(), beta, y_data, N,
+             has_epilogue ? &epilogue : nullptr, tp);
+  } else {
+    const size_t ldb = static_cast<size_t>(trans_B_ == CblasNoTrans ? N : K);
+    MlasGemm(trans_A_, trans_B_, M, N, K, alpha_, X->Data<float>(), lda, W->Data<float>(), ldb, beta, y_data, N,
+             has_epilogue ? &epilogue : nullptr, tp);
+  }
+
+  return Status::OK();
+}
+
+bool GemmPackBFp32(const OpKernelInfo& info, const Tensor& tensor_b, bool trans_b, BufferUniquePtr& packed_b) {
+  const auto* provider = info.GetExecutionProvider();
+  if (provider->Type() == kCpuExecutionProvider &&
+      !static_cast<const CPUExecutionProvider*>(provider)->WeightPrepackingEnabled()) {
+    return false;
+  }
+
+  const auto& b_shape = tensor_b.Shape();
+  if (b_shape.NumDimensions() != 2 || tensor_b.DataType() != DataTypeImpl::GetType<float>()) {
+    return false;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+  if (K == 0 || N == 0) {
+    return false;
+  }
+
+  const size_t packed_b_size = MlasGemmPackBSize(N, K);
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+
+  MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                N,
+                K,
+                tensor_b.Data<float>(),
+                static_cast<size_t>(b_shape[1]),
+                packed_b_data);
+  return true;
+}
+
 }  // namespace onnxruntime
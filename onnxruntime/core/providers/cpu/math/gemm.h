@@ -9,9 +9,15 @@
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
+// Packs a constant float B of Gemm or MatMul to the layout used by MlasGemm, so that it is packed once when the
+// kernel is created instead of on every call. Returns false if B is not a 2D tensor, or if weight pre-packing is
+// disabled for the CPU execution provider (SessionOptions::enable_cpu_weight_prepacking).
+bool GemmPackBFp32(const OpKernelInfo& info, const Tensor& tensor_b, bool trans_b, BufferUniquePtr& packed_b);
+
 template <typename T>
 class Gemm : public OpKernel {
  public:
@@ -25,6 +31,11 @@ class Gemm : public OpKernel {
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+    const Tensor* W;
+    if (std::is_same<T, float>::value && info.TryGetConstantInput(1, &W)) {
+      GemmPackBFp32(info, *W, trans_B_ != CblasNoTrans, packed_b_);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -94,6 +105,7 @@ class Gemm : public OpKernel {
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
+  BufferUniquePtr packed_b_;
 
  protected:
   // For fused gemm + activation
@@ -101,4 +113,8 @@ class Gemm : public OpKernel {
   float leaky_relu_alpha_;
 };
 
+// the float kernel runs the bias, the fused activation and a constant W packed at construction through MlasGemm
+template <>
+Status Gemm<float>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
@@ -92,4 +92,121 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+// Returns true if the offsets step by a fixed stride across the batches. The stride is zero for an input that is
+// broadcast to all the batches.
+static bool TryGetBatchStride(const std::vector<size_t>& offsets, size_t& stride) {
+  stride = offsets.size() > 1 ? offsets[1] - offsets[0] : 0;
+  for (size_t i = 1; i < offsets.size(); i++) {
+    if (offsets[i] != offsets[0] + i * stride) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <>
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  const auto& left_offsets = helper.LeftOffsets();
+  const auto& right_offsets = helper.RightOffsets();
+  const auto& output_offsets = helper.OutputOffsets();
+  size_t max_len = output_offsets.size();
+
+  // run the batches in a single parallel region when the inputs are evenly strided, as with the attention heads of
+  // a transformer, instead of splitting each of the small multiplications across the threads
+  size_t left_stride;
+  size_t right_stride;
+  size_t output_stride;
+  const bool is_strided_batch = max_len > 1 &&
+                                TryGetBatchStride(left_offsets, left_stride) &&
+                                TryGetBatchStride(output_offsets, output_stride);
+
+  // the packed B is 2D, so only the offsets of A and Y change across the batches
+  if (packed_b_) {
+    if (is_strided_batch) {
+      MlasGemmBatch(
+          CblasNoTrans,
+          M,
+          N,
+          K,
+          1.0f,
+          left_X->Data<float>() + left_offsets[0],
+          K,
+          left_stride,
+          packed_b_.get(),
+          0.0f,
+          Y->MutableData<float>() + output_offsets[0],
+          N,
+          output_stride,
+          max_len,
+          thread_pool);
+      return Status::OK();
+    }
+
+    for (size_t i = 0; i < max_len; i++) {
+      MlasGemm(
+          CblasNoTrans,
+          M,
+          N,
+          K,
+          1.0f,
+          left_X->Data<float>() + left_offsets[i],
+          K,
+          packed_b_.get(),
+          0.0f,
+          Y->MutableData<float>() + output_offsets[i],
+          N,
+          thread_pool);
+    }
+    return Status::OK();
+  }
+
+  if (is_strided_batch && TryGetBatchStride(right_offsets, right_stride)) {
+    MlasGemmBatch(
+        CblasNoTrans,
+        CblasNoTrans,
+        M,
+        N,
+        K,
+        1.0f,
+        left_X->Data<float>() + left_offsets[0],
+        K,
+        left_stride,
+        right_X->Data<float>() + right_offsets[0],
+        N,
+        right_stride,
+        0.0f,
+        Y->MutableData<float>() + output_offsets[0],
+        N,
+        output_stride,
+        max_len,
+        thread_pool);
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < max_len; i++) {
+    math::MatMul<float>(
+        static_cast<int>(M),
+        static_cast<int>(N),
+        static_cast<int>(K),
+        left_X->Data<float>() + left_offsets[i],
+        right_X->Data<float>() + right_offsets[i],
+        Y->MutableData<float>() + output_offsets[i], thread_pool);
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
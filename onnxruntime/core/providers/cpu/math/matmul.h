@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/gemm.h"
 
 namespace onnxruntime {
 
@@ -13,9 +14,19 @@ class MatMul final : public OpKernel {
  public:
   MatMul(const OpKernelInfo& info)
       : OpKernel(info) {
+    const Tensor* B;
+    if (std::is_same<T, float>::value && info.TryGetConstantInput(1, &B)) {
+      GemmPackBFp32(info, *B, false, packed_b_);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  BufferUniquePtr packed_b_;
 };
 
+template <>
+Status MatMul<float>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
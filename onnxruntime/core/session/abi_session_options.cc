@@ -95,6 +95,54 @@ ORT_API_STATUS_IMPL(OrtApis::DisableCpuMemArena, _In_ OrtSessionOptions* options
   return nullptr;
 }
 
+// pre-pack the constant weights of the CPU Gemm and MatMul kernels
+ORT_API_STATUS_IMPL(OrtApis::EnableCpuWeightPrepacking, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_weight_prepacking = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableCpuWeightPrepacking, _In_ OrtSessionOptions* options) {
+  options->value.enable_cpu_weight_prepacking = false;
+  return nullptr;
+}
+
+// coalesce the concurrent RunBatched calls into batches
+ORT_API_STATUS_IMPL(OrtApis::EnableRequestBatching, _In_ OrtSessionOptions* options, int max_batch_size,
+                    int64_t max_delay_us, int num_threads) {
+  if (max_batch_size <= 0 || max_delay_us < 0 || num_threads <= 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "max_batch_size and num_threads must be positive and max_delay_us non-negative");
+  }
+
+  options->value.request_batching_max_batch_size = max_batch_size;
+  options->value.request_batching_max_delay_us = max_delay_us;
+  options->value.request_batching_num_threads = num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableRequestBatching, _In_ OrtSessionOptions* options) {
+  options->value.request_batching_max_batch_size = 0;
+  return nullptr;
+}
+
+// limit the size of the outputs of the nodes folded by constant folding. 0 means there is no limit.
+ORT_API_STATUS_IMPL(OrtApis::SetMaxConstantFoldingOutputBytes, _In_ OrtSessionOptions* options,
+                    size_t max_output_bytes) {
+  options->value.max_constant_folding_output_bytes = max_output_bytes;
+  return nullptr;
+}
+
+// execute the nodes in an order that reduces the peak size of the intermediate values
+ORT_API_STATUS_IMPL(OrtApis::EnableMemoryAwareNodeOrder, _In_ OrtSessionOptions* options) {
+  options->value.enable_memory_aware_node_order = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableMemoryAwareNodeOrder, _In_ OrtSessionOptions* options) {
+  options->value.enable_memory_aware_node_order = false;
+  return nullptr;
+}
+
 ///< logger id to use for session output
 ORT_API_STATUS_IMPL(OrtApis::SetSessionLogId, _In_ OrtSessionOptions* options, const char* logid) {
   options->value.session_logid = logid;
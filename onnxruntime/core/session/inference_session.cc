@@ -7,6 +7,7 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -36,6 +37,7 @@
 #include "core/framework/sequential_executor.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/parallel_executor.h"
+#include "core/framework/session_state_cache.h"
 #include "core/framework/session_state_initializer.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
@@ -51,6 +53,7 @@
 #endif
 #include "core/session/IOBinding.h"
 #include "core/session/custom_ops.h"
+#include "core/session/request_batcher.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/graph_transformer_utils.h"
@@ -111,7 +114,9 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
       session_state_(execution_providers_,
                      session_options.enable_mem_pattern && session_options.execution_mode == ExecutionMode::ORT_SEQUENTIAL,
                      thread_pool_.get(),
-                     inter_op_thread_pool_.get()),
+                     inter_op_thread_pool_.get(),
+                     session_options.mem_pattern_cache_options,
+                     session_options.max_idle_execution_frames),
       insert_cast_transformer_("CastFloat16Transformer") {
   ORT_ENFORCE(Environment::IsInitialized(),
               "Environment must be initialized before creating an InferenceSession.");
@@ -125,11 +130,21 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
     StartProfiling(session_options.profile_file_prefix);
   }
 
+  if (session_options.sampling_profiler_interval > 0) {
+    sampling_profiler_ = onnxruntime::make_unique<profiling::SamplingProfiler>(
+        session_options.sampling_profiler_interval, session_options.sampling_profiler_buffer_size);
+    session_state_.SetSamplingProfiler(sampling_profiler_.get());
+  }
+
   // a monotonically increasing session id for use in telemetry
   session_id_ = global_session_id_.fetch_add(1);
 }
 
 InferenceSession::~InferenceSession() {
+  // wait for the pending RunAsync and RunBatched calls as they use the rest of the session
+  async_run_thread_pool_.reset();
+  request_batcher_.reset();
+
   if (session_options_.enable_profiling) {
     try {
       EndProfiling();
@@ -181,7 +196,11 @@ common::Status InferenceSession::RegisterGraphTransformer(std::unique_ptr<onnxru
   if (p_graph_transformer == nullptr) {
     return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for graph transformer");
   }
-  return graph_transformation_mgr_.Register(std::move(p_graph_transformer), level);
+  ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(std::move(p_graph_transformer), level));
+
+  // the session state cache can't tell whether a cache was created with the same transformer
+  has_registered_graph_transformers_ = true;
+  return Status::OK();
 }
 
 common::Status InferenceSession::AddCustomTransformerList(const std::vector<std::string>& transformers_to_enable) {
@@ -275,6 +294,15 @@ common::Status InferenceSession::Load(const std::basic_string<T>& model_uri) {
     oss << "Load model from " << ToMBString(model_uri) << " failed:" << st.ErrorMessage();
     return common::Status(st.Category(), st.Code(), oss.str());
   }
+
+  // identify the model by its file instead of hashing its contents, which would need to read it again
+  if (!session_options_.session_state_cache_filepath.empty()) {
+    auto hash_status = SessionStateCache::HashModelFile(model_location_, model_hash_);
+    if (!hash_status.IsOK()) {
+      LOGS(*session_logger_, INFO) << "Not using the session state cache: " << hash_status.ErrorMessage();
+      model_hash_ = 0;
+    }
+  }
   return Status::OK();
 }
 
@@ -290,6 +318,9 @@ common::Status InferenceSession::Load(const std::wstring& model_uri) {
 
 common::Status InferenceSession::Load(const ModelProto& model_proto) {
   auto loader = [this, &model_proto](std::shared_ptr<onnxruntime::Model>& model) {
+    if (!session_options_.session_state_cache_filepath.empty()) {
+      model_hash_ = SessionStateCache::HashModel(model_proto);
+    }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
     LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
@@ -304,6 +335,9 @@ common::Status InferenceSession::Load(const ModelProto& model_proto) {
 
 common::Status InferenceSession::Load(std::unique_ptr<ModelProto> p_model_proto) {
   auto loader = [this, &p_model_proto](std::shared_ptr<onnxruntime::Model>& model) {
+    if (!session_options_.session_state_cache_filepath.empty()) {
+      model_hash_ = SessionStateCache::HashModel(*p_model_proto);
+    }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
     LoadInterOp(*p_model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
@@ -327,6 +361,9 @@ common::Status InferenceSession::Load(std::istream& model_istream) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
+    if (!session_options_.session_state_cache_filepath.empty()) {
+      model_hash_ = SessionStateCache::HashModel(model_proto);
+    }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
     LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
@@ -348,6 +385,9 @@ common::Status InferenceSession::Load(const void* model_data, int model_data_len
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
+    if (!session_options_.session_state_cache_filepath.empty()) {
+      model_hash_ = SessionStateCache::HashModel(model_data, static_cast<size_t>(model_data_len));
+    }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
     LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
@@ -375,7 +415,8 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   // 5. insert cast nodes.
 
   // first apply global(execution provider independent),  level 1(default/system/basic) graph to graph optimizations
-  ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1));
+  ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1,
+                                                                         &session_profiler_));
 
 #ifdef USE_DML
   // TODO: this is a temporary workaround to apply the DML EP's custom graph transformer prior to partitioning. This
@@ -401,7 +442,8 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   // apply transformers except default transformers
   // Default transformers are required for correctness and they are owned and run by inference session
   for (int i = static_cast<int>(TransformerLevel::Level1); i < static_cast<int>(TransformerLevel::MaxTransformerLevel); i++) {
-    ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformer_mgr.ApplyTransformers(graph, static_cast<TransformerLevel>(i)));
+    ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformer_mgr.ApplyTransformers(graph, static_cast<TransformerLevel>(i),
+                                                                           &session_profiler_));
   }
 
   bool modified = false;
@@ -472,8 +514,11 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
       auto subgraph_session_state = onnxruntime::make_unique<SessionState>(execution_providers_,
                                                                            session_state.GetEnableMemoryPattern(),
                                                                            session_state.GetThreadPool(),
-                                                                           session_state.GetInterOpThreadPool());
+                                                                           session_state.GetInterOpThreadPool(),
+                                                                           session_state.GetMemoryPatternCacheOptions(),
+                                                                           session_options_.max_idle_execution_frames);
       subgraph_session_state->SetProfiler(session_profiler_);
+      subgraph_session_state->SetSamplingProfiler(sampling_profiler_.get());
       subgraph_session_state->SetLogger(*session_logger_);
       // Pass data transfer manager to subgraph.
       subgraph_session_state->SetDataTransferMgr(&session_state.GetDataTransferMgr());
@@ -514,11 +559,13 @@ common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, Sessio
 
       // setup everything required to execute the subgraph and save it in subgraph_session_state
       SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, subgraph,
-                                          *subgraph_session_state, execution_providers_, kernel_registry_manager_);
+                                          *subgraph_session_state, execution_providers_, kernel_registry_manager_,
+                                          session_options_.enable_external_data_mmap);
 
       const auto implicit_inputs = node.ImplicitInputDefs();
       ORT_RETURN_IF_ERROR_SESSIONID_(initializer.CreatePlan(&node, &implicit_inputs,
-                                                            session_options_.execution_mode));
+                                                            session_options_.execution_mode,
+                                                            session_options_.enable_memory_aware_node_order));
 
       // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
       //                                                   &*subgraph_info.session_state);
@@ -558,6 +605,7 @@ common::Status InferenceSession::Initialize() {
     if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.enable_weight_prepacking = session_options_.enable_cpu_weight_prepacking;
       auto p_cpu_exec_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
@@ -574,8 +622,6 @@ common::Status InferenceSession::Initialize() {
     // add predefined transformers
     AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level, transformers_to_enable_);
 
-    onnxruntime::Graph& graph = model_->MainGraph();
-
     // Collect the kernel registries from execution provider instances;
     // There are 2 kinds of kernel registries with priority from high to low as below,
     // 1. Custom execution provider type specific kernel registries.
@@ -586,17 +632,58 @@ common::Status InferenceSession::Initialize() {
     // Register 2nd registries into KernelRegistryManager.
     ORT_RETURN_IF_ERROR_SESSIONID_(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
+    // replace the model with the optimized and partitioned one from the session state cache if it's valid
+    // the model hash is 0 if the model couldn't be identified when loading it
+    std::string cache_config_key;
+    bool use_session_state_cache = !session_options_.session_state_cache_filepath.empty() && model_hash_ != 0;
+    if (use_session_state_cache && has_registered_graph_transformers_) {
+      LOGS(*session_logger_, INFO) << "Not using the session state cache as graph transformers were registered.";
+      use_session_state_cache = false;
+    }
+
+    if (use_session_state_cache) {
+      cache_config_key = SessionStateCache::CreateConfigKey(execution_providers_.GetIds(), session_options_,
+                                                            transformers_to_enable_);
+
+      std::shared_ptr<onnxruntime::Model> cached_model;
+      auto cache_status = SessionStateCache::Load(session_options_.session_state_cache_filepath, model_hash_,
+                                                  cache_config_key,
+                                                  HasLocalSchema() ? &custom_schema_registries_ : nullptr,
+                                                  cached_model);
+      if (cache_status.IsOK()) {
+        model_ = cached_model;
+        loaded_from_session_state_cache_ = true;
+
+        // the model metadata refers to the inputs and outputs of the replaced graph
+        required_inputs_.clear();
+        input_def_map_.clear();
+        output_def_list_.clear();
+        model_output_names_.clear();
+        ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+
+        LOGS(*session_logger_, INFO) << "Loaded the optimized graph from the session state cache.";
+      } else {
+        LOGS(*session_logger_, INFO) << "Not using the session state cache: " << cache_status.ErrorMessage();
+      }
+    }
+
+    onnxruntime::Graph& graph = model_->MainGraph();
+
     SessionStateInitializer session_initializer(session_options_.enable_mem_pattern, model_location_, graph,
-                                                session_state_, execution_providers_, kernel_registry_manager_);
+                                                session_state_, execution_providers_, kernel_registry_manager_,
+                                                session_options_.enable_external_data_mmap);
 
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR_SESSIONID_(CreateSubgraphSessionState(graph, session_state_));
 
-    // apply any transformations to the main graph and any subgraphs
-    ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
-                                                  execution_providers_, kernel_registry_manager_,
-                                                  insert_cast_transformer_,
-                                                  session_state_));
+    // apply any transformations to the main graph and any subgraphs. a graph from the session state cache has
+    // already been transformed and partitioned.
+    if (!loaded_from_session_state_cache_) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
+                                                    execution_providers_, kernel_registry_manager_,
+                                                    insert_cast_transformer_,
+                                                    session_state_));
+    }
 
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
     ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
@@ -611,7 +698,24 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
-    ORT_RETURN_IF_ERROR_SESSIONID_(session_initializer.CreatePlan(nullptr, nullptr, session_options_.execution_mode));
+    // unlike the optimized model, the cache can hold graphs optimized for the CPU at any level as it's only used
+    // on a CPU with the same features
+    if (use_session_state_cache && !loaded_from_session_state_cache_) {
+      if (SessionStateCache::CanSave(graph)) {
+        auto cache_status = SessionStateCache::Save(session_options_.session_state_cache_filepath, model_hash_,
+                                                    cache_config_key, *model_);
+        if (!cache_status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Failed to write the session state cache: "
+                                          << cache_status.ErrorMessage();
+        }
+      } else {
+        LOGS(*session_logger_, INFO) << "Not writing the session state cache as the graph has nodes that can't be "
+                                        "cached, such as nodes compiled by an execution provider.";
+      }
+    }
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(session_initializer.CreatePlan(nullptr, nullptr, session_options_.execution_mode,
+                                                                  session_options_.enable_memory_aware_node_order));
 
     // handle any subgraphs
     ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(graph, session_state_));
@@ -647,6 +751,10 @@ const SessionOptions& InferenceSession::GetSessionOptions() const {
   return session_options_;
 }
 
+MemoryPatternCacheStats InferenceSession::GetMemoryPatternCacheStats() const {
+  return session_state_.GetMemoryPatternCacheStats();
+}
+
 common::Status InferenceSession::CheckShapes(const std::string& input_name,
                                              const TensorShape& input_shape,
                                              const TensorShape& expected_shape) const {
@@ -851,6 +959,71 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
   return retval;
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                          RunAsyncCallback callback) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_NOT(callback, "A callback is required for RunAsync.");
+
+  std::call_once(async_run_thread_pool_created_, [this]() {
+    int num_threads = session_options_.async_run_num_threads;
+    if (num_threads <= 0) {
+      num_threads = std::max<int>(1, std::thread::hardware_concurrency() / 2);
+    }
+
+    // unlike the other pools the calling thread doesn't participate, so create a pool even for a single thread
+    async_run_thread_pool_ = onnxruntime::make_unique<concurrency::ThreadPool>("async_run_thread_pool", num_threads);
+  });
+
+  // the vectors are moved into the task. std::function requires a copyable callable so they're held by shared_ptr.
+  struct AsyncRun {
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> output_names;
+    RunAsyncCallback callback;
+  };
+
+  auto async_run = std::make_shared<AsyncRun>(
+      AsyncRun{std::move(feed_names), std::move(feeds), std::move(output_names), std::move(callback)});
+
+  async_run_thread_pool_->Schedule([this, &run_options, async_run]() {
+    std::vector<OrtValue> fetches;
+    auto status = Run(run_options, async_run->feed_names, async_run->feeds, async_run->output_names, &fetches);
+    async_run->callback(status, fetches);
+  });
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::RunBatched(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
+                                            std::vector<OrtValue>* p_fetches) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_NOT(session_options_.request_batching_max_batch_size > 0,
+                    "RunBatched requires SessionOptions::request_batching_max_batch_size to be set.");
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+
+  std::call_once(request_batcher_created_, [this]() {
+    RequestBatcherOptions options;
+    options.max_batch_size = session_options_.request_batching_max_batch_size;
+    options.max_delay = std::chrono::microseconds(session_options_.request_batching_max_delay_us);
+    options.num_threads = session_options_.request_batching_num_threads;
+    request_batcher_ = onnxruntime::make_unique<RequestBatcher>(*this, options);
+  });
+
+  auto result = request_batcher_->Submit(feeds, output_names).get();
+  ORT_RETURN_IF_ERROR(result.status);
+  *p_fetches = std::move(result.fetches);
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -987,6 +1160,13 @@ std::string InferenceSession::EndProfiling() {
   return std::string();
 }
 
+common::Status InferenceSession::GetOpLatencyStats(std::vector<profiling::OpLatencyStats>& stats) const {
+  ORT_RETURN_IF_NOT(sampling_profiler_ != nullptr,
+                    "The sampling profiler is not enabled. Set SessionOptions.sampling_profiler_interval to enable it.");
+  stats = sampling_profiler_->GetOpLatencyStats();
+  return Status::OK();
+}
+
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
   // TODO add other post load processing here
@@ -1123,7 +1303,8 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
                                                  const std::vector<std::string>& custom_list) {
   auto add_transformers = [&](TransformerLevel level) {
     // Generate and register transformers for level
-    auto transformers_to_register = optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list);
+    auto transformers_to_register = optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list,
+                                                                          session_options_.max_constant_folding_output_bytes);
     for (auto& entry : transformers_to_register) {
       transformer_manager.Register(std::move(entry), level);
     }
@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
+#include "core/common/sampling_profiler.h"
 #include "core/common/status.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/framework_common.h"
@@ -43,6 +46,7 @@ class IExecutionProvider;  // forward decl
 class IOBinding;
 class CustomRegistry;
 class Notification;
+class RequestBatcher;
 
 namespace logging {
 class LoggingManager;
@@ -179,6 +183,30 @@ class InferenceSession {
                      const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
                      std::vector<OrtValue>* p_fetches);
 
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+    * Run a pre-loaded and pre-initialized model asynchronously on a thread pool owned by the session.
+    * The session waits for the pending runs to complete when it's destroyed.
+    * @param run_options must stay valid until the callback is invoked.
+    * @param callback invoked on a thread of the pool with the status of the run and the fetches in the order
+    *        specified by output_names. Must not throw or destroy the session.
+    * @return OK if the run was scheduled.
+    */
+  common::Status RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                          RunAsyncCallback callback);
+
+  /**
+    * Run a pre-loaded and pre-initialized model as part of a batch of the concurrent RunBatched calls, see
+    * RequestBatcher. The feeds must be CPU tensors with the batch on axis 0. Blocks until the batch has run.
+    * Requires SessionOptions::request_batching_max_batch_size to be set.
+    * @param p_fetches output values in the order specified by output_names, with the rows of this call only.
+    * @return OK if success.
+    */
+  common::Status RunBatched(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
+                            std::vector<OrtValue>* p_fetches);
+
   /**
     * Run a pre-loaded and pre-intialized model.
     * Multiple threads are allowed to run this function; hence its thread-safe.
@@ -256,6 +284,11 @@ class InferenceSession {
    */
   const SessionOptions& GetSessionOptions() const;
 
+  /**
+    * Get the counters of the memory pattern cache of the main graph.
+    */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
   /**
     * Start profiling on this inference session. This simply turns on profiling events to be
     * recorded. A corresponding EndProfiling has to follow to write profiling data to a file.
@@ -278,6 +311,13 @@ class InferenceSession {
     */
   std::string EndProfiling();
 
+  /**
+    * Get the latency statistics per op type of the recent runs recorded by the sampling profiler.
+    * Can be called while the session is running.
+    * @return an error if the sampling profiler isn't enabled in the SessionOptions.
+    */
+  common::Status GetOpLatencyStats(std::vector<profiling::OpLatencyStats>& stats) const;
+
  protected:
   /**
     * Load an ONNX model.
@@ -311,6 +351,15 @@ class InferenceSession {
   // The file path of where the model was loaded. e.g. /tmp/test_squeezenet/model.onnx
   std::basic_string<ORTCHAR_T> model_location_;
 
+  // true if the optimized and partitioned graph was loaded from SessionOptions::session_state_cache_filepath
+  bool loaded_from_session_state_cache_ = false;
+
+  // identifies the loaded model in the session state cache. 0 if the cache isn't used.
+  uint64_t model_hash_ = 0;
+
+  // true if a transformer was registered with RegisterGraphTransformer, which the session state cache can't key on
+  bool has_registered_graph_transformers_ = false;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InferenceSession);
 
@@ -381,6 +430,9 @@ class InferenceSession {
   // Profiler for this session.
   profiling::Profiler session_profiler_;
 
+  // Sampling profiler for this session. nullptr if not enabled.
+  std::unique_ptr<profiling::SamplingProfiler> sampling_profiler_;
+
   // The list of execution providers.
   ExecutionProviders execution_providers_;
 
@@ -389,6 +441,14 @@ class InferenceSession {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Threadpool for RunAsync calls. Created on first use.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> async_run_thread_pool_;
+  std::once_flag async_run_thread_pool_created_;
+
+  // Batcher for RunBatched calls. Created on first use.
+  std::unique_ptr<RequestBatcher> request_batcher_;
+  std::once_flag request_batcher_created_;
+
  protected:
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
@@ -456,16 +456,14 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In
   API_IMPL_END
 }
 
-ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
-                    _In_opt_ const OrtRunOptions* run_options,
-                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
-                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtValue** output) {
-  API_IMPL_BEGIN
-  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+static OrtStatus* CreateFeedsAndOutputNames(_In_ const char* const* input_names, _In_ const OrtValue* const* input,
+                                            size_t input_len, _In_ const char* const* output_names1,
+                                            size_t output_names_len, std::vector<std::string>& feed_names,
+                                            std::vector<OrtValue>& feeds, std::vector<std::string>& output_names) {
   const int queue_id = 0;
 
-  std::vector<std::string> feed_names(input_len);
-  std::vector<OrtValue> feeds(input_len);
+  feed_names.resize(input_len);
+  feeds.resize(input_len);
 
   for (size_t i = 0; i != input_len; ++i) {
     if (input_names[i] == nullptr || input_names[i][0] == '\0') {
@@ -479,7 +477,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
   }
 
   // Create output feed
-  std::vector<std::string> output_names(output_names_len);
+  output_names.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
       return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
@@ -487,6 +485,26 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
     output_names[i] = output_names1[i];
   }
 
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const int queue_id = 0;
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  auto* create_status = CreateFeedsAndOutputNames(input_names, input, input_len, output_names1, output_names_len,
+                                                  feed_names, feeds, output_names);
+  if (create_status != nullptr) {
+    return create_status;
+  }
+
   std::vector<OrtValue> fetches(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output[i] != nullptr) {
@@ -518,6 +536,91 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len,
+                    _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  if (callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be null");
+  }
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  auto* create_status = CreateFeedsAndOutputNames(input_names, input, input_len, output_names1, output_names_len,
+                                                  feed_names, feeds, output_names);
+  if (create_status != nullptr) {
+    return create_status;
+  }
+
+  // shared by the runs without run options. it's never terminated.
+  static const OrtRunOptions default_run_options;
+
+  auto status = session->RunAsync(
+      run_options == nullptr ? default_run_options : *run_options, std::move(feed_names), std::move(feeds),
+      std::move(output_names),
+      [callback, user_data](const Status& run_status, std::vector<OrtValue>& fetches) {
+        if (!run_status.IsOK()) {
+          callback(user_data, nullptr, 0, ToOrtStatus(run_status));
+          return;
+        }
+
+        const int queue_id = 0;
+        std::vector<OrtValue*> outputs(fetches.size());
+        for (size_t i = 0; i != fetches.size(); ++i) {
+          ::OrtValue& value = fetches[i];
+          if (value.Fence())
+            value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+          outputs[i] = new OrtValue(value);
+        }
+
+        callback(user_data, outputs.data(), outputs.size(), nullptr);
+      });
+
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunBatched, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  auto* create_status = CreateFeedsAndOutputNames(input_names, input, input_len, output_names1, output_names_len,
+                                                  feed_names, feeds, output_names);
+  if (create_status != nullptr) {
+    return create_status;
+  }
+
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output[i] != nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "RunBatched doesn't support pre-allocated outputs");
+    }
+  }
+
+  ::onnxruntime::NameMLValMap feeds_map;
+  for (size_t i = 0; i != feed_names.size(); ++i) {
+    feeds_map.emplace(feed_names[i], feeds[i]);
+  }
+
+  std::vector<OrtValue> fetches;
+  auto status = session->RunBatched(feeds_map, output_names, &fetches);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  for (size_t i = 0; i != output_names_len; ++i) {
+    output[i] = new OrtValue(fetches[i]);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::IsTensor, _In_ const OrtValue* value, int* out) {
   auto v = reinterpret_cast<const ::OrtValue*>(value);
   *out = v->IsTensor() ? 1 : 0;
@@ -1393,6 +1496,15 @@ static constexpr OrtApi ort_api_1 = {
     &OrtApis::ReleaseTensorTypeAndShapeInfo,
     &OrtApis::ReleaseSessionOptions,
     &OrtApis::ReleaseCustomOpDomain,
+    &OrtApis::RunAsync,
+    &OrtApis::EnableCpuWeightPrepacking,
+    &OrtApis::DisableCpuWeightPrepacking,
+    &OrtApis::EnableRequestBatching,
+    &OrtApis::DisableRequestBatching,
+    &OrtApis::RunBatched,
+    &OrtApis::SetMaxConstantFoldingOutputBytes,
+    &OrtApis::EnableMemoryAwareNodeOrder,
+    &OrtApis::DisableMemoryAwareNodeOrder,
 };
 
 ORT_API(const OrtApi*, OrtApis::GetApi, uint32_t version) {
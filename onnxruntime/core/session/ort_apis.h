@@ -38,6 +38,15 @@ ORT_API_STATUS_IMPL(Run, _Inout_ OrtSession* sess,
                     _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                     _In_ const char* const* output_names, size_t output_names_len, _Outptr_ OrtValue** output);
 
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names, size_t output_names_len,
+                    _In_ OrtRunAsyncCallbackFn callback, _In_opt_ void* user_data);
+
+ORT_API_STATUS_IMPL(RunBatched, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names, size_t output_names_len, _Outptr_ OrtValue** output);
+
 ORT_API_STATUS_IMPL(CreateSessionOptions, OrtSessionOptions** out);
 ORT_API_STATUS_IMPL(CloneSessionOptions, const OrtSessionOptions* input, OrtSessionOptions** out);
 ORT_API_STATUS_IMPL(SetSessionExecutionMode, _In_ OrtSessionOptions* options, ExecutionMode execution_mode);
@@ -48,6 +57,14 @@ ORT_API_STATUS_IMPL(EnableMemPattern, _In_ OrtSessionOptions* options);
 ORT_API_STATUS_IMPL(DisableMemPattern, _In_ OrtSessionOptions* options);
 ORT_API_STATUS_IMPL(EnableCpuMemArena, _In_ OrtSessionOptions* options);
 ORT_API_STATUS_IMPL(DisableCpuMemArena, _In_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(EnableCpuWeightPrepacking, _In_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(DisableCpuWeightPrepacking, _In_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(EnableRequestBatching, _In_ OrtSessionOptions* options, int max_batch_size, int64_t max_delay_us,
+                    int num_threads);
+ORT_API_STATUS_IMPL(DisableRequestBatching, _In_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(SetMaxConstantFoldingOutputBytes, _In_ OrtSessionOptions* options, size_t max_output_bytes);
+ORT_API_STATUS_IMPL(EnableMemoryAwareNodeOrder, _In_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(DisableMemoryAwareNodeOrder, _In_ OrtSessionOptions* options);
 ORT_API_STATUS_IMPL(SetSessionLogId, _In_ OrtSessionOptions* options, const char* logid);
 ORT_API_STATUS_IMPL(SetSessionLogVerbosityLevel, _In_ OrtSessionOptions* options, int session_log_verbosity_level);
 ORT_API_STATUS_IMPL(SetSessionLogSeverityLevel, _In_ OrtSessionOptions* options, int session_log_severity_level);
@@ -0,0 +1,308 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "core/framework/data_types.h"
+#include "core/framework/ort_value_tensor_slicer.h"
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+// Create the signature of a request. Returns false if the request can't be batched.
+static bool CreateSignature(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
+                            std::string& signature, int64_t& batch_size) {
+  batch_size = -1;
+
+  // NameMLValMap is unordered so sort the feeds to get the same signature for the same set of feeds
+  std::map<std::string, const OrtValue*> sorted_feeds;
+  for (const auto& feed : feeds) {
+    sorted_feeds.emplace(feed.first, &feed.second);
+  }
+
+  for (const auto& feed : sorted_feeds) {
+    const OrtValue& value = *feed.second;
+    if (!value.IsTensor() || !value.IsAllocated()) {
+      return false;
+    }
+
+    const auto& tensor = value.Get<Tensor>();
+    const auto& dims = tensor.Shape().GetDims();
+    if (dims.empty() || dims[0] <= 0 || tensor.Location().device.Type() != OrtDevice::CPU ||
+        (batch_size != -1 && dims[0] != batch_size)) {
+      return false;
+    }
+
+    batch_size = dims[0];
+    signature += feed.first;
+    signature += ':';
+    signature += std::to_string(reinterpret_cast<uintptr_t>(tensor.DataType()));
+    for (size_t i = 1; i < dims.size(); ++i) {
+      signature += ',';
+      signature += std::to_string(dims[i]);
+    }
+    signature += ';';
+  }
+
+  signature += "->";
+  for (const auto& output_name : output_names) {
+    signature += output_name;
+    signature += ';';
+  }
+
+  return batch_size > 0;
+}
+
+// Copy the elements of src to dst starting at element dst_offset.
+static void CopyElements(const Tensor& src, Tensor& dst, int64_t dst_offset) {
+  const auto num_elements = src.Shape().Size();
+  if (src.DataType() == DataTypeImpl::GetType<std::string>()) {
+    const auto* src_data = src.template Data<std::string>();
+    std::copy(src_data, src_data + num_elements, dst.template MutableData<std::string>() + dst_offset);
+  } else {
+    const auto element_size = src.DataType()->Size();
+    memcpy(static_cast<char*>(dst.MutableDataRaw()) + dst_offset * element_size, src.DataRaw(),
+           num_elements * element_size);
+  }
+}
+
+static OrtValue CreateTensorValue(MLDataType element_type, std::vector<int64_t> dims, const AllocatorPtr& allocator,
+                                  Tensor*& tensor) {
+  auto p_tensor = onnxruntime::make_unique<Tensor>(element_type, TensorShape(std::move(dims)), allocator);
+  tensor = p_tensor.get();
+  OrtValue value;
+  value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return value;
+}
+
+RequestBatcher::RequestBatcher(InferenceSession& session, const RequestBatcherOptions& options)
+    : session_(session), options_(options), allocator_(std::make_shared<CPUAllocator>()) {
+  run_options_.run_tag = options_.run_tag;
+  const int num_threads = std::max(1, options_.num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&RequestBatcher::ProcessRequests, this);
+  }
+}
+
+RequestBatcher::~RequestBatcher() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    shutdown_ = true;
+  }
+
+  cond_var_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::future<BatchedRunResult> RequestBatcher::Submit(const NameMLValMap& feeds,
+                                                     const std::vector<std::string>& output_names) {
+  auto request = onnxruntime::make_unique<Request>();
+  request->feeds = feeds;
+  request->output_names = output_names;
+  if (batching_disabled_ ||
+      !CreateSignature(request->feeds, request->output_names, request->signature, request->batch_size)) {
+    request->batch_size = -1;
+  }
+
+  auto future = request->promise.get_future();
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    ORT_ENFORCE(!shutdown_, "Can't submit a request to a RequestBatcher that is being destroyed.");
+    request->enqueue_time = std::chrono::steady_clock::now();
+    queue_.push_back(std::move(request));
+    ++stats_.num_requests;
+  }
+
+  cond_var_.notify_one();
+  return future;
+}
+
+RequestBatcherStats RequestBatcher::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return stats_;
+}
+
+int64_t RequestBatcher::NumBatchableRows() const {
+  const Request& first = *queue_.front();
+  if (first.batch_size < 0 || batching_disabled_) {
+    return options_.max_batch_size;
+  }
+
+  int64_t num_rows = 0;
+  for (const auto& request : queue_) {
+    if (request->batch_size > 0 && request->signature == first.signature) {
+      num_rows += request->batch_size;
+    }
+  }
+
+  return num_rows;
+}
+
+std::vector<std::unique_ptr<RequestBatcher::Request>> RequestBatcher::TakeBatch() {
+  std::vector<std::unique_ptr<Request>> batch;
+  batch.push_back(std::move(queue_.front()));
+  queue_.pop_front();
+
+  const Request& first = *batch.front();
+  if (first.batch_size < 0 || batching_disabled_) {
+    return batch;
+  }
+
+  int64_t num_rows = first.batch_size;
+  for (auto it = queue_.begin(); it != queue_.end() && num_rows < options_.max_batch_size;) {
+    Request& request = **it;
+    if (request.batch_size > 0 && request.signature == first.signature &&
+        num_rows + request.batch_size <= options_.max_batch_size) {
+      num_rows += request.batch_size;
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return batch;
+}
+
+void RequestBatcher::ProcessRequests() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  while (true) {
+    if (queue_.empty()) {
+      // pending requests are still run when shutting down
+      if (shutdown_) {
+        break;
+      }
+
+      cond_var_.wait(lock);
+      continue;
+    }
+
+    // wait until there are enough requests to fill a batch or the oldest request has waited for the max delay.
+    // another thread may take the requests while this one waits, so check the queue again after waking up.
+    const auto deadline = queue_.front()->enqueue_time + options_.max_delay;
+    const auto now = std::chrono::steady_clock::now();
+    if (!shutdown_ && now < deadline && NumBatchableRows() < options_.max_batch_size) {
+      cond_var_.wait_for(lock, deadline - now);
+      continue;
+    }
+
+    auto batch = TakeBatch();
+    lock.unlock();
+    RunBatch(batch);
+    lock.lock();
+  }
+}
+
+void RequestBatcher::RunRequest(Request& request) {
+  BatchedRunResult result;
+  result.status = session_.Run(run_options_, request.feeds, request.output_names, &result.fetches);
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    ++stats_.num_runs;
+  }
+
+  request.promise.set_value(std::move(result));
+}
+
+void RequestBatcher::RunBatch(std::vector<std::unique_ptr<Request>>& batch) {
+  if (batch.size() == 1) {
+    RunRequest(*batch.front());
+    return;
+  }
+
+  const Request& first = *batch.front();
+  int64_t num_rows = 0;
+  for (const auto& request : batch) {
+    num_rows += request->batch_size;
+  }
+
+  std::vector<std::vector<OrtValue>> request_fetches(batch.size());
+  Status status;
+  try {
+    // concatenate the feeds along axis 0
+    NameMLValMap batch_feeds;
+    for (const auto& feed : first.feeds) {
+      const auto& first_tensor = feed.second.Get<Tensor>();
+      auto dims = first_tensor.Shape().GetDims();
+      dims[0] = num_rows;
+
+      Tensor* batch_tensor = nullptr;
+      OrtValue batch_value = CreateTensorValue(first_tensor.DataType(), std::move(dims), allocator_, batch_tensor);
+      const int64_t row_size = batch_tensor->Shape().SizeFromDimension(1);
+
+      int64_t row = 0;
+      for (const auto& request : batch) {
+        CopyElements(request->feeds.at(feed.first).Get<Tensor>(), *batch_tensor, row * row_size);
+        row += request->batch_size;
+      }
+
+      batch_feeds.emplace(feed.first, std::move(batch_value));
+    }
+
+    std::vector<OrtValue> batch_fetches;
+    status = session_.Run(run_options_, batch_feeds, first.output_names, &batch_fetches);
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      ++stats_.num_runs;
+    }
+
+    if (status.IsOK()) {
+      // slice the fetches along axis 0
+      for (const auto& fetch : batch_fetches) {
+        if (!fetch.IsTensor() || fetch.Get<Tensor>().Shape().NumDimensions() == 0 ||
+            fetch.Get<Tensor>().Shape()[0] != num_rows ||
+            fetch.Get<Tensor>().Location().device.Type() != OrtDevice::CPU) {
+          // the fetches don't have a row for each row of the feeds so the model can't be batched
+          batching_disabled_ = true;
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The model outputs can't be split into the batched requests.");
+          break;
+        }
+
+        const auto& fetch_tensor = fetch.Get<Tensor>();
+        const int64_t row_size = fetch_tensor.Shape().SizeFromDimension(1);
+        auto slicer = OrtValueTensorSlicer<const OrtValue>::Create(fetch);
+        auto slice = slicer.begin();
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+          auto dims = fetch_tensor.Shape().GetDims();
+          dims[0] = batch[i]->batch_size;
+
+          Tensor* request_tensor = nullptr;
+          request_fetches[i].push_back(CreateTensorValue(fetch_tensor.DataType(), std::move(dims), allocator_,
+                                                         request_tensor));
+          for (int64_t row = 0; row < batch[i]->batch_size; ++row, ++slice) {
+            CopyElements((*slice).Get<Tensor>(), *request_tensor, row * row_size);
+          }
+        }
+      }
+    }
+  } catch (const std::exception& ex) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "Exception running batch: ", ex.what());
+  }
+
+  if (!status.IsOK()) {
+    // run the requests on their own so a request that caused the batch to fail doesn't fail the other requests
+    for (auto& request : batch) {
+      RunRequest(*request);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    stats_.num_batched_requests += batch.size();
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i]->promise.set_value(BatchedRunResult{Status::OK(), std::move(request_fetches[i])});
+  }
+}
+
+}  // namespace onnxruntime
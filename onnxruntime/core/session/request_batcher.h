@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class InferenceSession;
+
+struct RequestBatcherOptions {
+  // maximum number of rows, i.e. the sum of the sizes of axis 0 of the feeds of the requests, in a batch.
+  // a request with more rows is run on its own.
+  int64_t max_batch_size = 32;
+
+  // maximum time a request waits for other requests to be batched with.
+  std::chrono::microseconds max_delay{1000};
+
+  // number of batches that can run at the same time, each on a thread owned by the batcher.
+  int num_threads = 2;
+
+  // run tag of the InferenceSession::Run calls.
+  std::string run_tag = "RequestBatcher";
+};
+
+struct RequestBatcherStats {
+  uint64_t num_requests{0};
+  // number of InferenceSession::Run calls, including the requests that were run on their own.
+  uint64_t num_runs{0};
+  // number of requests that were run as part of a batch of more than one request.
+  uint64_t num_batched_requests{0};
+};
+
+struct BatchedRunResult {
+  common::Status status;
+  std::vector<OrtValue> fetches;
+};
+
+/**
+ * Front end for an InferenceSession that coalesces concurrent requests into batches. The requests in a batch are
+ * concatenated along axis 0 of the feeds, run with a single InferenceSession::Run call, and the fetches are sliced
+ * along axis 0 for each request.
+ *
+ * Requests can be batched if they have the same feed names, element types and dims other than axis 0, and the same
+ * output names. Feeds must be CPU tensors. Requests that can't be batched, or that fail as part of a batch, are run
+ * on their own. If the fetches of a batch don't have the rows of the batch on axis 0, the model can't be batched and
+ * all later requests are run on their own.
+ *
+ * Batches are run on a pool of options.num_threads threads owned by the batcher. Requests that are submitted while
+ * all the threads are running a batch form the next batch.
+ * Thread-safe.
+ */
+class RequestBatcher {
+ public:
+  // session must be initialized and outlive the batcher.
+  explicit RequestBatcher(InferenceSession& session, const RequestBatcherOptions& options = {});
+
+  // runs the pending requests before returning.
+  ~RequestBatcher();
+
+  // Submit a request. The fetches of the result are in the order of output_names.
+  std::future<BatchedRunResult> Submit(const NameMLValMap& feeds, const std::vector<std::string>& output_names);
+
+  RequestBatcherStats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RequestBatcher);
+
+  struct Request {
+    NameMLValMap feeds;
+    std::vector<std::string> output_names;
+    // number of rows, or -1 if the request can't be batched
+    int64_t batch_size;
+    // requests can be batched together if they have the same signature
+    std::string signature;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::promise<BatchedRunResult> promise;
+  };
+
+  void ProcessRequests();
+
+  // Remove the oldest request and the requests that can be batched with it from the queue.
+  std::vector<std::unique_ptr<Request>> TakeBatch();
+
+  // Number of rows the oldest request could be batched with.
+  int64_t NumBatchableRows() const;
+
+  void RunBatch(std::vector<std::unique_ptr<Request>>& batch);
+
+  void RunRequest(Request& request);
+
+  InferenceSession& session_;
+  const RequestBatcherOptions options_;
+  RunOptions run_options_;
+  AllocatorPtr allocator_;
+
+  // set if the fetches of a batch couldn't be split into the fetches of the requests
+  std::atomic<bool> batching_disabled_{false};
+
+  mutable OrtMutex mutex_;
+  OrtCondVar cond_var_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  bool shutdown_{false};
+  RequestBatcherStats stats_;
+
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace onnxruntime
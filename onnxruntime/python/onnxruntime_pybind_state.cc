@@ -109,6 +109,8 @@ std::string nuphar_settings;
 
 namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena);
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena,
+                                                                            bool enable_weight_prepacking);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Mkldnn(int use_arena);
@@ -295,7 +297,10 @@ const std::vector<std::string>& GetAvailableProviders() {
 void RegisterExecutionProviders(InferenceSession* sess, const std::vector<std::string>& provider_types) {
   for (const std::string& type : provider_types) {
     if (type == kCpuExecutionProvider) {
-      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CPU(sess->GetSessionOptions().enable_cpu_mem_arena));
+      const auto& session_options = sess->GetSessionOptions();
+      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CPU(
+                                          session_options.enable_cpu_mem_arena,
+                                          session_options.enable_cpu_weight_prepacking));
     } else if (type == kTensorrtExecutionProvider) {
 #ifdef USE_TENSORRT
       RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_Tensorrt(0));
@@ -556,12 +561,21 @@ void addObjectMethods(py::module& m) {
       .def_readwrite("enable_cpu_mem_arena", &SessionOptions::enable_cpu_mem_arena,
                      R"pbdoc(Enables the memory arena on CPU. Arena may pre-allocate memory for future usage.
 Set this option to false if you don't want it. Default is True.)pbdoc")
+      .def_readwrite("enable_cpu_weight_prepacking", &SessionOptions::enable_cpu_weight_prepacking,
+                     R"pbdoc(Packs the constant weights of the CPU Gemm and MatMul kernels once when the session is initialized.
+The packed copy is kept next to the initializer. Set this option to false to save memory. Default is True.)pbdoc")
+      .def_readwrite("max_constant_folding_output_bytes", &SessionOptions::max_constant_folding_output_bytes,
+                     R"pbdoc(Constant folding doesn't fold a node whose outputs take more than this many bytes, or whose output shapes
+aren't known statically. Default is 0, which means there is no limit.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
       .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
                      R"pbdoc(File path to serialize optimized model. By default, optimized model is not serialized if optimized_model_filepath is not provided.)pbdoc")
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
                      R"pbdoc(Enable the memory pattern optimization. Default is true.)pbdoc")
+      .def_readwrite("enable_memory_aware_node_order", &SessionOptions::enable_memory_aware_node_order,
+                     R"pbdoc(Execute the nodes in an order that reduces the peak size of the intermediate values, instead of the
+default topological order. Only used with sequential execution. Default is false.)pbdoc")
       .def_readwrite("logid", &SessionOptions::session_logid,
                      R"pbdoc(Logger id to use for session output.)pbdoc")
       .def_readwrite("log_severity_level", &SessionOptions::session_log_severity_level,
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FusedGemmOpTest, FusedGemmRelu) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "Relu");
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {3}, std::vector<float>{1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 12.0f, 13.0f,
+                         0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+TEST(FusedGemmOpTest, FusedGemmLeakyReluFullBias) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "LeakyRelu");
+  test.AddAttribute("leaky_relu_alpha", 0.5f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {2, 3},
+                       {1.0f, 2.0f, 3.0f,
+                        4.0f, 5.0f, 6.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 12.0f, 13.0f,
+                         -3.0f, -2.5f, -2.0f});
+  test.Run();
+}
+
+TEST(FusedGemmOpTest, FusedGemmReluConstantB) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(1));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "Relu");
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4}, std::vector<float>(12, 1.0f), true);
+  test.AddInput<float>("C", {3}, std::vector<float>{1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 12.0f, 13.0f,
+                         0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
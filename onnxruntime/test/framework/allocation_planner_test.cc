@@ -124,15 +124,25 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool parallel_execution = false,
+                               bool memory_aware_node_order = false)
+      : shape_map_(shape_map),
+        parallel_execution_(parallel_execution),
+        memory_aware_node_order_(memory_aware_node_order) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool IsParallelExecutionEnabled() const override { return parallel_execution_; }
+
+  bool IsMemoryAwareNodeOrderEnabled() const override { return memory_aware_node_order_; }
+
  private:
   ShapeMap* shape_map_;
+  bool parallel_execution_;
+  bool memory_aware_node_order_;
 };
 
 class PlannerTest : public ::testing::Test {
@@ -149,6 +159,7 @@ class PlannerTest : public ::testing::Test {
 
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;       // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;  // a unary kernel with in-place
+  std::unique_ptr<::onnxruntime::KernelDef> sum_kernel_;       // a binary kernel with no-aliasing and no-in-place
 
   std::unordered_map<std::string, onnxruntime::NodeArg*> name_to_arg_;
   std::vector<std::unique_ptr<UnaryNode>> nodes_;
@@ -166,6 +177,7 @@ class PlannerTest : public ::testing::Test {
     std_kernel_ = KernelDefBuilder().SetName("Transpose").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
     in_place_kernel_ =
         KernelDefBuilder().SetName("Relu").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayInplace(0, 0).Build();
+    sum_kernel_ = KernelDefBuilder().SetName("Sum").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
     CPUExecutionProviderInfo epi;
     auto execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(epi);
     execution_providers_.Add("CPUExecutionProvider", std::move(execution_provider));
@@ -196,6 +208,27 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*in_place_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddSumNode(std::string& input1, std::string& input2, std::string& output) {
+    auto* p_node = &graph_.AddNode("node" + std::to_string(NodeCounter::Next()), "Sum", "test op",
+                                   {Arg(input1), Arg(input2)}, {Arg(output)});
+    p_node->SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+    kernel_bindings_.emplace_back(p_node, *sum_kernel_);
+    return p_node;
+  }
+
+  // add a node that uses the kernel registered by the CPU execution provider
+  onnxruntime::Node* AddCpuNode(const std::string& op_type, const std::vector<std::string>& inputs,
+                                std::string& output) {
+    std::vector<onnxruntime::NodeArg*> input_args;
+    for (const auto& input : inputs) {
+      input_args.push_back(Arg(input));
+    }
+    auto* p_node = &graph_.AddNode("node" + std::to_string(NodeCounter::Next()), op_type, "test op", input_args,
+                                   {Arg(output)});
+    p_node->SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+    return p_node;
+  }
+
   void BindKernel(onnxruntime::Node* p_node, ::onnxruntime::KernelDef& kernel_def, KernelRegistry* reg) {
     auto info = onnxruntime::make_unique<OpKernelInfo>(*p_node, kernel_def, *execution_providers_.Get(*p_node),
                                                state_.GetInitializedTensors(), state_.GetOrtValueNameIdxMap(),
@@ -217,7 +250,8 @@ class PlannerTest : public ::testing::Test {
     }
   }
 
-  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}) {
+  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}, bool parallel_execution = false,
+                  bool memory_aware_node_order = false) {
     EXPECT_EQ(graph_.Resolve(), Status::OK());
 
     state_.SetGraph(graph_);
@@ -237,7 +271,7 @@ class PlannerTest : public ::testing::Test {
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
     status = state_.CreateKernels(kernel_registry_manager);
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, parallel_execution, memory_aware_node_order);
     status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph_), outer_scope_node_args, execution_providers,
                                            kernel_registry_manager, state_.GetOrtValueNameIdxMap(), test_context, plan_);
 
@@ -251,6 +285,13 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  void CheckReusedBuffer(const std::string& name, const std::string& original) {
+    int id, original_id;
+    index(name, id);
+    index(original, original_id);
+    EXPECT_EQ(plan_->allocation_plan[id].reused_buffer, original_id) << "Error in reused buffer for " << name;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // create set and check equality
     std::unordered_set<int> expected;
@@ -267,6 +308,44 @@ class PlannerTest : public ::testing::Test {
   }
 
  protected:
+  // X -> C1 -> ... -> Cn and X -> Big are summed. the default topological order runs Big first, so it is live
+  // while the chain runs. the memory aware order runs the chain first.
+  void TestMemoryAwareNodeOrder(int chain_length) {
+    std::string X("X"), Big("Big"), Y("Y");
+    std::vector<std::string> chain;
+    for (int i = 1; i <= chain_length; ++i) {
+      chain.push_back("C" + std::to_string(i));
+    }
+
+    Shape big_shape{100, 100};
+    Shape chain_shape{60, 100};
+    Shape small_shape{1};
+    AddNormalNode(X, chain[0]);
+    for (size_t i = 1; i < chain.size(); ++i) {
+      AddNormalNode(chain[i - 1], chain[i]);
+    }
+    auto* big = AddNormalNode(X, Big);
+    AddSumNode(chain.back(), Big, Y);
+
+    for (size_t i = 0; i + 1 < chain.size(); ++i) {
+      SetShape(chain[i], &chain_shape.value);
+    }
+    SetShape({{chain.back(), &small_shape.value}, {Big, &big_shape.value}, {Y, &big_shape.value}});
+
+    // the default topological order runs Big early, so its output is live while the chain runs
+    CreatePlan();
+    const auto& default_plan = GetPlan().execution_plan;
+    ASSERT_EQ(default_plan.size(), chain.size() + 2);
+    EXPECT_NE(default_plan[default_plan.size() - 2].node_index, big->Index());
+
+    CreatePlan({}, false, true);
+
+    // Big runs right before the Sum
+    const auto& execution_plan = GetPlan().execution_plan;
+    ASSERT_EQ(execution_plan.size(), chain.size() + 2);
+    EXPECT_EQ(execution_plan[execution_plan.size() - 2].node_index, big->Index());
+  }
+
   Graph& GetGraph() { return graph_; }
   const SequentialExecutionPlan& GetPlan() const { return *plan_; }
   const SessionState& GetState() const { return state_; }
@@ -311,6 +390,24 @@ TEST_F(PlannerTest, ChainTest) {
   CheckFreed(3, {"X"});
 }
 
+TEST_F(PlannerTest, CriticalPathCostTest) {
+  std::string X("X"), A1("A1"), A2("A2"), A3("A3"), B1("B1");
+
+  // two branches from the same input. the longer branch should have the higher cost.
+  auto* a1 = AddNormalNode(X, A1);
+  auto* a2 = AddNormalNode(A1, A2);
+  auto* a3 = AddNormalNode(A2, A3);
+  auto* b1 = AddNormalNode(X, B1);
+
+  CreatePlan({}, true);
+
+  const auto& plan = GetPlan();
+  EXPECT_GT(plan.NodeCriticalPathCost(a1->Index()), plan.NodeCriticalPathCost(a2->Index()));
+  EXPECT_GT(plan.NodeCriticalPathCost(a2->Index()), plan.NodeCriticalPathCost(a3->Index()));
+  EXPECT_GT(plan.NodeCriticalPathCost(a1->Index()), plan.NodeCriticalPathCost(b1->Index()));
+  EXPECT_EQ(plan.NodeCriticalPathCost(a3->Index()), plan.NodeCriticalPathCost(b1->Index()));
+}
+
 /* InputOutputTest: Test that:
 (a) All inputs are classified as kPreExisting,
 (b) All outer scope node args are classified as kPreExisting,
@@ -378,6 +475,40 @@ TEST_F(PlannerTest, InPlaceTest) {
   CheckFreed(2, {X2});
 }
 
+// InPlaceElementwiseTest: Check that a chain of CPU elementwise operators uses a single buffer.
+TEST_F(PlannerTest, InPlaceElementwiseTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), B("B"), S("S");
+
+  // graph structure:
+  AddNormalNode(X1, X2);             // no in-place operator; X2: temporary
+  AddCpuNode("Add", {X2, B}, X3);    // in-place on the first input
+  AddCpuNode("Relu", {X3}, X4);      // in-place on the input
+  AddCpuNode("Mul", {S, X4}, X5);    // in-place on the second input, as the first is broadcast
+  AddNormalNode(X5, X6);             // no in-place operator; X6: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  Shape shape2{"N"};
+  Shape shape3{1};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape},
+            {B, &shape2.value}, {S, &shape3.value}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kReuse);
+
+  // all of them use the buffer of X2
+  CheckReusedBuffer(X3, X2);
+  CheckReusedBuffer(X4, X2);
+  CheckReusedBuffer(X5, X2);
+}
+
 // InPlaceSizeMismatchTest: Check that Inplace reuse is not allowed when sizes don't match.
 // Also tests reuse of disjoint lifetime tensors.
 TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
@@ -441,5 +572,14 @@ TEST_F(PlannerTest, PlanOutputTest) {
   }
 }
 
+TEST_F(PlannerTest, MemoryAwareNodeOrderExactTest) {
+  TestMemoryAwareNodeOrder(3);
+}
+
+TEST_F(PlannerTest, MemoryAwareNodeOrderGreedyTest) {
+  // too many nodes for the exact order
+  TestMemoryAwareNodeOrder(20);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
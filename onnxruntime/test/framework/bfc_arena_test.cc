@@ -4,6 +4,7 @@
 #include "core/framework/bfc_arena.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <thread>
 
 namespace onnxruntime {
 namespace test {
@@ -234,5 +235,128 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+static ArenaThreadCacheConfig ThreadCacheConfig(size_t max_bytes_per_thread = 1 << 20) {
+  ArenaThreadCacheConfig config;
+  config.enable = true;
+  config.max_cached_size = 4096;
+  config.max_bytes_per_thread = max_bytes_per_thread;
+  config.batch_size = 4;
+  return config;
+}
+
+TEST(BFCArenaTest, ThreadCacheReuse) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ThreadCacheConfig());
+
+  // the first allocation refills the cache with a batch of chunks
+  void* first = a.Alloc(1000);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(a.AllocatedSize(first), 1024u);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 1);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+  EXPECT_EQ(stats.thread_cache_bytes, 3 * 1024);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // a freed chunk is re-used for the next allocation in the same size class
+  a.Free(first);
+  void* second = a.Alloc(900);
+  EXPECT_EQ(second, first);
+
+  // large allocations bypass the cache
+  void* large = a.Alloc(8192);
+  ASSERT_NE(large, nullptr);
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 3);
+  EXPECT_EQ(stats.num_thread_cache_hits, 1);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+  EXPECT_EQ(stats.bytes_in_use, 1024 + 8192);
+
+  a.Free(second);
+  a.Free(large);
+
+  std::vector<ThreadCacheStats> thread_stats;
+  a.GetThreadCacheStats(&thread_stats);
+  ASSERT_EQ(thread_stats.size(), 1u);
+  EXPECT_EQ(thread_stats[0].thread_id, std::this_thread::get_id());
+  EXPECT_EQ(thread_stats[0].num_allocs, 2);
+  EXPECT_EQ(thread_stats[0].cached_bytes, 4 * 1024);
+}
+
+TEST(BFCArenaTest, ThreadCacheFlush) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ThreadCacheConfig(8 * 1024));
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; ++i) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  // freeing past the limit returns batches of chunks to the arena
+  std::vector<ThreadCacheStats> thread_stats;
+  a.GetThreadCacheStats(&thread_stats);
+  ASSERT_EQ(thread_stats.size(), 1u);
+  EXPECT_GT(thread_stats[0].num_flushes, 0);
+  EXPECT_LE(thread_stats[0].cached_bytes, 8 * 1024);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.thread_cache_bytes, thread_stats[0].cached_bytes);
+}
+
+TEST(BFCArenaTest, ThreadCacheMultipleThreads) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, ThreadCacheConfig(16 * 1024));
+
+  // allocate on one thread and free on another
+  std::vector<void*> ptrs(64);
+  std::thread producer([&a, &ptrs]() {
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+      ptrs[i] = a.Alloc(256 + (i % 8) * 256);
+    }
+  });
+  producer.join();
+
+  std::sort(ptrs.begin(), ptrs.end());
+  EXPECT_EQ(std::unique(ptrs.begin(), ptrs.end()), ptrs.end());
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&a]() {
+      for (int iter = 0; iter < 100; ++iter) {
+        std::vector<void*> local;
+        for (int i = 0; i < 16; ++i) {
+          void* p = a.Alloc(100 * (i + 1));
+          ASSERT_NE(p, nullptr);
+          memset(p, iter, 100 * (i + 1));
+          local.push_back(p);
+        }
+
+        for (void* p : local) {
+          a.Free(p);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_allocs, 64 + 4 * 100 * 16);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -159,6 +159,69 @@ TEST_F(ExecutionFrameTest, FeedInDataTest) {
   EXPECT_EQ(p_tensor_arg_0->MutableData<float>(), value.GetMutable<Tensor>()->MutableData<float>());
 }
 
+TEST_F(ExecutionFrameTest, FramePoolTest) {
+  onnxruntime::Model model("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                           std::unordered_map<std::string, int>{{"", 10}});
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), output_def("Y", &tensor_float);
+
+  graph.AddNode("node1", "Clip", "Clip operator", ArgMap{&input_def}, ArgMap{&output_def})
+      .SetExecutionProviderType(kCpuExecutionProvider);
+  graph.Resolve();
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_typ = cpu_xp->Type();
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_typ, std::move(cpu_xp));
+  EXPECT_TRUE(kernel_registry_manager.RegisterKernels(execution_providers).IsOK());
+  SessionState state{execution_providers, false, &tp_, nullptr, MemoryPatternCacheOptions{}, 1};
+  auto status = state.SetGraphAndCreateKernels(graph, kernel_registry_manager);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map = state.GetOrtValueNameIdxMap();
+  int x_idx, y_idx;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X", x_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("Y", y_idx).IsOK());
+
+  auto cpu_allocator = execution_providers.Get(xp_typ)->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue value1, value2;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{3, 2}, std::vector<float>(6, 1.0f), &value1);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 2.0f), &value2);
+
+  auto& pool = state.GetExecutionFramePool();
+  ASSERT_TRUE(pool.IsEnabled());
+
+  vector<OrtValue> outputs;
+  const ExecutionFrame* first_frame = nullptr;
+  {
+    auto frame = pool.Acquire({x_idx}, {value1}, {y_idx}, outputs, {}, state);
+    first_frame = frame.get();
+    EXPECT_EQ(frame->GetNodeInputOrOutputMLValue(0)->Get<Tensor>().Shape(), TensorShape({3, 2}));
+  }
+
+  // the frame is returned to the pool with its values released
+  EXPECT_EQ(pool.NumIdleFrames(), 1u);
+
+  {
+    auto frame = pool.Acquire({x_idx}, {value2}, {y_idx}, outputs, {}, state);
+    EXPECT_EQ(frame.get(), first_frame);
+    EXPECT_EQ(pool.NumIdleFrames(), 0u);
+    EXPECT_EQ(frame->GetNodeInputOrOutputMLValue(0)->Get<Tensor>().Shape(), TensorShape({2, 2}));
+    EXPECT_FALSE(frame->GetNodeInputOrOutputMLValue(1)->IsAllocated());
+
+    // concurrent runs need their own frame
+    auto frame2 = pool.Acquire({x_idx}, {value1}, {y_idx}, outputs, {}, state);
+    EXPECT_NE(frame2.get(), frame.get());
+  }
+
+  // only one idle frame is kept
+  EXPECT_EQ(pool.NumIdleFrames(), 1u);
+}
+
 TEST_F(ExecutionFrameTest, MemPatternTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
   auto xp_type = cpu_xp->Type();
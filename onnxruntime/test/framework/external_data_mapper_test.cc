@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/external_data_mapper.h"
+#include "core/framework/tensor.h"
+#include "core/framework/path_lib.h"
+#include "gtest/gtest.h"
+#include "file_util.h"
+
+namespace onnxruntime {
+namespace test {
+
+static ONNX_NAMESPACE::TensorProto CreateExternalTensorProto(const std::basic_string<ORTCHAR_T>& filename,
+                                                             int64_t offset, int64_t num_elements) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  auto* location = tensor_proto.mutable_external_data()->Add();
+  location->set_key("location");
+  location->set_value(ToMBString(filename));
+  auto* offset_entry = tensor_proto.mutable_external_data()->Add();
+  offset_entry->set_key("offset");
+  offset_entry->set_value(std::to_string(offset));
+  auto* length_entry = tensor_proto.mutable_external_data()->Add();
+  length_entry->set_key("length");
+  length_entry->set_value(std::to_string(num_elements * sizeof(float)));
+  tensor_proto.mutable_dims()->Add(num_elements);
+  tensor_proto.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  return tensor_proto;
+}
+
+TEST(ExternalDataMapperTest, CreateTensor) {
+  FILE* fp;
+  std::basic_string<ORTCHAR_T> filename(ORT_TSTR("tensor_XXXXXX"));
+  CreateTestFile(fp, filename);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(filename.c_str()),
+                                                                         DeleteFileFromDisk);
+  float test_data[] = {1.0f, 2.2f, 3.5f, 4.0f, 5.5f, 6.0f};
+  ASSERT_EQ(sizeof(test_data), fwrite(test_data, 1, sizeof(test_data), fp));
+  ASSERT_EQ(0, fclose(fp));
+
+  OrtMemoryInfo cpu_memory_info(onnxruntime::CPU, OrtDeviceAllocator, OrtDevice(), 0, OrtMemTypeDefault);
+  ExternalDataMapper mapper(Env::Default());
+
+  auto tensor_proto_1 = CreateExternalTensorProto(filename, 0, 2);
+  auto tensor_proto_2 = CreateExternalTensorProto(filename, 2 * sizeof(float), 4);
+  ASSERT_TRUE(ExternalDataMapper::CanMap(tensor_proto_1));
+
+  OrtValue value_1, value_2;
+  OrtCallback deleter_1, deleter_2;
+  bool mapped_1 = false, mapped_2 = false;
+  ASSERT_TRUE(mapper.CreateTensor(nullptr, tensor_proto_1, cpu_memory_info, value_1, deleter_1, mapped_1).IsOK());
+  ASSERT_TRUE(mapper.CreateTensor(nullptr, tensor_proto_2, cpu_memory_info, value_2, deleter_2, mapped_2).IsOK());
+
+#ifdef _WIN32
+  // mapping files isn't implemented on Windows
+  EXPECT_FALSE(mapped_1);
+  EXPECT_FALSE(mapped_2);
+#else
+  ASSERT_TRUE(mapped_1);
+  ASSERT_TRUE(mapped_2);
+
+  const auto& tensor_1 = value_1.Get<Tensor>();
+  const auto& tensor_2 = value_2.Get<Tensor>();
+  EXPECT_EQ(tensor_1.Shape(), TensorShape({2}));
+  EXPECT_EQ(tensor_2.Shape(), TensorShape({4}));
+
+  // both tensors point into the same mapping of the file
+  EXPECT_EQ(tensor_1.Data<float>() + 2, tensor_2.Data<float>());
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(tensor_1.Data<float>()[i], test_data[i]);
+  }
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(tensor_2.Data<float>()[i], test_data[2 + i]);
+  }
+
+  // the mapping stays valid until the deleters of all the tensors have been called
+  deleter_1.f(deleter_1.param);
+  EXPECT_EQ(tensor_2.Data<float>()[3], 6.0f);
+  deleter_2.f(deleter_2.param);
+
+  // data that isn't aligned to the element size isn't used in place
+  OrtValue misaligned_value;
+  OrtCallback misaligned_deleter;
+  bool misaligned_mapped = true;
+  auto misaligned_proto = CreateExternalTensorProto(filename, 2, 2);
+  ASSERT_TRUE(mapper.CreateTensor(nullptr, misaligned_proto, cpu_memory_info, misaligned_value, misaligned_deleter,
+                                  misaligned_mapped)
+                  .IsOK());
+  EXPECT_FALSE(misaligned_mapped);
+  EXPECT_EQ(misaligned_deleter.f, nullptr);
+
+  // neither is data that extends past the end of the file
+  OrtValue truncated_value;
+  OrtCallback truncated_deleter;
+  bool truncated_mapped = true;
+  auto truncated_proto = CreateExternalTensorProto(filename, 4 * sizeof(float), 4);
+  ASSERT_TRUE(mapper.CreateTensor(nullptr, truncated_proto, cpu_memory_info, truncated_value, truncated_deleter,
+                                  truncated_mapped)
+                  .IsOK());
+  EXPECT_FALSE(truncated_mapped);
+#endif
+}
+
+}  // namespace test
+}  // namespace onnxruntime
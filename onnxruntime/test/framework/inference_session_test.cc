@@ -128,6 +128,10 @@ class InferenceSessionGetGraphWrapper : public InferenceSession {
   const Graph& GetGraph() {
     return model_->MainGraph();
   }
+
+  bool LoadedFromSessionStateCache() const {
+    return loaded_from_session_state_cache_;
+  }
 };
 
 namespace test {
@@ -426,6 +430,96 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(model_fs_Level3.fail());
 }
 
+TEST(InferenceSessionTests, TestSessionStateCache) {
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestSessionStateCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  so.session_state_cache_filepath = ORT_TSTR("session_state_cache_test.ortcache");
+  std::remove(ToMBString(so.session_state_cache_filepath).c_str());
+
+  // the first session optimizes the model and writes the cache
+  InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  ASSERT_FALSE(session_object.LoadedFromSessionStateCache());
+  std::ifstream cache_file(so.session_state_cache_filepath, ios::in | ios::binary);
+  ASSERT_TRUE(cache_file.good());
+  cache_file.close();
+
+  // the second session uses the optimized and partitioned graph from the cache
+  InferenceSessionGetGraphWrapper cached_session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(cached_session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(cached_session_object.Initialize().IsOK());
+  ASSERT_TRUE(cached_session_object.LoadedFromSessionStateCache());
+
+  const auto& graph = cached_session_object.GetGraph();
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Identity"], 0);
+  ASSERT_EQ(graph.NumberOfNodes(), session_object.GetGraph().NumberOfNodes());
+  for (const auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+  }
+
+  // a registered transformer could change the graph in a way the cache doesn't know about, so it isn't used
+  InferenceSessionGetGraphWrapper custom_session_object{so, &DefaultLoggingManager()};
+  auto dummy_transformer_unique_ptr = onnxruntime::make_unique<DummyGraphTransformer>("DummyTransformer");
+  const auto* dummy_transformer = dummy_transformer_unique_ptr.get();
+  ASSERT_TRUE(custom_session_object.RegisterGraphTransformer(std::move(dummy_transformer_unique_ptr)).IsOK());
+  ASSERT_TRUE(custom_session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(custom_session_object.Initialize().IsOK());
+  ASSERT_FALSE(custom_session_object.LoadedFromSessionStateCache());
+  ASSERT_TRUE(dummy_transformer->IsTransformerInvoked());
+
+  // a different constant folding limit doesn't match the cache
+  so.max_constant_folding_output_bytes = 1024;
+  InferenceSessionGetGraphWrapper limited_session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(limited_session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(limited_session_object.Initialize().IsOK());
+  ASSERT_FALSE(limited_session_object.LoadedFromSessionStateCache());
+  so.max_constant_folding_output_bytes = 0;
+
+  // a different optimization level doesn't match the cache
+  so.graph_optimization_level = TransformerLevel::Default;
+  InferenceSessionGetGraphWrapper noopt_session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(noopt_session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(noopt_session_object.Initialize().IsOK());
+  ASSERT_FALSE(noopt_session_object.LoadedFromSessionStateCache());
+  ASSERT_GT(CountOpsInGraph(noopt_session_object.GetGraph())["Identity"], 0);
+
+  // a different model doesn't match the cache either
+  InferenceSessionGetGraphWrapper other_session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(other_session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(other_session_object.Initialize().IsOK());
+  ASSERT_FALSE(other_session_object.LoadedFromSessionStateCache());
+  RunOptions run_options;
+  RunModel(other_session_object, run_options);
+
+  // a truncated cache is rejected
+  {
+    std::ifstream in(so.session_state_cache_filepath, ios::in | ios::binary);
+    std::string contents{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    in.close();
+    std::ofstream out(so.session_state_cache_filepath, ios::out | ios::binary | ios::trunc);
+    out.write(contents.data(), contents.size() / 2);
+  }
+
+  InferenceSessionGetGraphWrapper corrupt_session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(corrupt_session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(corrupt_session_object.Initialize().IsOK());
+  ASSERT_FALSE(corrupt_session_object.LoadedFromSessionStateCache());
+  RunModel(corrupt_session_object, run_options);
+
+  // and rewritten so the next session can use it
+  InferenceSessionGetGraphWrapper recached_session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(recached_session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(recached_session_object.Initialize().IsOK());
+  ASSERT_TRUE(recached_session_object.LoadedFromSessionStateCache());
+  RunModel(recached_session_object, run_options);
+
+  std::remove(ToMBString(so.session_state_cache_filepath).c_str());
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -630,6 +724,64 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   }
 }
 
+TEST(InferenceSessionTests, CheckRunSamplingProfiler) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunSamplingProfiler";
+  so.sampling_profiler_interval = 2;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  // runs 0, 2 and 4 are sampled
+  for (int i = 0; i < 5; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  std::vector<profiling::OpLatencyStats> stats;
+  ASSERT_TRUE(session_object.GetOpLatencyStats(stats).IsOK());
+  ASSERT_EQ(stats.size(), 1u);
+  EXPECT_EQ(stats[0].op_type, "Mul");
+  EXPECT_EQ(stats[0].num_samples, 3u);
+  EXPECT_LE(stats[0].p50_us, stats[0].p99_us);
+  EXPECT_LE(stats[0].p99_us, stats[0].max_us);
+
+  // not enabled
+  InferenceSession session_without_sampling(SessionOptions{});
+  EXPECT_FALSE(session_without_sampling.GetOpLatencyStats(stats).IsOK());
+}
+
+TEST(InferenceSessionTests, SamplingProfilerRingBuffer) {
+  // rounded up to 4 slots
+  profiling::SamplingProfiler profiler(1, 3);
+  const std::string add = "Add";
+  const std::string mul = "Mul";
+
+  for (int64_t i = 1; i <= 100; ++i) {
+    profiler.RecordOp(add, i);
+  }
+
+  profiler.RecordOp(mul, 10);
+  profiler.RecordOp(mul, 30);
+
+  // only the last 4 samples are kept
+  auto stats = profiler.GetOpLatencyStats();
+  ASSERT_EQ(stats.size(), 2u);
+  EXPECT_EQ(stats[0].op_type, "Add");
+  EXPECT_EQ(stats[0].num_samples, 2u);
+  EXPECT_EQ(stats[0].p50_us, 99);
+  EXPECT_EQ(stats[0].p99_us, 100);
+  EXPECT_EQ(stats[1].op_type, "Mul");
+  EXPECT_EQ(stats[1].num_samples, 2u);
+  EXPECT_EQ(stats[1].p50_us, 10);
+  EXPECT_EQ(stats[1].max_us, 30);
+  EXPECT_EQ(profiler.NumSamplesRecorded(), 102u);
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::unique_ptr<MemoryPatternGroup> CreatePatternGroup(size_t size) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, size);
+
+  auto group = onnxruntime::make_unique<MemoryPatternGroup>();
+  group->locations.push_back(OrtMemoryInfo(CPU, OrtDeviceAllocator));
+  group->patterns.push_back(planner.GenerateMemPattern());
+  return group;
+}
+
+TEST(MemoryPatternCacheTest, ExactShapes) {
+  MemoryPatternCache cache;
+
+  TensorShape shape_a({1, 7});
+  TensorShape shape_b({7, 1});
+  TensorShape shape_c({1, 1, 7});
+
+  EXPECT_EQ(cache.Get({shape_a}), nullptr);
+  cache.Update({shape_a}, CreatePatternGroup(28));
+
+  auto pattern = cache.Get({shape_a});
+  ASSERT_NE(pattern, nullptr);
+  EXPECT_EQ(pattern->patterns[0].PeakSize(), 28u);
+
+  // same dims in a different order or rank must not share the entry
+  EXPECT_EQ(cache.Get({shape_b}), nullptr);
+  EXPECT_EQ(cache.Get({shape_c}), nullptr);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.num_entries, 1u);
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.evictions, 0u);
+  EXPECT_EQ(stats.planned_bytes, 28u);
+  EXPECT_EQ(stats.lower_bound_bytes, 28u);
+}
+
+TEST(MemoryPatternCacheTest, LruEviction) {
+  MemoryPatternCacheOptions options;
+  options.max_entries = 2;
+  MemoryPatternCache cache(options);
+
+  TensorShape shape_1({1});
+  TensorShape shape_2({2});
+  TensorShape shape_3({3});
+
+  cache.Update({shape_1}, CreatePatternGroup(4));
+  cache.Update({shape_2}, CreatePatternGroup(8));
+
+  // make shape_1 the most recently used so shape_2 is evicted next
+  auto pattern_1 = cache.Get({shape_1});
+  ASSERT_NE(pattern_1, nullptr);
+
+  cache.Update({shape_3}, CreatePatternGroup(12));
+
+  EXPECT_NE(cache.Get({shape_1}), nullptr);
+  EXPECT_EQ(cache.Get({shape_2}), nullptr);
+  EXPECT_NE(cache.Get({shape_3}), nullptr);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.num_entries, 2u);
+  EXPECT_EQ(stats.evictions, 1u);
+
+  // an evicted pattern must stay valid while it's held
+  cache.Update({shape_2}, CreatePatternGroup(8));
+  cache.Update({shape_3}, CreatePatternGroup(12));
+  EXPECT_EQ(pattern_1->patterns[0].PeakSize(), 4u);
+}
+
+TEST(MemoryPatternCacheTest, ShapeBucketing) {
+  MemoryPatternCacheOptions options;
+  options.enable_shape_bucketing = true;
+  options.bucket_axes = {-1};
+  MemoryPatternCache cache(options);
+
+  EXPECT_EQ(MemoryPatternCache::BucketDim(0), 0);
+  EXPECT_EQ(MemoryPatternCache::BucketDim(1), 1);
+  EXPECT_EQ(MemoryPatternCache::BucketDim(5), 8);
+  EXPECT_EQ(MemoryPatternCache::BucketDim(64), 64);
+
+  TensorShape shape_33({2, 33});
+  TensorShape shape_60({2, 60});
+  TensorShape shape_64({2, 64});
+  TensorShape shape_65({2, 65});
+  TensorShape batch_3({3, 60});
+
+  cache.Update({shape_33}, CreatePatternGroup(2 * 33 * 4));
+
+  auto pattern = cache.Get({shape_60});
+  ASSERT_NE(pattern, nullptr);
+  EXPECT_EQ(cache.Get({shape_64}), pattern);
+  EXPECT_EQ(cache.Get({shape_65}), nullptr);
+
+  // axis 0 isn't bucketed
+  EXPECT_EQ(cache.Get({batch_3}), nullptr);
+
+  // a stale pattern is regenerated by the next run in the bucket and replaced by a larger one
+  cache.MarkStale(pattern.get());
+  EXPECT_EQ(cache.Get({shape_60}), nullptr);
+  cache.Update({shape_60}, CreatePatternGroup(2 * 60 * 4));
+
+  auto new_pattern = cache.Get({shape_33});
+  ASSERT_NE(new_pattern, nullptr);
+  EXPECT_EQ(new_pattern->patterns[0].PeakSize(), 2u * 60 * 4);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -34,5 +34,59 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024 + 256 + 512);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024);
 }
+
+TEST(MemPatternPlannerTest, OffsetPackingTest) {
+  auto trace = [](MemPatternPlanner& planner) {
+    planner.TraceAllocation(0, 100);
+    planner.TraceAllocation(1, 100);
+    planner.TraceFree(0);
+    planner.TraceAllocation(2, 200);
+    planner.TraceFree(1);
+    planner.TraceAllocation(3, 0);
+  };
+
+  // the block freed by 0 is too small for 2, so 2 goes after 1
+  MemPatternPlanner planner;
+  trace(planner);
+  auto pattern = planner.GenerateMemPattern();
+  EXPECT_EQ(pattern.PeakSize(), 400u);
+  EXPECT_EQ(pattern.LowerBoundSize(), 300u);
+
+  // 2 is placed first, 0 shares its space as their lifetimes don't overlap, and 1 goes after 2
+  MemPatternPlanner packing_planner(true);
+  trace(packing_planner);
+  pattern = packing_planner.GenerateMemPattern();
+  EXPECT_EQ(pattern.PeakSize(), 300u);
+  EXPECT_EQ(pattern.LowerBoundSize(), 300u);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 200u);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(3)->size_, 0u);
+}
+
+TEST(MemPatternPlannerTest, OffsetPackingBestFitTest) {
+  MemPatternPlanner planner(true);
+  planner.TraceAllocation(0, 1024);
+  planner.TraceAllocation(1, 256);
+  planner.TraceAllocation(2, 512);
+  planner.TraceFree(1);
+  planner.TraceAllocation(3, 128);
+  planner.TraceFree(0);
+  planner.TraceFree(2);
+  planner.TraceFree(3);
+  planner.TraceAllocation(4, 1536);
+
+  auto pattern = planner.GenerateMemPattern();
+  EXPECT_EQ(pattern.LowerBoundSize(), 1024u + 256 + 512);
+  EXPECT_EQ(pattern.PeakSize(), 1024u + 256 + 512);
+
+  // 4 doesn't overlap the others in time and fits in the space they used
+  EXPECT_EQ(pattern.GetBlock(4)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0u);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 1024u);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 1024u + 512);
+  // 3 fits in the space of 1, which is freed before it
+  EXPECT_EQ(pattern.GetBlock(3)->offset_, 1024u + 512);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/request_batcher.h"
+
+#include <sstream>
+#include <thread>
+
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Load a model with Y = X * X, where X and Y have a free batch dimension and shape {batch, 2}.
+static void LoadBatchableModel(InferenceSession& session) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 7;
+  Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto* shape = tensor_float.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(2);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("node1", "Mul", "Mul", {&input_arg, &input_arg}, {&output_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::stringstream model_stream(model.ToProto().SerializeAsString());
+  ASSERT_TRUE(session.Load(model_stream).IsOK());
+  ASSERT_TRUE(session.Initialize().IsOK());
+}
+
+static NameMLValMap CreateFeeds(int64_t rows, int64_t cols, float start) {
+  std::vector<float> values(static_cast<size_t>(rows * cols));
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = start + i;
+  }
+
+  OrtValue value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {rows, cols}, values, &value);
+  return {{"X", value}};
+}
+
+static void VerifyResult(std::future<BatchedRunResult>& future, int64_t rows, float start) {
+  auto result = future.get();
+  ASSERT_TRUE(result.status.IsOK()) << result.status.ErrorMessage();
+  ASSERT_EQ(result.fetches.size(), 1u);
+
+  const auto& tensor = result.fetches[0].Get<Tensor>();
+  ASSERT_EQ(tensor.Shape(), TensorShape({rows, 2}));
+  const float* data = tensor.Data<float>();
+  for (int64_t i = 0; i < rows * 2; ++i) {
+    const float x = start + i;
+    EXPECT_EQ(data[i], x * x);
+  }
+}
+
+TEST(RequestBatcherTest, BatchesConcurrentRequests) {
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.BatchesConcurrentRequests";
+  InferenceSession session{so};
+  LoadBatchableModel(session);
+
+  RequestBatcherOptions options;
+  options.max_batch_size = 4;
+  // long enough for the requests to be batched by size
+  options.max_delay = std::chrono::seconds(10);
+  RequestBatcher batcher(session, options);
+
+  std::vector<std::future<BatchedRunResult>> futures;
+  futures.push_back(batcher.Submit(CreateFeeds(1, 2, 0.f), {"Y"}));
+  futures.push_back(batcher.Submit(CreateFeeds(2, 2, 10.f), {"Y"}));
+  futures.push_back(batcher.Submit(CreateFeeds(1, 2, 20.f), {"Y"}));
+
+  VerifyResult(futures[0], 1, 0.f);
+  VerifyResult(futures[1], 2, 10.f);
+  VerifyResult(futures[2], 1, 20.f);
+
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.num_requests, 3u);
+  EXPECT_EQ(stats.num_runs, 1u);
+  EXPECT_EQ(stats.num_batched_requests, 3u);
+}
+
+TEST(RequestBatcherTest, IncompatibleRequests) {
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.IncompatibleRequests";
+  InferenceSession session{so};
+  LoadBatchableModel(session);
+
+  RequestBatcherOptions options;
+  options.max_batch_size = 2;
+  options.max_delay = std::chrono::milliseconds(10);
+
+  std::future<BatchedRunResult> invalid_shape;
+  std::future<BatchedRunResult> too_large;
+  std::future<BatchedRunResult> valid;
+  {
+    RequestBatcher batcher(session, options);
+
+    // a different non-batch dim can't be batched with the other requests, and fails on its own
+    invalid_shape = batcher.Submit(CreateFeeds(1, 3, 0.f), {"Y"});
+    // more rows than the max batch size
+    too_large = batcher.Submit(CreateFeeds(3, 2, 0.f), {"Y"});
+    valid = batcher.Submit(CreateFeeds(1, 2, 5.f), {"Y"});
+
+    // the pending requests are run when the batcher is destroyed
+  }
+
+  EXPECT_FALSE(invalid_shape.get().status.IsOK());
+  VerifyResult(too_large, 3, 0.f);
+  VerifyResult(valid, 1, 5.f);
+}
+
+TEST(RequestBatcherTest, RunBatched) {
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.RunBatched";
+  so.request_batching_max_batch_size = 4;
+  so.request_batching_num_threads = 2;
+  InferenceSession session{so};
+  LoadBatchableModel(session);
+
+  constexpr int num_callers = 8;
+  std::vector<std::thread> callers;
+  std::vector<Status> statuses(num_callers);
+  std::vector<std::vector<OrtValue>> fetches(num_callers);
+  for (int i = 0; i < num_callers; ++i) {
+    callers.emplace_back([&, i]() {
+      statuses[i] = session.RunBatched(CreateFeeds(1, 2, 10.f * i), {"Y"}, &fetches[i]);
+    });
+  }
+
+  for (auto& caller : callers) {
+    caller.join();
+  }
+
+  for (int i = 0; i < num_callers; ++i) {
+    ASSERT_TRUE(statuses[i].IsOK()) << statuses[i].ErrorMessage();
+    ASSERT_EQ(fetches[i].size(), 1u);
+    const auto& tensor = fetches[i][0].Get<Tensor>();
+    ASSERT_EQ(tensor.Shape(), TensorShape({1, 2}));
+    EXPECT_EQ(tensor.Data<float>()[0], (10.f * i) * (10.f * i));
+    EXPECT_EQ(tensor.Data<float>()[1], (10.f * i + 1) * (10.f * i + 1));
+  }
+}
+
+TEST(RequestBatcherTest, RunBatchedRequiresBatching) {
+  SessionOptions so;
+  so.session_logid = "RequestBatcherTest.RunBatchedRequiresBatching";
+  InferenceSession session{so};
+  LoadBatchableModel(session);
+
+  std::vector<OrtValue> fetches;
+  EXPECT_FALSE(session.RunBatched(CreateFeeds(1, 2, 0.f), {"Y"}, &fetches).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -19,6 +19,7 @@ Abstract:
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <cmath>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -459,6 +460,388 @@ public:
     }
 };
 
+class MlasSgemmPackedTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        Test(CblasNoTrans, CblasNoTrans, M, N, K, alpha, A, K, B, N, beta, C, CReference, N);
+        Test(CblasNoTrans, CblasTrans, M, N, K, alpha, A, K, B, K, beta, C, CReference, N);
+        Test(CblasTrans, CblasNoTrans, M, N, K, alpha, A, M, B, N, beta, C, CReference, N);
+        Test(CblasTrans, CblasTrans, M, N, K, alpha, A, M, B, K, beta, C, CReference, N);
+    }
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        float* CReference,
+        size_t ldc
+        )
+    {
+        //
+        // The packed buffer is placed against the guard region to detect any
+        // access past the size returned by MlasGemmPackBSize.
+        //
+
+        void* PackedB = BufferPackedB.GetBuffer(MlasGemmPackBSize(N, K));
+
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, threadpool);
+        MlasGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, ldc, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch packed TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", TransA, TransB, M, N, K, alpha, beta, C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferPackedB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t M = 1; M <= 16; M++) {
+            Test(M, 1, 1, 1.0f, 0.0f);
+            Test(M, 17, 33, 1.0f, 0.0f);
+            Test(M, 64, 128, 1.0f, 1.0f);
+            Test(M, 200, 300, 0.5f, -0.25f);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        Test(32, 1000, 520, 1.0f, 0.0f);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const float multipliers[] = { 0.0f, -0.0f, 0.25f, -0.5f, 1.0f, -1.0f };
+
+        for (size_t a = 0; a < _countof(multipliers); a++) {
+            for (size_t b = 0; b < _countof(multipliers); b++) {
+                for (size_t M = 1; M < 40; M += 3) {
+                    for (size_t N = 1; N < 300; N += 13) {
+                        for (size_t K = 1; K < 300; K += 23) {
+                            Test(M, N, K, multipliers[a], multipliers[b]);
+                        }
+                    }
+                }
+                printf("a %zd/%zd b %zd/%zd\n", a, _countof(multipliers), b, _countof(multipliers));
+            }
+        }
+    }
+};
+
+class MlasSgemmBatchTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t BatchSize,
+        size_t M,
+        size_t N,
+        size_t K,
+        bool BroadcastB
+        )
+    {
+        const size_t StrideA = M * K;
+        const size_t StrideB = BroadcastB ? 0 : N * K;
+        const size_t StrideC = M * N;
+
+        const float* A = BufferA.GetBuffer(StrideA * BatchSize);
+        const float* B = BufferB.GetBuffer(BroadcastB ? N * K : StrideB * BatchSize);
+        float* C = BufferC.GetBuffer(StrideC * BatchSize);
+        float* CReference = BufferCReference.GetBuffer(StrideC * BatchSize);
+
+        Test(CblasNoTrans, CblasNoTrans, BatchSize, M, N, K, A, K, StrideA, B, N, StrideB, C, CReference, N, StrideC);
+        Test(CblasNoTrans, CblasTrans, BatchSize, M, N, K, A, K, StrideA, B, K, StrideB, C, CReference, N, StrideC);
+        Test(CblasTrans, CblasNoTrans, BatchSize, M, N, K, A, M, StrideA, B, N, StrideB, C, CReference, N, StrideC);
+
+        //
+        // A broadcast B can also be packed.
+        //
+
+        if (BroadcastB) {
+            void* PackedB = BufferPackedB.GetBuffer(MlasGemmPackBSize(N, K));
+
+            MlasGemmPackB(CblasNoTrans, N, K, B, N, PackedB);
+
+            TestPacked(CblasNoTrans, BatchSize, M, N, K, A, K, StrideA, PackedB, C, CReference, N, StrideC);
+            TestPacked(CblasTrans, BatchSize, M, N, K, A, M, StrideA, PackedB, C, CReference, N, StrideC);
+        }
+    }
+
+    void
+    TestPacked(
+        CBLAS_TRANSPOSE TransA,
+        size_t BatchSize,
+        size_t M,
+        size_t N,
+        size_t K,
+        const float* A,
+        size_t lda,
+        size_t StrideA,
+        const void* PackedB,
+        float* C,
+        float* CReference,
+        size_t ldc,
+        size_t StrideC
+        )
+    {
+        std::fill_n(C, StrideC * BatchSize, -0.5f);
+        std::fill_n(CReference, StrideC * BatchSize, -0.5f);
+
+        MlasGemmBatch(TransA, M, N, K, 1.0f, A, lda, StrideA, PackedB, 0.5f, C, ldc, StrideC, BatchSize, threadpool);
+
+        for (size_t batch = 0; batch < BatchSize; batch++) {
+            MlasGemm(TransA, M, N, K, 1.0f, A + batch * StrideA, lda, PackedB, 0.5f,
+                CReference + batch * StrideC, ldc, nullptr);
+        }
+
+        for (size_t f = 0; f < StrideC * BatchSize; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch packed batch TransA=%d, BatchSize=%zd, M=%zd, N=%zd, K=%zd  %f %f!\n", TransA, BatchSize, M, N, K, C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t BatchSize,
+        size_t M,
+        size_t N,
+        size_t K,
+        const float* A,
+        size_t lda,
+        size_t StrideA,
+        const float* B,
+        size_t ldb,
+        size_t StrideB,
+        float* C,
+        float* CReference,
+        size_t ldc,
+        size_t StrideC
+        )
+    {
+        std::fill_n(C, StrideC * BatchSize, -0.5f);
+        std::fill_n(CReference, StrideC * BatchSize, -0.5f);
+
+        MlasGemmBatch(TransA, TransB, M, N, K, 1.0f, A, lda, StrideA, B, ldb, StrideB, 0.5f, C, ldc, StrideC, BatchSize, threadpool);
+
+        for (size_t batch = 0; batch < BatchSize; batch++) {
+            MlasGemm(TransA, TransB, M, N, K, 1.0f, A + batch * StrideA, lda, B + batch * StrideB, ldb, 0.5f,
+                CReference + batch * StrideC, ldc, nullptr);
+        }
+
+        for (size_t f = 0; f < StrideC * BatchSize; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch batch TransA=%d, TransB=%d, BatchSize=%zd, M=%zd, N=%zd, K=%zd, StrideB=%zd  %f %f!\n", TransA, TransB, BatchSize, M, N, K, StrideB, C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferPackedB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        static const size_t batches[] = { 1, 2, 3, 12, 16, 48 };
+
+        for (size_t b = 0; b < _countof(batches); b++) {
+            Test(batches[b], 1, 1, 1, false);
+            Test(batches[b], 7, 9, 11, false);
+            Test(batches[b], 16, 64, 64, false);
+            Test(batches[b], 128, 128, 64, true);
+            Test(batches[b], 3, 300, 100, false);
+            Test(batches[b], 300, 3, 100, true);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t BatchSize = 1; BatchSize <= 24; BatchSize++) {
+            for (size_t M = 1; M < 160; M += 9) {
+                for (size_t N = 1; N < 160; N += 11) {
+                    for (size_t K = 1; K < 160; K += 31) {
+                        Test(BatchSize, M, N, K, false);
+                        Test(BatchSize, M, N, K, true);
+                    }
+                }
+            }
+            printf("BatchSize %zd\n", BatchSize);
+        }
+    }
+};
+
+class MlasSgemmEpilogueTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float beta,
+        bool UseBias,
+        bool UseAddend,
+        MLAS_ACTIVATION_KIND ActivationKind
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        const float* Bias = UseBias ? BufferBias.GetBuffer(N) : nullptr;
+        const float* Addend = UseAddend ? BufferAddend.GetBuffer(N * M) : nullptr;
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = ActivationKind;
+        Activation.Parameters.LeakyRelu.alpha = 0.25f;
+
+        MLAS_SGEMM_EPILOGUE Epilogue;
+        Epilogue.Bias = Bias;
+        Epilogue.Addend = Addend;
+        Epilogue.ldaddend = N;
+        Epilogue.Activation = &Activation;
+
+        void* PackedB = BufferPackedB.GetBuffer(MlasGemmPackBSize(N, K));
+
+        MlasGemmPackB(CblasNoTrans, N, K, B, N, PackedB);
+
+        for (int Packed = 0; Packed < 2; Packed++) {
+
+            std::fill_n(C, M * N, -0.5f);
+            std::fill_n(CReference, M * N, -0.5f);
+
+            if (Packed != 0) {
+                MlasGemm(CblasNoTrans, M, N, K, 1.0f, A, K, PackedB, beta, C, N, &Epilogue, threadpool);
+            } else {
+                MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, beta, C, N, &Epilogue, threadpool);
+            }
+
+            MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, beta, CReference, N, threadpool);
+
+            for (size_t m = 0; m < M; m++) {
+                for (size_t n = 0; n < N; n++) {
+                    float Value = CReference[m * N + n];
+                    if (Bias != nullptr) {
+                        Value += Bias[n];
+                    }
+                    if (Addend != nullptr) {
+                        Value += Addend[m * N + n];
+                    }
+                    CReference[m * N + n] = Value;
+                }
+            }
+
+            MlasActivation(&Activation, CReference, nullptr, M, N, N);
+
+            for (size_t f = 0; f < M * N; f++) {
+                if (C[f] != CReference[f]) {
+                    printf("mismatch epilogue Packed=%d, M=%zd, N=%zd, K=%zd, beta=%f, Bias=%d, Addend=%d, Activation=%d  %f %f!\n",
+                        Packed, M, N, K, beta, int(UseBias), int(UseAddend), int(ActivationKind), C[f], CReference[f]);
+                    break;
+                }
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferPackedB;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferAddend;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        static const MLAS_ACTIVATION_KIND kinds[] = { MlasIdentityActivation, MlasReluActivation, MlasLeakyReluActivation, MlasLogisticActivation };
+
+        for (size_t k = 0; k < _countof(kinds); k++) {
+            for (int flags = 0; flags < 4; flags++) {
+                Test(1, 33, 17, 0.0f, (flags & 1) != 0, (flags & 2) != 0, kinds[k]);
+                Test(5, 7, 300, 1.0f, (flags & 1) != 0, (flags & 2) != 0, kinds[k]);
+                Test(13, 150, 129, 0.5f, (flags & 1) != 0, (flags & 2) != 0, kinds[k]);
+                Test(160, 300, 64, 0.0f, (flags & 1) != 0, (flags & 2) != 0, kinds[k]);
+                Test(300, 40, 200, 1.0f, (flags & 1) != 0, (flags & 2) != 0, kinds[k]);
+            }
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t M = 1; M < 64; M += 5) {
+            for (size_t N = 1; N < 300; N += 17) {
+                for (size_t K = 1; K < 300; K += 37) {
+                    Test(M, N, K, 0.0f, true, true, MlasReluActivation);
+                    Test(M, N, K, 1.0f, true, false, MlasLogisticActivation);
+                }
+            }
+            printf("M %zd\n", M);
+        }
+    }
+};
+
 #ifdef MLAS_HAS_QGEMM_U8X8
 
 template <typename xint8_t>
@@ -1971,6 +2354,310 @@ public:
     }
 };
 
+class MlasSoftmaxTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+    void
+    TestExp(
+        size_t N,
+        float Minimum,
+        float Maximum
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
+
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = Minimum + (Maximum - Minimum) * float(n) / float(N);
+        }
+
+        MlasComputeExp(Input, Output, N);
+
+        for (size_t n = 0; n < N; n++) {
+            float Reference = std::exp(Input[n]);
+            if (std::fabs(Output[n] - Reference) > std::fabs(Reference) * 1e-6f + 1e-44f) {
+                printf("mismatch exp N=%zd n=%zd input=%.9g %.9g %.9g!\n", N, n, Input[n], Output[n], Reference);
+                break;
+            }
+        }
+    }
+
+    void
+    TestSoftmax(
+        size_t N,
+        size_t D,
+        float Scale,
+        bool LogSoftmax
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+
+        for (size_t f = 0; f < N * D; f++) {
+            Input[f] *= Scale;
+        }
+
+        if (LogSoftmax) {
+            MlasComputeLogSoftmax(Input, Output, N, D, threadpool);
+        } else {
+            MlasComputeSoftmax(Input, Output, N, D, threadpool);
+        }
+
+        for (size_t n = 0; n < N; n++) {
+
+            const float* InputRow = Input + n * D;
+            float* OutputRow = OutputReference + n * D;
+
+            double Maximum = InputRow[0];
+            for (size_t d = 1; d < D; d++) {
+                Maximum = std::max(Maximum, double(InputRow[d]));
+            }
+
+            double Sum = 0.0;
+            for (size_t d = 0; d < D; d++) {
+                Sum += std::exp(InputRow[d] - Maximum);
+            }
+
+            for (size_t d = 0; d < D; d++) {
+                if (LogSoftmax) {
+                    OutputRow[d] = float((InputRow[d] - Maximum) - std::log(Sum));
+                } else {
+                    OutputRow[d] = float(std::exp(InputRow[d] - Maximum) / Sum);
+                }
+            }
+        }
+
+        for (size_t f = 0; f < N * D; f++) {
+            if (std::fabs(Output[f] - OutputReference[f]) > std::fabs(OutputReference[f]) * 1e-5f + 1e-6f) {
+                printf("mismatch softmax N=%zd D=%zd LogSoftmax=%d f=%zd %.9g %.9g!\n",
+                    N, D, int(LogSoftmax), f, Output[f], OutputReference[f]);
+                break;
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t N = 1; N < 64; N++) {
+            TestExp(N, -10.0f, 10.0f);
+        }
+
+        TestExp(4000, -103.0f, 88.0f);
+        TestExp(4000, -0.5f, 0.5f);
+
+        for (int LogSoftmax = 0; LogSoftmax < 2; LogSoftmax++) {
+            for (size_t D = 1; D < 80; D++) {
+                TestSoftmax(3, D, 0.25f, LogSoftmax != 0);
+            }
+            TestSoftmax(1, 1000, 1.0f, LogSoftmax != 0);
+            TestSoftmax(67, 11, 4.0f, LogSoftmax != 0);
+            TestSoftmax(300, 1000, 0.1f, LogSoftmax != 0);
+            TestSoftmax(1024, 513, 10.0f, LogSoftmax != 0);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (int LogSoftmax = 0; LogSoftmax < 2; LogSoftmax++) {
+            for (size_t N = 1; N < 64; N += 3) {
+                for (size_t D = 1; D < 1024; D += 7) {
+                    TestSoftmax(N, D, 1.0f, LogSoftmax != 0);
+                }
+            }
+        }
+    }
+};
+
+class MlasBinaryOperationTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInputA;
+    MatrixGuardBuffer<float> BufferInputB;
+    MatrixGuardBuffer<float> BufferOutput;
+
+    static
+    size_t
+    GetInputCount(
+        MLAS_BINARY_BROADCAST_KIND Broadcast,
+        size_t OuterCount,
+        size_t ChannelCount,
+        size_t InnerCount
+        )
+    {
+        switch (Broadcast) {
+            case MlasNoBroadcast:
+                return OuterCount * ChannelCount * InnerCount;
+            case MlasRowBroadcast:
+                return ChannelCount * InnerCount;
+            case MlasChannelBroadcast:
+                return ChannelCount;
+            default:
+                return 1;
+        }
+    }
+
+    static
+    size_t
+    GetInputIndex(
+        MLAS_BINARY_BROADCAST_KIND Broadcast,
+        size_t o,
+        size_t c,
+        size_t i,
+        size_t ChannelCount,
+        size_t InnerCount
+        )
+    {
+        switch (Broadcast) {
+            case MlasNoBroadcast:
+                return (o * ChannelCount + c) * InnerCount + i;
+            case MlasRowBroadcast:
+                return c * InnerCount + i;
+            case MlasChannelBroadcast:
+                return c;
+            default:
+                return 0;
+        }
+    }
+
+    void
+    Test(
+        MLAS_BINARY_OPERATION_KIND OperationKind,
+        MLAS_BINARY_BROADCAST_KIND BroadcastA,
+        MLAS_BINARY_BROADCAST_KIND BroadcastB,
+        size_t OuterCount,
+        size_t ChannelCount,
+        size_t InnerCount
+        )
+    {
+        const size_t CountA = GetInputCount(BroadcastA, OuterCount, ChannelCount, InnerCount);
+        const size_t CountB = GetInputCount(BroadcastB, OuterCount, ChannelCount, InnerCount);
+        const size_t CountOutput = OuterCount * ChannelCount * InnerCount;
+
+        float* InputA = BufferInputA.GetBuffer(CountA);
+        float* InputB = BufferInputB.GetBuffer(CountB);
+        float* Output = BufferOutput.GetBuffer(CountOutput);
+
+        for (size_t n = 0; n < CountA; n++) {
+            InputA[n] = float(int(n % 23) - 11) * 0.75f;
+        }
+
+        for (size_t n = 0; n < CountB; n++) {
+            InputB[n] = float(int(n % 17) - 8) * 0.5f + 0.25f;
+        }
+
+        MlasComputeBinaryOperation(OperationKind, InputA, BroadcastA, InputB, BroadcastB,
+            Output, OuterCount, ChannelCount, InnerCount, threadpool);
+
+        for (size_t o = 0; o < OuterCount; o++) {
+            for (size_t c = 0; c < ChannelCount; c++) {
+                for (size_t i = 0; i < InnerCount; i++) {
+
+                    float a = InputA[GetInputIndex(BroadcastA, o, c, i, ChannelCount, InnerCount)];
+                    float b = InputB[GetInputIndex(BroadcastB, o, c, i, ChannelCount, InnerCount)];
+                    float Reference;
+
+                    switch (OperationKind) {
+                        case MlasAddBinaryOperation:
+                            Reference = a + b;
+                            break;
+                        case MlasSubtractBinaryOperation:
+                            Reference = a - b;
+                            break;
+                        case MlasMultiplyBinaryOperation:
+                            Reference = a * b;
+                            break;
+                        case MlasDivideBinaryOperation:
+                            Reference = a / b;
+                            break;
+                        case MlasMaximumBinaryOperation:
+                            Reference = std::max(a, b);
+                            break;
+                        default:
+                            Reference = std::min(a, b);
+                            break;
+                    }
+
+                    size_t f = (o * ChannelCount + c) * InnerCount + i;
+
+                    if (Output[f] != Reference) {
+                        printf("mismatch binary kind=%d broadcast=%d,%d shape(%zd,%zd,%zd) f=%zd %.9g %.9g!\n",
+                            int(OperationKind), int(BroadcastA), int(BroadcastB), OuterCount, ChannelCount,
+                            InnerCount, f, Output[f], Reference);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    void
+    TestAllKinds(
+        size_t OuterCount,
+        size_t ChannelCount,
+        size_t InnerCount
+        )
+    {
+        static const MLAS_BINARY_BROADCAST_KIND BroadcastKinds[] = {
+            MlasNoBroadcast,
+            MlasScalarBroadcast,
+            MlasChannelBroadcast,
+            MlasRowBroadcast,
+        };
+
+        for (int kind = MlasAddBinaryOperation; kind <= MlasMinimumBinaryOperation; kind++) {
+            for (MLAS_BINARY_BROADCAST_KIND BroadcastA : BroadcastKinds) {
+                for (MLAS_BINARY_BROADCAST_KIND BroadcastB : BroadcastKinds) {
+                    Test(MLAS_BINARY_OPERATION_KIND(kind), BroadcastA, BroadcastB, OuterCount, ChannelCount, InnerCount);
+                }
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t n = 1; n < 40; n++) {
+            TestAllKinds(1, 1, n);
+            TestAllKinds(3, 1, n);
+            TestAllKinds(2, n, 7);
+        }
+
+        TestAllKinds(2, 64, 56 * 56);
+        TestAllKinds(1, 3, 224 * 224);
+        TestAllKinds(128, 1, 768);
+        TestAllKinds(1, 1, 1000003);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        for (size_t o = 1; o < 8; o++) {
+            for (size_t c = 1; c < 33; c += 3) {
+                for (size_t i = 1; i < 200; i += 5) {
+                    TestAllKinds(o, c, i);
+                }
+            }
+        }
+    }
+};
+
 int
 #if defined(_WIN32)
 __cdecl
@@ -1983,6 +2670,9 @@ main(
 
         printf("SGEMM tests.\n");
         onnxruntime::make_unique<MlasFgemmTest<float>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasSgemmPackedTest>()->ExecuteShort();
+        onnxruntime::make_unique<MlasSgemmBatchTest>()->ExecuteShort();
+        onnxruntime::make_unique<MlasSgemmEpilogueTest>()->ExecuteShort();
 #ifdef MLAS_HAS_DGEMM
         printf("DGEMM tests.\n");
         onnxruntime::make_unique<MlasFgemmTest<double>>()->ExecuteShort();
@@ -2012,6 +2702,12 @@ main(
         printf("Activation tests.\n");
         onnxruntime::make_unique<MlasActivationTest>()->ExecuteShort();
 
+        printf("Softmax tests.\n");
+        onnxruntime::make_unique<MlasSoftmaxTest>()->ExecuteShort();
+
+        printf("Binary operation tests.\n");
+        onnxruntime::make_unique<MlasBinaryOperationTest>()->ExecuteShort();
+
         printf("Done.\n");
 #if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
         if(threadpool != nullptr) threadpool = new onnxruntime::concurrency::ThreadPool("test", 2);
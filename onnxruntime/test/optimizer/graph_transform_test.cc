@@ -7,6 +7,9 @@
 #include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/cast_elimination.h"
+#include "core/optimizer/common_subexpression_elimination.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_mul_fusion.h"
@@ -19,11 +22,15 @@
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/initializer.h"
+#include "core/optimizer/layer_norm_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
+#include "core/optimizer/reshape_elimination.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/squeeze_unsqueeze_elimination.h"
+#include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/platform/env.h"
 #include "core/util/math.h"
@@ -800,6 +807,31 @@ TEST(GraphTransformationTests, ReluClip11Fusion) {
   }
 }
 
+static void AddFloatInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                                const std::vector<float>& values) {
+  ONNX_NAMESPACE::TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    tensor.add_dims(dim);
+  }
+  for (auto value : values) {
+    tensor.add_float_data(value);
+  }
+  graph.AddInitializedTensor(tensor);
+}
+
+static void AddInt64Initializer(Graph& graph, const std::string& name, const std::vector<int64_t>& values) {
+  ONNX_NAMESPACE::TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  tensor.add_dims(static_cast<int64_t>(values.size()));
+  for (auto value : values) {
+    tensor.add_int64_data(value);
+  }
+  graph.AddInitializedTensor(tensor);
+}
+
 #ifndef DISABLE_CONTRIB_OPS
 TEST(GraphTransformationTests, GeluFusionTest) {
   string model_uri = MODEL_FOLDER + "fusion/gelu.onnx";
@@ -819,7 +851,876 @@ TEST(GraphTransformationTests, GeluFusionTest) {
   ASSERT_TRUE(op_to_count["Mul"] == 0);
   ASSERT_TRUE(op_to_count["Gelu"] == 1);
 }
+
+// Build the LayerNorm subgraph of BERT exports on an input X of shape {batch, 3, 4}:
+// Y = (X - mean(X)) / Sqrt(mean(Pow(X - mean(X), 2)) + epsilon) * scale + bias
+static void BuildLayerNormGraph(Graph& graph, bool use_two_subs, const std::vector<int64_t>& scale_dims) {
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(3);
+  shape->add_dim()->set_dim_value(4);
+
+  int64_t scale_size = 1;
+  for (auto dim : scale_dims) {
+    scale_size *= dim;
+  }
+
+  AddFloatInitializer(graph, "two", {}, {2.f});
+  AddFloatInitializer(graph, "epsilon", {}, {1e-5f});
+  AddFloatInitializer(graph, "scale", scale_dims, std::vector<float>(static_cast<size_t>(scale_size), 2.f));
+  AddFloatInitializer(graph, "bias", {4}, {1.f, 2.f, 3.f, 4.f});
+
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto* x = &graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto* y = &graph.GetOrCreateNodeArg("Y", &float_tensor);
+
+  auto& reduce_mean = graph.AddNode("reduce_mean", "ReduceMean", "", {x}, {arg("mean")});
+  reduce_mean.AddAttribute("axes", std::vector<int64_t>{-1});
+  graph.AddNode("sub", "Sub", "", {x, arg("mean")}, {arg("diff")});
+  if (use_two_subs) {
+    graph.AddNode("sub2", "Sub", "", {x, arg("mean")}, {arg("diff2")});
+  }
+  graph.AddNode("pow", "Pow", "", {arg("diff"), arg("two")}, {arg("pow")});
+  // positive axis of the variance
+  auto& reduce_mean2 = graph.AddNode("reduce_mean2", "ReduceMean", "", {arg("pow")}, {arg("variance")});
+  reduce_mean2.AddAttribute("axes", std::vector<int64_t>{2});
+  graph.AddNode("add_epsilon", "Add", "", {arg("epsilon"), arg("variance")}, {arg("variance_epsilon")});
+  graph.AddNode("sqrt", "Sqrt", "", {arg("variance_epsilon")}, {arg("std_dev")});
+  graph.AddNode("div", "Div", "", {arg(use_two_subs ? "diff2" : "diff"), arg("std_dev")}, {arg("normalized")});
+  graph.AddNode("mul", "Mul", "", {arg("scale"), arg("normalized")}, {arg("scaled")});
+  graph.AddNode("add_bias", "Add", "", {arg("scaled"), arg("bias")}, {y});
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+}
+
+TEST(GraphTransformationTests, LayerNormFusionTest) {
+  for (bool use_two_subs : {false, true}) {
+    std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+    Model model("LayerNormFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+    Graph& graph = model.MainGraph();
+    BuildLayerNormGraph(graph, use_two_subs, {4});
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(onnxruntime::make_unique<LayerNormFusion>(), TransformerLevel::Level2);
+    ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    ASSERT_EQ(op_to_count["ReduceMean"], 0);
+    ASSERT_EQ(op_to_count["Sub"], 0);
+    ASSERT_EQ(op_to_count["Pow"], 0);
+    ASSERT_EQ(op_to_count["Sqrt"], 0);
+    ASSERT_EQ(op_to_count["Div"], 0);
+    ASSERT_EQ(op_to_count["Mul"], 0);
+    ASSERT_EQ(op_to_count["Add"], 0);
+    ASSERT_EQ(op_to_count["LayerNormalization"], 1);
+
+    for (const Node& node : graph.Nodes()) {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "X");
+      ASSERT_EQ(node.InputDefs()[1]->Name(), "scale");
+      ASSERT_EQ(node.InputDefs()[2]->Name(), "bias");
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y");
+      ASSERT_EQ(node.GetAttributes().at("axis").i(), -1);
+      ASSERT_FLOAT_EQ(node.GetAttributes().at("epsilon").f(), 1e-5f);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, LayerNormFusionBroadcastScale) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("LayerNormFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+  // a scalar scale is broadcast by the Mul, which the LayerNormalization kernel doesn't support
+  BuildLayerNormGraph(graph, false, {1});
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<LayerNormFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["ReduceMean"], 2);
+  ASSERT_EQ(op_to_count["LayerNormalization"], 0);
+}
+
+// Build num_layers self-attention subgraphs of BERT exports with 2 heads of size 2, on an input X of shape
+// {batch, 3, 4} and a mask of shape {batch, 3} shared by the layers. The Q, K and V weights are filled with
+// 1, 2 and 3 respectively.
+static void BuildAttentionGraph(Graph& graph, int num_layers) {
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(3);
+  shape->add_dim()->set_dim_value(4);
+
+  TypeProto mask_tensor;
+  mask_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  auto* mask_shape = mask_tensor.mutable_tensor_type()->mutable_shape();
+  mask_shape->add_dim()->set_dim_param("batch");
+  mask_shape->add_dim()->set_dim_value(3);
+
+  AddFloatInitializer(graph, "one", {}, {1.f});
+  AddFloatInitializer(graph, "mask_value", {}, {-10000.f});
+  AddFloatInitializer(graph, "sqrt_head_size", {}, {std::sqrt(2.f)});
+  AddInt64Initializer(graph, "qkv_shape", {0, 0, 2, 2});
+  AddInt64Initializer(graph, "output_shape", {0, 0, 4});
+
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto* mask = &graph.GetOrCreateNodeArg("mask", &mask_tensor);
+
+  auto& unsqueeze = graph.AddNode("unsqueeze", "Unsqueeze", "", {mask}, {arg("mask_unsqueezed")});
+  unsqueeze.AddAttribute("axes", std::vector<int64_t>{1});
+  auto& unsqueeze2 = graph.AddNode("unsqueeze2", "Unsqueeze", "", {arg("mask_unsqueezed")}, {arg("mask_4d")});
+  unsqueeze2.AddAttribute("axes", std::vector<int64_t>{2});
+  auto& cast = graph.AddNode("cast", "Cast", "", {arg("mask_4d")}, {arg("mask_float")});
+  cast.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("sub", "Sub", "", {arg("one"), arg("mask_float")}, {arg("mask_inverted")});
+  graph.AddNode("mul", "Mul", "", {arg("mask_inverted"), arg("mask_value")}, {arg("mask_add")});
+
+  std::string x = "X";
+  for (int layer = 0; layer < num_layers; ++layer) {
+    const std::string prefix = "layer" + std::to_string(layer) + "_";
+    const std::string y = layer + 1 == num_layers ? "Y" : prefix + "output";
+    auto name = [&prefix](const std::string& n) { return prefix + n; };
+
+    const std::vector<std::pair<std::string, std::vector<int64_t>>> projections{
+        {"q", {0, 2, 1, 3}}, {"k", {0, 2, 3, 1}}, {"v", {0, 2, 1, 3}}};
+    float weight_value = 1.f;
+    for (const auto& projection : projections) {
+      const std::string& p = projection.first;
+      AddFloatInitializer(graph, name(p + "_weight"), {4, 4}, std::vector<float>(16, weight_value));
+      AddFloatInitializer(graph, name(p + "_bias"), {4}, {0.1f, 0.2f, 0.3f, 0.4f});
+      weight_value += 1.f;
+
+      graph.AddNode(name(p + "_matmul"), "MatMul", "",
+                    {&graph.GetOrCreateNodeArg(x, &float_tensor), arg(name(p + "_weight"))},
+                    {arg(name(p + "_matmul_out"))});
+      graph.AddNode(name(p + "_add"), "Add", "", {arg(name(p + "_matmul_out")), arg(name(p + "_bias"))},
+                    {arg(name(p + "_add_out"))});
+      graph.AddNode(name(p + "_reshape"), "Reshape", "", {arg(name(p + "_add_out")), arg("qkv_shape")},
+                    {arg(name(p + "_reshape_out"))});
+      auto& transpose = graph.AddNode(name(p + "_transpose"), "Transpose", "", {arg(name(p + "_reshape_out"))},
+                                      {arg(name(p))});
+      transpose.AddAttribute("perm", projection.second);
+    }
+
+    graph.AddNode(name("qk"), "MatMul", "", {arg(name("q")), arg(name("k"))}, {arg(name("qk_out"))});
+    graph.AddNode(name("scale"), "Div", "", {arg(name("qk_out")), arg("sqrt_head_size")}, {arg(name("scaled"))});
+    graph.AddNode(name("add_mask"), "Add", "", {arg(name("scaled")), arg("mask_add")}, {arg(name("masked"))});
+    auto& softmax = graph.AddNode(name("softmax"), "Softmax", "", {arg(name("masked"))}, {arg(name("probs"))});
+    softmax.AddAttribute("axis", static_cast<int64_t>(3));
+    graph.AddNode(name("context"), "MatMul", "", {arg(name("probs")), arg(name("v"))}, {arg(name("context_out"))});
+    auto& transpose = graph.AddNode(name("context_transpose"), "Transpose", "", {arg(name("context_out"))},
+                                    {arg(name("context_transposed"))});
+    transpose.AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    graph.AddNode(name("context_reshape"), "Reshape", "", {arg(name("context_transposed")), arg("output_shape")},
+                  {&graph.GetOrCreateNodeArg(y, &float_tensor)});
+    x = y;
+  }
+
+  ASSERT_TRUE(graph.Resolve().IsOK());
+}
+
+TEST(GraphTransformationTests, AttentionFusionTest) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}, {kMSDomain, 1}};
+  Model model("AttentionFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+  BuildAttentionGraph(graph, 2);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["MatMul"], 0);
+  ASSERT_EQ(op_to_count["Add"], 0);
+  ASSERT_EQ(op_to_count["Reshape"], 0);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["Div"], 0);
+  ASSERT_EQ(op_to_count["Softmax"], 0);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 0);
+  ASSERT_EQ(op_to_count["Sub"], 0);
+  ASSERT_EQ(op_to_count["Mul"], 0);
+  ASSERT_EQ(op_to_count["Attention"], 2);
+
+  // the mask is cast once for both layers
+  ASSERT_EQ(op_to_count["Cast"], 1);
+
+  std::set<std::string> mask_names;
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() != "Attention") {
+      continue;
+    }
+
+    ASSERT_EQ(node.GetAttributes().at("num_heads").i(), 2);
+    mask_names.insert(node.InputDefs()[3]->Name());
+
+    // each row of the packed weight holds a row of the Q, K and V weights
+    const ONNX_NAMESPACE::TensorProto* weight_proto = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[1]->Name(), weight_proto));
+    Initializer weight(*weight_proto);
+    ASSERT_EQ(weight.dims(), (std::vector<int64_t>{4, 12}));
+    for (int64_t i = 0; i < 12; ++i) {
+      ASSERT_EQ(weight.data<float>()[3 * 12 + i], static_cast<float>(1 + i / 4));
+    }
+
+    const ONNX_NAMESPACE::TensorProto* bias_proto = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[2]->Name(), bias_proto));
+    Initializer bias(*bias_proto);
+    ASSERT_EQ(bias.size(), 12);
+    ASSERT_FLOAT_EQ(bias.data<float>()[5], 0.2f);
+  }
+
+  ASSERT_EQ(mask_names.size(), 1u);
+}
+
+// Run the model built by BuildAttentionGraph on a batch of 2 with the given mask, without graph optimizations.
+static void RunAttentionModel(Model& model, const std::vector<int64_t>& mask_data, std::vector<float>& output) {
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  SessionOptions so;
+  so.graph_optimization_level = TransformerLevel::Default;
+  so.session_logid = "GraphTransformationTests.RunAttentionModel";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<float> x_data(2 * 3 * 4);
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = 0.1f * static_cast<float>(i % 7) - 0.3f;
+  }
+
+  OrtValue x_value;
+  OrtValue mask_value;
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  CreateMLValue<float>(allocator, {2, 3, 4}, x_data, &x_value);
+  CreateMLValue<int64_t>(allocator, {2, 3}, mask_data, &mask_value);
+  NameMLValMap feeds{{"X", x_value}, {"mask", mask_value}};
+
+  RunOptions run_options;
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_TRUE(session_object.Run(run_options, feeds, output_names, &fetches).IsOK());
+
+  const Tensor& y = fetches[0].Get<Tensor>();
+  output.assign(y.Data<float>(), y.Data<float>() + y.Shape().Size());
+}
+
+TEST(GraphTransformationTests, AttentionFusionNonPrefixMask) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}, {kMSDomain, 1}};
+  Model model("AttentionFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+  BuildAttentionGraph(graph, 2);
+
+  // the first batch masks out a token in the middle of the sequence, so the mask isn't a prefix of 1s
+  const std::vector<int64_t> mask_data{1, 0, 1, 1, 1, 0};
+  std::vector<float> expected_output;
+  RunAttentionModel(model, mask_data, expected_output);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+  ASSERT_EQ(CountOpsInGraph(graph)["Attention"], 2);
+
+  std::vector<float> output;
+  RunAttentionModel(model, mask_data, output);
+
+  ASSERT_EQ(output.size(), expected_output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_NEAR(output[i], expected_output[i], 1e-4f) << "at index " << i;
+  }
+}
+
+TEST(GraphTransformationTests, AttentionFusionInvalidScale) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}, {kMSDomain, 1}};
+  Model model("AttentionFusion", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+  BuildAttentionGraph(graph, 1);
+
+  // scale by a constant that isn't 1 / sqrt(head_size)
+  Node* scale_node = nullptr;
+  for (Node& node : graph.Nodes()) {
+    if (node.OpType() == "Div") {
+      scale_node = &node;
+    }
+  }
+  ASSERT_NE(scale_node, nullptr);
+  graph_utils::ReplaceNodeInput(*scale_node, 1, *graph.GetNodeArg("one"));
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Softmax"], 1);
+  ASSERT_EQ(op_to_count["Attention"], 0);
+}
 #endif
 
+// Create a float NodeArg with the given dims.
+static NodeArg* AddFloatNodeArg(Graph& graph, const std::string& name, const std::vector<int64_t>& dims) {
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  for (auto dim : dims) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+  return &graph.GetOrCreateNodeArg(name, &float_tensor);
+}
+
+// Resolve a graph and apply the TransposeOptimizer to it.
+static void ApplyTransposeOptimizer(Graph& graph) {
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+}
+
+TEST(GraphTransformationTests, TransposeOptimizerPushDown) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("TransposeOptimizer", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  // NHWC to NCHW, Relu and Add of a bias with the dims of C and H, and back to NHWC
+  AddFloatInitializer(graph, "bias", {4, 2, 1}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f});
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto& to_nchw = graph.AddNode("to_nchw", "Transpose", "", {AddFloatNodeArg(graph, "X", {1, 2, 3, 4})},
+                                {arg("x_nchw")});
+  to_nchw.AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  graph.AddNode("relu", "Relu", "", {arg("x_nchw")}, {arg("relu")});
+  graph.AddNode("add", "Add", "", {arg("relu"), arg("bias")}, {arg("add")});
+  auto& to_nhwc = graph.AddNode("to_nhwc", "Transpose", "", {arg("add")},
+                                {AddFloatNodeArg(graph, "Y", {1, 2, 3, 4})});
+  to_nhwc.AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  ApplyTransposeOptimizer(graph);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+  ASSERT_EQ(op_to_count["Add"], 1);
+
+  // the bias is transposed to NHWC
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Add") {
+      const ONNX_NAMESPACE::TensorProto* bias_proto = nullptr;
+      ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[1]->Name(), bias_proto));
+      Initializer bias(*bias_proto);
+      ASSERT_EQ(bias.dims(), (std::vector<int64_t>{1, 2, 1, 4}));
+      const std::vector<float> expected{0.f, 2.f, 4.f, 6.f, 1.f, 3.f, 5.f, 7.f};
+      ASSERT_EQ(std::vector<float>(bias.data<float>(), bias.data<float>() + bias.size()), expected);
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, TransposeOptimizerConcatSplitReduce) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("TransposeOptimizer", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  for (const std::string input : {"X1", "X2", "X3"}) {
+    auto& transpose = graph.AddNode(input + "_transpose", "Transpose", "",
+                                    {AddFloatNodeArg(graph, input, {1, 2, 3, 4})}, {arg(input + "_nchw")});
+    transpose.AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  }
+
+  // concat and split on C, and back to NHWC
+  auto& concat = graph.AddNode("concat", "Concat", "", {arg("X1_nchw"), arg("X2_nchw")}, {arg("concat")});
+  concat.AddAttribute("axis", static_cast<int64_t>(1));
+  auto& split = graph.AddNode("split", "Split", "", {arg("concat")}, {arg("split0"), arg("split1")});
+  split.AddAttribute("axis", static_cast<int64_t>(-3));
+  for (int i = 0; i < 2; ++i) {
+    const std::string output = "Y" + std::to_string(i);
+    auto& to_nhwc = graph.AddNode(output + "_transpose", "Transpose", "", {arg("split" + std::to_string(i))},
+                                  {AddFloatNodeArg(graph, output, {1, 2, 3, 4})});
+    to_nhwc.AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  }
+
+  // mean over H and W
+  auto& reduce_mean = graph.AddNode("reduce_mean", "ReduceMean", "", {arg("X3_nchw")},
+                                    {AddFloatNodeArg(graph, "Z", {1, 4})});
+  reduce_mean.AddAttribute("axes", std::vector<int64_t>{2, 3});
+  reduce_mean.AddAttribute("keepdims", static_cast<int64_t>(0));
+  ApplyTransposeOptimizer(graph);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Concat") {
+      ASSERT_EQ(node.GetAttributes().at("axis").i(), 3);
+    } else if (node.OpType() == "Split") {
+      ASSERT_EQ(node.GetAttributes().at("axis").i(), 3);
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y0");
+      ASSERT_EQ(node.OutputDefs()[1]->Name(), "Y1");
+    } else if (node.OpType() == "ReduceMean") {
+      std::vector<int64_t> axes;
+      ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes));
+      ASSERT_EQ(axes, (std::vector<int64_t>{1, 2}));
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "X3");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, TransposeOptimizerFoldIntoGemm) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("TransposeOptimizer", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  AddFloatInitializer(graph, "B", {3, 4}, std::vector<float>(12, 1.f));
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto& transpose = graph.AddNode("transpose", "Transpose", "", {AddFloatNodeArg(graph, "A", {3, 2})},
+                                  {arg("a_transposed")});
+  transpose.AddAttribute("perm", std::vector<int64_t>{1, 0});
+  graph.AddNode("matmul", "MatMul", "", {arg("a_transposed"), arg("B")}, {AddFloatNodeArg(graph, "Y", {2, 4})});
+  ApplyTransposeOptimizer(graph);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["MatMul"], 0);
+  ASSERT_EQ(op_to_count["Gemm"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    ASSERT_EQ(node.InputDefs()[0]->Name(), "A");
+    ASSERT_EQ(node.GetAttributes().at("transA").i(), 1);
+    ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y");
+  }
+}
+
+TEST(GraphTransformationTests, CommonSubexpressionElimination) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("CommonSubexpressionElimination", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  AddInt64Initializer(graph, "index", {0});
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto* x = AddFloatNodeArg(graph, "X", {2, 3});
+
+  // the same Shape->Gather->Unsqueeze chain twice
+  for (const std::string suffix : {"1", "2"}) {
+    graph.AddNode("shape" + suffix, "Shape", "", {x}, {arg("shape" + suffix)});
+    graph.AddNode("gather" + suffix, "Gather", "", {arg("shape" + suffix), arg("index")}, {arg("dim" + suffix)});
+    auto& unsqueeze = graph.AddNode("unsqueeze" + suffix, "Unsqueeze", "", {arg("dim" + suffix)},
+                                    {arg("unsqueezed" + suffix)});
+    unsqueeze.AddAttribute("axes", std::vector<int64_t>{0});
+  }
+  auto& concat = graph.AddNode("concat", "Concat", "", {arg("unsqueezed1"), arg("unsqueezed2")}, {arg("Y")});
+  concat.AddAttribute("axis", static_cast<int64_t>(0));
+
+  // Relu twice, and a Relu with a different input
+  graph.AddNode("relu1", "Relu", "", {x}, {arg("relu1")});
+  graph.AddNode("relu2", "Relu", "", {x}, {arg("relu2")});
+  graph.AddNode("relu3", "Relu", "", {arg("relu1")}, {arg("relu3")});
+  graph.AddNode("sum", "Sum", "", {arg("relu1"), arg("relu2"), arg("relu3")}, {arg("Z")});
+
+  // random values must not be shared
+  graph.AddNode("random1", "RandomUniformLike", "", {x}, {arg("random1")});
+  graph.AddNode("random2", "RandomUniformLike", "", {x}, {arg("random2")});
+  graph.AddNode("add", "Add", "", {arg("random1"), arg("random2")}, {arg("W")});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<CommonSubexpressionElimination>(),
+                                    TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Shape"], 1);
+  ASSERT_EQ(op_to_count["Gather"], 1);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 1);
+  ASSERT_EQ(op_to_count["Relu"], 2);
+  ASSERT_EQ(op_to_count["RandomUniformLike"], 2);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Concat") {
+      ASSERT_EQ(node.InputDefs()[0], node.InputDefs()[1]);
+    } else if (node.OpType() == "Sum") {
+      ASSERT_EQ(node.InputDefs()[0], node.InputDefs()[1]);
+      ASSERT_NE(node.InputDefs()[0], node.InputDefs()[2]);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, CommonSubexpressionEliminationSubgraphNameClash) {
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  // the subgraph consumes relu2 of the parent graph and has a value of its own named relu1
+  GraphProto subgraph_proto;
+  {
+    Model model("CommonSubexpressionEliminationSubgraphNameClash_subgraph");
+    auto& subgraph = model.MainGraph();
+    auto& parent_arg = subgraph.GetOrCreateNodeArg("relu2", &float_tensor_type);
+    subgraph.AddOuterScopeNodeArg("relu2");
+    auto& local_arg = subgraph.GetOrCreateNodeArg("relu1", &float_tensor_type);
+    subgraph.AddNode("neg", "Neg", "", {&parent_arg}, {&local_arg});
+    auto& subgraph_out = subgraph.GetOrCreateNodeArg("subgraph_out", &float_tensor_type);
+    subgraph.AddNode("identity", "Identity", "", {&local_arg}, {&subgraph_out});
+    auto status = subgraph.Resolve();
+    ASSERT_TRUE(status.IsOK()) << status;
+    subgraph_proto = subgraph.ToGraphProto();
+  }
+
+  Model model("CommonSubexpressionEliminationSubgraphNameClash");
+  auto& graph = model.MainGraph();
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor_type);
+  auto& relu1 = graph.GetOrCreateNodeArg("relu1", &float_tensor_type);
+  auto& relu2 = graph.GetOrCreateNodeArg("relu2", &float_tensor_type);
+  graph.AddNode("relu1", "Relu", "", {&x}, {&relu1});
+  graph.AddNode("relu2", "Relu", "", {&x}, {&relu2});
+
+  TypeProto if_cond_type;
+  if_cond_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  if_cond_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& if_cond = graph.GetOrCreateNodeArg("if_in", &if_cond_type);
+  auto& if_out = graph.GetOrCreateNodeArg("if_out", &float_tensor_type);
+  auto& if_node = graph.AddNode("if", "If", "", {&if_cond}, {&if_out});
+  if_node.AddAttribute("then_branch", subgraph_proto);
+  if_node.AddAttribute("else_branch", subgraph_proto);
+
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor_type);
+  graph.AddNode("add", "Add", "", {&relu1, &if_out}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<CommonSubexpressionElimination>(),
+                                    TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  // replacing relu2 with relu1 would make the subgraph read its own relu1 instead of the parent's
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Relu"], 2);
+}
+
+// Resolve a graph and apply a Level1 rewrite rule to it.
+static void ApplyRewriteRule(Graph& graph, std::unique_ptr<RewriteRule> rule) {
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  auto rule_transformer_L1 = onnxruntime::make_unique<RuleBasedGraphTransformer>("RuleTransformer1");
+  rule_transformer_L1->Register(std::move(rule));
+  graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+}
+
+TEST(GraphTransformationTests, ReshapeElimination) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("ReshapeElimination", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  AddInt64Initializer(graph, "shape1", {6, 4});
+  AddInt64Initializer(graph, "shape2", {2, 12});
+  AddInt64Initializer(graph, "shape3", {2, 3, 4});
+  AddInt64Initializer(graph, "shape4", {0, 2, 2});
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto* x = AddFloatNodeArg(graph, "X", {2, 3, 4});
+
+  // the second Reshape reshapes X directly
+  graph.AddNode("reshape1", "Reshape", "", {x, arg("shape1")}, {arg("reshape1")});
+  graph.AddNode("reshape2", "Reshape", "", {arg("reshape1"), arg("shape2")}, {arg("reshape2")});
+  graph.AddNode("neg1", "Neg", "", {arg("reshape2")}, {arg("Y1")});
+
+  // Flatten and Reshape back to the original shape cancel out
+  graph.AddNode("relu", "Relu", "", {x}, {arg("relu")});
+  auto& flatten = graph.AddNode("flatten", "Flatten", "", {arg("relu")}, {arg("flatten")});
+  flatten.AddAttribute("axis", static_cast<int64_t>(1));
+  graph.AddNode("reshape3", "Reshape", "", {arg("flatten"), arg("shape3")}, {arg("reshape3")});
+  graph.AddNode("neg2", "Neg", "", {arg("reshape3")}, {arg("Y2")});
+
+  // a 0 in the shape copies a dimension of the input Reshape, so the Reshape can't be bypassed
+  graph.AddNode("reshape4", "Reshape", "", {x, arg("shape1")}, {arg("reshape4")});
+  graph.AddNode("reshape5", "Reshape", "", {arg("reshape4"), arg("shape4")}, {arg("reshape5")});
+  graph.AddNode("neg3", "Neg", "", {arg("reshape5")}, {arg("Y3")});
+
+  // the only input edge of a Reshape of a graph input is for the target shape, which its consumers must not get
+  graph.AddNode("shape", "Shape", "", {x}, {arg("shape")});
+  graph.AddNode("reshape6", "Reshape", "", {x, arg("shape")}, {AddFloatNodeArg(graph, "reshape6", {2, 3, 4})});
+  graph.AddNode("neg4", "Neg", "", {arg("reshape6")}, {arg("Y4")});
+
+  ApplyRewriteRule(graph, onnxruntime::make_unique<ReshapeElimination>());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Reshape"], 4);
+  ASSERT_EQ(op_to_count["Flatten"], 0);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.Name() == "reshape2") {
+      ASSERT_EQ(node.InputDefs()[0], x);
+    } else if (node.Name() == "neg2") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "relu");
+    } else if (node.Name() == "reshape5") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "reshape4");
+    } else if (node.Name() == "neg4") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "reshape6");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, CastElimination) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("CastElimination", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto add_cast = [&graph, &arg](const std::string& name, const std::string& input, TensorProto_DataType to) {
+    auto& cast = graph.AddNode(name, "Cast", "", {arg(input)}, {arg(name)});
+    cast.AddAttribute("to", static_cast<int64_t>(to));
+  };
+  graph.AddNode("relu", "Relu", "", {AddFloatNodeArg(graph, "X", {2, 3})}, {arg("relu")});
+
+  // Cast to the same type
+  add_cast("cast1", "relu", TensorProto_DataType_FLOAT);
+  graph.AddNode("neg1", "Neg", "", {arg("cast1")}, {arg("Y1")});
+
+  // lossless round trip through double
+  add_cast("cast2", "relu", TensorProto_DataType_DOUBLE);
+  add_cast("cast3", "cast2", TensorProto_DataType_FLOAT);
+  graph.AddNode("neg2", "Neg", "", {arg("cast3")}, {arg("Y2")});
+
+  // the round trip through int32 truncates the values
+  add_cast("cast4", "relu", TensorProto_DataType_INT32);
+  add_cast("cast5", "cast4", TensorProto_DataType_FLOAT);
+  graph.AddNode("neg3", "Neg", "", {arg("cast5")}, {arg("Y3")});
+
+  ApplyRewriteRule(graph, onnxruntime::make_unique<CastElimination>());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Cast"], 2);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.Name() == "neg1" || node.Name() == "neg2") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "relu");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, SqueezeUnsqueezeElimination) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("SqueezeUnsqueezeElimination", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  auto add_node = [&graph, &arg](const std::string& name, const std::string& op_type, const std::string& input,
+                                 const std::vector<int64_t>& axes) {
+    auto& node = graph.AddNode(name, op_type, "", {arg(input)}, {arg(name)});
+    node.AddAttribute("axes", axes);
+  };
+  graph.AddNode("relu", "Relu", "", {AddFloatNodeArg(graph, "X", {2, 1, 3})}, {arg("relu")});
+
+  // Squeeze and Unsqueeze of the same axis, with a negative axis
+  add_node("squeeze1", "Squeeze", "relu", {1});
+  add_node("unsqueeze1", "Unsqueeze", "squeeze1", {-2});
+  graph.AddNode("neg1", "Neg", "", {arg("unsqueeze1")}, {arg("Y1")});
+
+  // Unsqueeze and Squeeze of the same axis
+  add_node("unsqueeze2", "Unsqueeze", "relu", {0});
+  add_node("squeeze2", "Squeeze", "unsqueeze2", {0});
+  graph.AddNode("neg2", "Neg", "", {arg("squeeze2")}, {arg("Y2")});
+
+  // different axes
+  add_node("squeeze3", "Squeeze", "relu", {1});
+  add_node("unsqueeze3", "Unsqueeze", "squeeze3", {0});
+  graph.AddNode("neg3", "Neg", "", {arg("unsqueeze3")}, {arg("Y3")});
+
+  ApplyRewriteRule(graph, onnxruntime::make_unique<SqueezeUnsqueezeElimination>());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Squeeze"], 1);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.Name() == "neg1" || node.Name() == "neg2") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "relu");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, ConstantFoldingMaxOutputBytes) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("ConstantFoldingMaxOutputBytes", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  AddFloatInitializer(graph, "value", {1}, {1.f});
+  AddInt64Initializer(graph, "small_shape", {4});
+  AddInt64Initializer(graph, "large_shape", {1024});
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  graph.AddNode("small", "Expand", "", {arg("value"), arg("small_shape")}, {arg("small")});
+  graph.AddNode("large", "Expand", "", {arg("value"), arg("large_shape")}, {arg("large")});
+  graph.AddNode("add1", "Add", "", {AddFloatNodeArg(graph, "X", {4}), arg("small")}, {arg("Y1")});
+  graph.AddNode("add2", "Add", "", {AddFloatNodeArg(graph, "Z", {1024}), arg("large")}, {arg("Y2")});
+  // the size of the output of NonZero is only known after running it
+  graph.AddNode("nonzero", "NonZero", "", {arg("value")}, {arg("indices")});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  // the outputs of the large Expand take 4096 bytes
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(std::unordered_set<std::string>{}, 1024),
+                                    TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Expand"], 1);
+  ASSERT_EQ(op_to_count["NonZero"], 1);
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Expand") {
+      ASSERT_EQ(node.Name(), "large");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, ConstantFoldingShapeSubset) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("ConstantFoldingShapeSubset", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version);
+  Graph& graph = model.MainGraph();
+
+  // X has a symbolic batch dimension
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(3);
+  shape->add_dim()->set_dim_value(4);
+  auto* x = &graph.GetOrCreateNodeArg("X", &float_tensor);
+
+  AddInt64Initializer(graph, "index0", {0});
+  AddInt64Initializer(graph, "index1", {1});
+  AddInt64Initializer(graph, "minus_one", {-1});
+  AddInt64Initializer(graph, "starts", {1});
+  AddInt64Initializer(graph, "ends", {std::numeric_limits<int64_t>::max()});
+  auto arg = [&graph](const std::string& name) { return &graph.GetOrCreateNodeArg(name, nullptr); };
+  graph.AddNode("shape", "Shape", "", {x}, {arg("shape")});
+
+  // Reshape to {-1, 3}, where 3 is the known dimension 1 of X
+  graph.AddNode("gather1", "Gather", "", {arg("shape"), arg("index1")}, {arg("dim1")});
+  auto& concat1 = graph.AddNode("concat1", "Concat", "", {arg("minus_one"), arg("dim1")}, {arg("shape1")});
+  concat1.AddAttribute("axis", static_cast<int64_t>(0));
+  graph.AddNode("reshape1", "Reshape", "", {x, arg("shape1")}, {arg("Y1")});
+
+  // Reshape to {batch, 3, 4}, where the batch dimension is only known at runtime
+  graph.AddNode("gather0", "Gather", "", {arg("shape"), arg("index0")}, {arg("dim0")});
+  graph.AddNode("slice", "Slice", "", {arg("shape"), arg("starts"), arg("ends")}, {arg("tail")});
+  auto& concat2 = graph.AddNode("concat2", "Concat", "", {arg("dim0"), arg("tail")}, {arg("shape2")});
+  concat2.AddAttribute("axis", static_cast<int64_t>(0));
+  graph.AddNode("reshape2", "Reshape", "", {x, arg("shape2")}, {arg("Y2")});
+
+  // slices with a negative step of the shape {2, 3, 4} of W, clamped like the Slice kernel does
+  auto* w = AddFloatNodeArg(graph, "W", {2, 3, 4});
+  auto* v = AddFloatNodeArg(graph, "V", {1});
+  graph.AddNode("w_shape", "Shape", "", {w}, {arg("w_shape")});
+  AddInt64Initializer(graph, "axes", {0});
+  AddInt64Initializer(graph, "minus_one_step", {-1});
+  AddInt64Initializer(graph, "minus_five", {-5});
+  AddInt64Initializer(graph, "two", {2});
+  AddInt64Initializer(graph, "zero", {0});
+  AddInt64Initializer(graph, "int32_max", {std::numeric_limits<int32_t>::max()});
+  const std::vector<std::pair<std::string, std::vector<std::string>>> reverse_slices{
+      {"reversed", {"minus_one", "ends"}},              // {4, 3, 2}
+      {"front", {"minus_five", "ends"}},                // {2}, the start is clamped to 0
+      {"middle", {"two", "zero"}},                      // {4, 3}
+      {"reversed_int32", {"minus_one", "int32_max"}}};  // {4, 3, 2}
+  for (const auto& reverse_slice : reverse_slices) {
+    const auto& name = reverse_slice.first;
+    graph.AddNode(name, "Slice", "",
+                  {arg("w_shape"), arg(reverse_slice.second[0]), arg(reverse_slice.second[1]), arg("axes"),
+                   arg("minus_one_step")},
+                  {arg(name)});
+    graph.AddNode("expand_" + name, "Expand", "", {v, arg(name)}, {arg("expanded_" + name)});
+  }
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Shape"], 1);
+  ASSERT_EQ(op_to_count["Gather"], 1);
+  ASSERT_EQ(op_to_count["Slice"], 0);
+  ASSERT_EQ(op_to_count["Concat"], 1);
+
+  const TensorProto* shape1 = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("shape1", shape1));
+  Initializer shape1_init(*shape1);
+  ASSERT_EQ(shape1_init.size(), 2);
+  EXPECT_EQ(shape1_init.data<int64_t>()[0], -1);
+  EXPECT_EQ(shape1_init.data<int64_t>()[1], 3);
+
+  const TensorProto* tail = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("tail", tail));
+  Initializer tail_init(*tail);
+  ASSERT_EQ(tail_init.size(), 2);
+  EXPECT_EQ(tail_init.data<int64_t>()[0], 3);
+  EXPECT_EQ(tail_init.data<int64_t>()[1], 4);
+
+  const std::map<std::string, std::vector<int64_t>> expected_reverse_slices{
+      {"reversed", {4, 3, 2}}, {"front", {2}}, {"middle", {4, 3}}, {"reversed_int32", {4, 3, 2}}};
+  for (const auto& expected : expected_reverse_slices) {
+    const TensorProto* reverse_slice = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor(expected.first, reverse_slice)) << expected.first;
+    Initializer reverse_slice_init(*reverse_slice);
+    ASSERT_EQ(reverse_slice_init.size(), static_cast<int64_t>(expected.second.size())) << expected.first;
+    for (size_t i = 0; i < expected.second.size(); ++i) {
+      EXPECT_EQ(reverse_slice_init.data<int64_t>()[i], expected.second[i]) << expected.first;
+    }
+  }
+}
+
+// reports that it modified the graph for its first num_modifications runs
+class CountingTransformer : public GraphTransformer {
+ public:
+  CountingTransformer(const std::string& name, int num_modifications)
+      : GraphTransformer(name), num_modifications_(num_modifications) {}
+
+  int NumRuns() const { return num_runs_; }
+
+ private:
+  Status ApplyImpl(Graph& /*graph*/, bool& modified, int /*graph_level*/) const override {
+    modified = num_runs_++ < num_modifications_;
+    return Status::OK();
+  }
+
+  const int num_modifications_;
+  mutable int num_runs_{0};
+};
+
+TEST(GraphTransformationTests, TransformerManagerSkipsUnchangedTransformers) {
+  string model_uri = MODEL_FOLDER + "abs-id-max.onnx";
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(model_uri, model).IsOK());
+  Graph& graph = model->MainGraph();
+
+  auto modifying = onnxruntime::make_unique<CountingTransformer>("Modifying", 2);
+  auto unchanged = onnxruntime::make_unique<CountingTransformer>("Unchanged", 0);
+  auto modifying_last = onnxruntime::make_unique<CountingTransformer>("ModifyingLast", 1);
+  const auto* p_modifying = modifying.get();
+  const auto* p_unchanged = unchanged.get();
+  const auto* p_modifying_last = modifying_last.get();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::move(modifying), TransformerLevel::Level1);
+  graph_transformation_mgr.Register(std::move(unchanged), TransformerLevel::Level1);
+  graph_transformation_mgr.Register(std::move(modifying_last), TransformerLevel::Level1);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  // step 0: all run, Modifying and ModifyingLast modify the graph.
+  // step 1: all run as the graph changed since their last run. only Modifying modifies the graph.
+  // step 2: only Modifying runs, as the graph didn't change since the others ran. nothing changes, so the
+  // remaining steps are skipped.
+  EXPECT_EQ(p_modifying->NumRuns(), 3);
+  EXPECT_EQ(p_unchanged->NumRuns(), 2);
+  EXPECT_EQ(p_modifying_last->NumRuns(), 2);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
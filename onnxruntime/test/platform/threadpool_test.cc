@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/threadpool.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+namespace {
+
+// Run a ParallelFor over total iterations and check that every iteration ran exactly once.
+void ValidateParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit) {
+  std::vector<std::atomic<int>> counts(static_cast<size_t>(total));
+  for (auto& count : counts) {
+    count = 0;
+  }
+
+  concurrency::ThreadPool::TryParallelFor(tp, total, cost_per_unit, [&counts](std::ptrdiff_t first, std::ptrdiff_t last) {
+    ASSERT_LT(first, last);
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      ++counts[static_cast<size_t>(i)];
+    }
+  });
+
+  for (std::ptrdiff_t i = 0; i < total; ++i) {
+    ASSERT_EQ(counts[static_cast<size_t>(i)], 1) << "iteration " << i;
+  }
+}
+
+}  // namespace
+
+TEST(ThreadPoolTest, ParallelForCoversRange) {
+  concurrency::ThreadPool tp("test", 4);
+
+  for (std::ptrdiff_t total : {0, 1, 7, 100, 10000}) {
+    // cheap iterations that run on the calling thread, and expensive ones that are split across the threads
+    for (double cost_per_unit : {0.0, 1.0, 100.0, 100000.0}) {
+      ValidateParallelFor(&tp, total, cost_per_unit);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForWithoutThreadPool) {
+  ValidateParallelFor(nullptr, 1000, 100000.0);
+}
+
+TEST(ThreadPoolTest, ParallelForUsesThreads) {
+  concurrency::ThreadPool tp("test", 4);
+
+  std::atomic<int> num_blocks{0};
+  std::atomic<int> num_pool_blocks{0};
+  tp.ParallelFor(1000, 1000000.0, [&](std::ptrdiff_t, std::ptrdiff_t) {
+    ++num_blocks;
+    if (tp.CurrentThreadId() != -1) {
+      ++num_pool_blocks;
+    }
+  });
+
+  EXPECT_GT(num_blocks, 1);
+
+  // a cheap loop runs on the calling thread in a single block
+  num_blocks = 0;
+  num_pool_blocks = 0;
+  tp.ParallelFor(1000, 1.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    EXPECT_EQ(first, 0);
+    EXPECT_EQ(last, 1000);
+    ++num_blocks;
+    if (tp.CurrentThreadId() != -1) {
+      ++num_pool_blocks;
+    }
+  });
+
+  EXPECT_EQ(num_blocks, 1);
+  EXPECT_EQ(num_pool_blocks, 0);
+}
+
+TEST(ThreadPoolTest, NestedParallelFor) {
+  concurrency::ThreadPool tp("test", 2);
+
+  std::atomic<int64_t> sum{0};
+  tp.ParallelFor(8, 1000000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      tp.ParallelFor(100, 1000000.0, [&](std::ptrdiff_t inner_first, std::ptrdiff_t inner_last) {
+        sum += inner_last - inner_first;
+      });
+    }
+  });
+
+  EXPECT_EQ(sum, 800);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
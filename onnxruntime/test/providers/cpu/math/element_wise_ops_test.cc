@@ -356,6 +356,25 @@ TEST(MathOpTest, Sub_Broadcast_Scalar) {
   test.Run();
 }
 
+TEST(MathOpTest, Sub_Broadcast_Channel) {
+  // the first input is broadcast per channel, so the operands must not be swapped
+  OpTester test("Sub");
+  test.AddInput<float>("A", {2, 1, 1}, {10.0f, -1.0f});
+  test.AddInput<float>("B", {2, 2, 3},
+                       {1.0f, 2.0f, 3.0f,
+                        4.0f, 5.0f, 6.0f,
+
+                        1.0f, 2.0f, 3.0f,
+                        4.0f, 5.0f, 6.0f});
+  test.AddOutput<float>("C", {2, 2, 3},
+                        {9.0f, 8.0f, 7.0f,
+                         6.0f, 5.0f, 4.0f,
+
+                         -2.0f, -3.0f, -4.0f,
+                         -5.0f, -6.0f, -7.0f});
+  test.Run();
+}
+
 TEST(MathOpTest, Mul_int32) {
   OpTester test("Mul");
   test.AddInput<int32_t>("A", {3}, {1, 2, 3});
@@ -430,6 +449,18 @@ TEST(MathOpTest, Div) {
 #endif
 }
 
+TEST(MathOpTest, Div_Broadcast_Row) {
+  OpTester test("Div");
+  test.AddInput<float>("A", {3}, {1.0f, 6.0f, -8.0f});
+  test.AddInput<float>("B", {2, 3},
+                       {2.0f, 3.0f, 4.0f,
+                        -1.0f, 0.5f, 16.0f});
+  test.AddOutput<float>("C", {2, 3},
+                        {0.5f, 2.0f, -2.0f,
+                         -1.0f, 12.0f, -0.5f});
+  test.Run();
+}
+
 TEST(MathOpTest, Abs) {
   OpTester test("Abs");
   std::vector<int64_t> dims{2, 2};
@@ -257,5 +257,36 @@ TEST(GemmOpTest, GemmNoBiasOpset11) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kNGraphExecutionProvider, kTensorrtExecutionProvider});
 }
 
+TEST(GemmOpTest, GemmConstantB) {
+  // B is an initializer, so the CPU kernel packs it when the kernel is created
+  for (int64_t trans_b = 0; trans_b <= 1; trans_b++) {
+    OpTester test("Gemm");
+
+    test.AddAttribute("transA", static_cast<int64_t>(0));
+    test.AddAttribute("transB", trans_b);
+    test.AddAttribute("alpha", 0.5f);
+    test.AddAttribute("beta", 2.0f);
+
+    // B is 4x20, or 20x4 when transposed, with each column n holding n + 1
+    std::vector<float> b_data(80);
+    for (size_t i = 0; i < b_data.size(); i++) {
+      b_data[i] = static_cast<float>(trans_b ? i / 4 + 1 : i % 20 + 1);
+    }
+
+    std::vector<float> y_data(40);
+    for (size_t i = 0; i < y_data.size(); i++) {
+      y_data[i] = (i < 20 ? 5.0f : -5.0f) * static_cast<float>(i % 20 + 1) + 2.0f;
+    }
+
+    test.AddInput<float>("A", {2, 4},
+                         {1.0f, 2.0f, 3.0f, 4.0f,
+                          -1.0f, -2.0f, -3.0f, -4.0f});
+    test.AddInput<float>("B", trans_b ? std::vector<int64_t>{20, 4} : std::vector<int64_t>{4, 20}, b_data, true);
+    test.AddInput<float>("C", {1}, {1.0f});
+    test.AddOutput<float>("Y", {2, 20}, y_data);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -35,6 +35,13 @@ std::vector<MatMulTestData<T>> GenerateTestCases()
     {3, 2, 3, 1},
     {1, 3, 5, 33, 43, 53, 5, 23, 41, 85, 111, 137, 9, 43, 77, 137, 179, 221}});
 
+  test_cases.push_back(
+    {"test 3D batch",
+    {2, 2, 3},
+    {2, 3, 2},
+    {2, 2, 2},
+    {10, 13, 28, 40, 172, 193, 244, 274}});
+
   test_cases.push_back(
     {"test left 1D",
     {2},
@@ -81,7 +88,7 @@ std::vector<MatMulTestData<T>> GenerateTestCases()
 }
 
 template <typename T>
-void RunMatMulTest(int32_t opset_version = 7)
+void RunMatMulTest(int32_t opset_version = 7, bool is_b_constant = false)
 {
   std::vector<T> common_input_vals{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
   for (auto t : GenerateTestCases<T>()) {
@@ -93,7 +100,7 @@ void RunMatMulTest(int32_t opset_version = 7)
 
     int64_t size1 = TensorShape::ReinterpretBaseType(t.input1_dims).SizeHelper(0, t.input1_dims.size());
     std::vector<T> input1_vals(common_input_vals.cbegin(), common_input_vals.cbegin() + size1);
-    test.AddInput<T>("B", t.input1_dims, input1_vals);
+    test.AddInput<T>("B", t.input1_dims, input1_vals, is_b_constant);
 
     test.AddOutput<T>("Y", t.expected_dims, t.expected_vals);
 
@@ -105,6 +112,11 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>(7);
 }
 
+TEST(MathOpTest, MatMulFloatTypeConstantB) {
+  // a 2D constant B is packed when the kernel is created
+  RunMatMulTest<float>(9, true);
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <fstream>
 #include <atomic>
+#include <future>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
 #include "test_fixture.h"
@@ -377,6 +378,57 @@ TEST_F(CApiTest, override_initializer) {
   ASSERT_EQ(*output_data, f11_input_data[0]);
 }
 
+TEST_F(CApiTest, run_async) {
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  Ort::SessionOptions session_options;
+  Ort::Session session(env_, MODEL_URI, session_options);
+
+  std::vector<int64_t> dims = {3, 2};
+  constexpr size_t num_runs = 8;
+  std::vector<std::vector<float>> x_values(num_runs);
+  std::vector<Ort::Value> ort_inputs;
+  std::vector<std::promise<std::vector<Ort::Value>>> promises(num_runs);
+  const char* input_name = "X";
+  const char* output_name = "Y";
+
+  for (size_t i = 0; i < num_runs; i++) {
+    for (int j = 0; j < 6; j++)
+      x_values[i].push_back(static_cast<float>(i + j));
+    ort_inputs.push_back(Ort::Value::CreateTensor<float>(info, x_values[i].data(), x_values[i].size(), dims.data(), dims.size()));
+  }
+
+  for (size_t i = 0; i < num_runs; i++) {
+    auto& promise = promises[i];
+    session.RunAsync(Ort::RunOptions{nullptr}, &input_name, &ort_inputs[i], 1, &output_name, 1,
+                     [&promise](std::vector<Ort::Value>&& outputs, const Ort::Exception* error) {
+                       if (error)
+                         promise.set_exception(std::make_exception_ptr(*error));
+                       else
+                         promise.set_value(std::move(outputs));
+                     });
+  }
+
+  // Y = X * W where W is an initializer with the values {1, 2, 3, 4, 5, 6}
+  for (size_t i = 0; i < num_runs; i++) {
+    std::vector<Ort::Value> outputs = promises[i].get_future().get();
+    ASSERT_EQ(outputs.size(), 1U);
+    auto type_info = outputs[0].GetTensorTypeAndShapeInfo();
+    ASSERT_EQ(type_info.GetShape(), dims);
+    float* y = outputs[0].GetTensorMutableData<float>();
+    for (size_t j = 0; j < 6; j++)
+      ASSERT_EQ(y[j], x_values[i][j] * (j + 1));
+  }
+
+  // errors in the run are passed to the callback
+  const char* invalid_input_name = "invalid";
+  std::promise<std::string> error_promise;
+  session.RunAsync(Ort::RunOptions{nullptr}, &invalid_input_name, &ort_inputs[0], 1, &output_name, 1,
+                   [&error_promise](std::vector<Ort::Value>&& outputs, const Ort::Exception* error) {
+                     error_promise.set_value(error != nullptr && outputs.empty() ? error->what() : "");
+                   });
+  ASSERT_NE(error_promise.get_future().get(), "");
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   int ret = RUN_ALL_TESTS();